@@ -0,0 +1,119 @@
+#!/usr/bin/env bash
+# =============================================================================
+#  Linux Hotspot Enabler — multi-node coordination test (network namespaces)
+#
+#  Runs N simulated nodes ("hotspot-enabler coord-sim"), each in its own
+#  namespace with a veth into a shared bridge, as if N laptops sat on one
+#  wired segment. All start on channel 6; node 1 is at 90 % of its client
+#  limit, the others at 20 %. One more node (hsc-x) announces with a
+#  different coord_key. After the run it checks that:
+#
+#    - every node heard every other node, and not hsc-x,
+#    - every node dropped hsc-x's announcements,
+#    - the nodes ended on non-overlapping 2.4 GHz channels (N <= 3),
+#    - node 1 capped new clients (its peers have room).
+#
+#    [hsc-1] ──┐
+#    [hsc-2] ──┼── lanbr (hsc-lan) ── one multicast segment
+#    [hsc-3] ──┤
+#    [hsc-x] ──┘  wrong key
+#
+#  Needs ip (iproute2). Each node's log is printed on failure.
+#
+#  Usage: sudo bench/coord-netns.sh [nodes] [seconds] [binary]
+# =============================================================================
+set -euo pipefail
+
+NODES="${1:-3}"
+SECONDS_RUN="${2:-15}"
+BIN="${3:-./hotspot-enabler}"
+LAN=hsc-lan
+KEY=coord-netns-shared-key
+BAD_KEY=coord-netns-other-key
+TMP=
+
+info()  { echo "[INFO]  $*"; }
+pass()  { echo "[PASS]  $*"; }
+die()   { echo "[FAIL]  $*" >&2; exit 1; }
+
+[[ $EUID -eq 0 ]] || die "must run as root"
+[[ "$NODES" =~ ^[0-9]+$ && $NODES -ge 2 && $NODES -le 8 ]] || die "nodes must be 2-8"
+[[ "$SECONDS_RUN" =~ ^[0-9]+$ && $SECONDS_RUN -ge 8 ]] || die "seconds must be >= 8"
+[[ -x $BIN ]] || die "no binary at $BIN (run make first)"
+BIN=$(readlink -f "$BIN")
+
+# ── Segment ───────────────────────────────────────────────────────────────────
+
+teardown() {
+    for i in $(seq 1 "$NODES") x; do ip netns del "hsc-$i" 2>/dev/null || true; done
+    ip netns del "$LAN" 2>/dev/null || true
+    [[ -z $TMP ]] || rm -rf "$TMP"
+}
+trap teardown EXIT
+teardown
+TMP=$(mktemp -d /tmp/coord-netns.XXXXXX)
+
+ip netns add "$LAN"
+ip -n "$LAN" link add lanbr type bridge
+ip -n "$LAN" link set lanbr up
+for i in $(seq 1 "$NODES") x; do
+    ip netns add "hsc-$i"
+    ip link add "hsc$i" type veth peer name "p$i"
+    ip link set "hsc$i" netns "hsc-$i"
+    ip link set "p$i" netns "$LAN"
+    ip -n "$LAN" link set "p$i" master lanbr up
+    ip -n "hsc-$i" link set lo up
+    ip -n "hsc-$i" addr add "10.198.0.${i/x/99}/24" dev "hsc$i"
+    ip -n "hsc-$i" link set "hsc$i" up
+done
+
+# ── Run ───────────────────────────────────────────────────────────────────────
+
+info "$NODES nodes on channel 6 for ${SECONDS_RUN}s"
+for i in $(seq 1 "$NODES"); do
+    clients=2
+    [[ $i -eq 1 ]] && clients=9
+    ip netns exec "hsc-$i" "$BIN" coord-sim "hsc$i" 6 "$clients" 10 \
+        "$SECONDS_RUN" "$KEY" > "$TMP/node$i.log" 2>&1 &
+done
+ip netns exec hsc-x "$BIN" coord-sim hscx 6 0 10 "$SECONDS_RUN" "$BAD_KEY" \
+    > "$TMP/nodex.log" 2>&1 &
+wait
+
+# ── Verdict ───────────────────────────────────────────────────────────────────
+
+failed=0
+show_logs() {
+    for i in $(seq 1 "$NODES") x; do echo "--- node $i"; cat "$TMP/node$i.log"; done
+}
+
+declare -a CH
+for i in $(seq 1 "$NODES"); do
+    line=$(grep '^final ' "$TMP/node$i.log" || true)
+    [[ -n $line ]] || { show_logs; die "node $i did not finish"; }
+    CH[$i]=$(sed -n 's/.* channel=\([0-9]*\).*/\1/p' <<< "$line")
+    peers=$(sed -n 's/.* peers=\([0-9]*\).*/\1/p' <<< "$line")
+    cap=$(sed -n 's/.* cap=\(-\{0,1\}[0-9]*\).*/\1/p' <<< "$line")
+    rejected=$(sed -n 's/.* rejected=\([0-9]*\).*/\1/p' <<< "$line")
+    printf "  node %d: channel %-3s peers %s cap %-2s rejected %s\n" "$i" "${CH[$i]}" \
+        "$peers" "$cap" "$rejected"
+    [[ $peers -eq $((NODES - 1)) ]] || { echo "  node $i heard $peers peers"; failed=1; }
+    [[ $rejected -gt 0 ]] || { echo "  node $i did not drop hsc-x"; failed=1; }
+    if [[ $i -eq 1 && $cap -lt 0 ]]; then echo "  node 1 did not cap"; failed=1; fi
+    if [[ $i -ne 1 && $cap -ge 0 ]]; then echo "  node $i capped"; failed=1; fi
+done
+
+if [[ $NODES -le 3 ]]; then
+    for i in $(seq 1 "$NODES"); do
+        for j in $(seq $((i + 1)) "$NODES"); do
+            d=$(( CH[i] - CH[j] ))
+            if [[ ${d#-} -lt 5 ]]; then
+                echo "  nodes $i and $j overlap (${CH[i]}, ${CH[j]})"
+                failed=1
+            fi
+        done
+    done
+fi
+
+[[ $failed -eq 0 ]] || { show_logs; die "coordination did not converge"; }
+pass "all nodes heard each other and dropped the wrong key, channels spread, overloaded node capped"
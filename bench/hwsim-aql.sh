@@ -0,0 +1,152 @@
+#!/usr/bin/env bash
+# =============================================================================
+#  Linux Hotspot Enabler — RTT under load vs. AQL limits (mac80211_hwsim)
+#
+#  Two simulated radios: an AP (hostapd) in the root namespace and a
+#  station (wpa_supplicant) in its own namespace. A bulk TCP stream fills
+#  the AP → station queues while ping measures the round trip; this is
+#  repeated for each AQL setting, the kernel default first.
+#
+#    [root ns: hostapd on hwsim radio 0] ))) [hsq-sta: wpa_supplicant, radio 1]
+#
+#  Needs mac80211_hwsim, debugfs, hostapd, wpa_supplicant, iw, ping and
+#  python3. Unloads and reloads mac80211_hwsim.
+#
+#  Usage: sudo bench/hwsim-aql.sh [seconds] [low,high ...]
+#         sudo bench/hwsim-aql.sh 20 5000,12000 2500,6000 1000,3000
+# =============================================================================
+set -euo pipefail
+
+DURATION="${1:-20}"
+shift || true
+if [[ $# -gt 0 ]]; then LIMITS=("$@"); else LIMITS=(2500,6000 1000,3000); fi
+
+NS=hsq-sta
+AP_IP=10.97.0.1
+STA_IP=10.97.0.2
+PORT=5202
+TMP=$(mktemp -d /tmp/hwsim-aql.XXXXXX)
+
+info()  { echo "[INFO]  $*"; }
+die()   { echo "[FAIL]  $*" >&2; exit 1; }
+
+[[ $EUID -eq 0 ]] || die "must run as root"
+[[ "$DURATION" =~ ^[0-9]+$ ]] || die "duration must be whole seconds"
+for tool in hostapd wpa_supplicant iw ping python3 modprobe; do
+    command -v "$tool" >/dev/null 2>&1 || die "need $tool"
+done
+
+# ── Radios ────────────────────────────────────────────────────────────────────
+
+teardown() {
+    pkill -f "$TMP/hostapd.conf" 2>/dev/null || true
+    ip netns pids "$NS" 2>/dev/null | xargs -r kill 2>/dev/null || true
+    ip netns del "$NS" 2>/dev/null || true
+    modprobe -r mac80211_hwsim 2>/dev/null || true
+    rm -rf "$TMP"
+}
+trap teardown EXIT
+
+modprobe -r mac80211_hwsim 2>/dev/null || true
+modprobe mac80211_hwsim radios=2 || die "mac80211_hwsim not available"
+sleep 1
+
+PHYS=()
+for p in /sys/class/ieee80211/*; do
+    [[ $(readlink -f "$p/device") == *hwsim* ]] && PHYS+=("$(basename "$p")")
+done
+[[ ${#PHYS[@]} -ge 2 ]] || die "expected two hwsim radios"
+AP_PHY=${PHYS[0]}
+STA_PHY=${PHYS[1]}
+AP_IF=$(ls "/sys/class/ieee80211/$AP_PHY/device/net" | head -n1)
+STA_IF=$(ls "/sys/class/ieee80211/$STA_PHY/device/net" | head -n1)
+AQL=/sys/kernel/debug/ieee80211/$AP_PHY/aql_txq_limit
+[[ -w $AQL ]] || die "no $AQL (debugfs mounted? kernel >= 5.5?)"
+
+# ── Association ───────────────────────────────────────────────────────────────
+
+cat > "$TMP/hostapd.conf" <<EOF
+interface=$AP_IF
+driver=nl80211
+ssid=hsq-bench
+hw_mode=g
+channel=6
+ieee80211n=1
+wmm_enabled=1
+EOF
+cat > "$TMP/wpa.conf" <<EOF
+network={
+    ssid="hsq-bench"
+    key_mgmt=NONE
+}
+EOF
+
+hostapd -B "$TMP/hostapd.conf" >/dev/null
+ip addr add "$AP_IP/24" dev "$AP_IF"
+
+ip netns add "$NS"
+iw phy "$STA_PHY" set netns name "$NS"
+ip netns exec "$NS" ip link set lo up
+ip netns exec "$NS" ip link set "$STA_IF" up
+ip netns exec "$NS" wpa_supplicant -B -i "$STA_IF" -c "$TMP/wpa.conf" >/dev/null
+ip netns exec "$NS" ip addr add "$STA_IP/24" dev "$STA_IF"
+
+for _ in $(seq 20); do
+    ping -c1 -W1 "$STA_IP" >/dev/null 2>&1 && break
+    sleep 0.5
+done
+ping -c1 -W1 "$STA_IP" >/dev/null 2>&1 || die "station did not associate"
+
+# ── Measurement ───────────────────────────────────────────────────────────────
+
+SINK='import socket
+s = socket.socket(); s.setsockopt(socket.SOL_SOCKET, socket.SO_REUSEADDR, 1)
+s.bind(("0.0.0.0", %d)); s.listen(1); c, _ = s.accept()
+while c.recv(1 << 16): pass'
+PUMP='import socket, time
+s = socket.create_connection(("%s", %d)); b = bytes(1 << 16); end = time.time() + %d
+while time.time() < end: s.sendall(b)'
+
+set_limits() {
+    local ac low="$1" high="$2"
+    for ac in 0 1 2 3; do echo "$ac $low $high" > "$AQL"; done
+}
+
+measure() {
+    local label="$1" sink_pid
+    # shellcheck disable=SC2059
+    ip netns exec "$NS" python3 -c "$(printf "$SINK" "$PORT")" &
+    sink_pid=$!
+    sleep 0.5
+    # shellcheck disable=SC2059
+    python3 -c "$(printf "$PUMP" "$STA_IP" "$PORT" "$((DURATION + 1))")" &
+    sleep 1
+    ping -n -i 0.05 -c "$((DURATION * 20 - 20))" "$STA_IP" 2>/dev/null |
+    awk -v l="$label" '
+        /time=/ { split($0, a, "time="); n++; v[n] = a[2] + 0; sum += v[n] }
+        END {
+            if (n == 0) { printf "%-14s no replies\n", l; exit }
+            for (i = 2; i <= n; i++) {
+                x = v[i]; j = i - 1
+                while (j > 0 && v[j] > x) { v[j + 1] = v[j]; j-- }
+                v[j + 1] = x
+            }
+            printf "%-14s %8d %8.1f %8.1f %8.1f\n", l, n, sum / n,
+                   v[int(n * 0.5) > 0 ? int(n * 0.5) : 1],
+                   v[int(n * 0.99) > 0 ? int(n * 0.99) : 1]
+        }'
+    wait
+    kill "$sink_pid" 2>/dev/null || true
+}
+
+read -r _ DEF_LOW DEF_HIGH < <(awk '$1 == "BE"' "$AQL")
+info "AP $AP_IF ($AP_PHY), station $STA_IF ($STA_PHY) in $NS; ${DURATION}s per setting"
+printf "%-14s %8s %8s %8s %8s\n" aql_limit samples avg_ms p50_ms p99_ms
+
+measure "$DEF_LOW,$DEF_HIGH"
+for lim in "${LIMITS[@]}"; do
+    [[ $lim =~ ^[0-9]+,[0-9]+$ ]] || die "limit must be low,high: $lim"
+    set_limits "${lim%,*}" "${lim#*,}"
+    measure "$lim"
+done
+set_limits "$DEF_LOW" "$DEF_HIGH"
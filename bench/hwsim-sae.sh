@@ -0,0 +1,187 @@
+#!/usr/bin/env bash
+# =============================================================================
+#  Linux Hotspot Enabler — join burst cost per security mode (mac80211_hwsim)
+#
+#  Two simulated radios: an AP (hostapd) in the root namespace and one
+#  radio in its own namespace carrying N station interfaces, all started
+#  by one wpa_supplicant at once. For each mode the time until 50 %, 90 %
+#  and all stations are authorized is measured, with hostapd's CPU time
+#  per join (utime + stime from /proc) over the burst:
+#
+#    wpa2          WPA2-PSK (4-way handshake only, the baseline)
+#    sae-hnp       SAE, hunting-and-pecking (sae_pwe=0)
+#    sae-h2e       SAE, hash-to-element (sae_pwe=1), as "security = sae"
+#
+#  The SAE modes run once per anti-clogging threshold given.
+#
+#    [root ns: hostapd on hwsim radio 0] ))) [hss-sta: N vifs on radio 1]
+#
+#  Needs mac80211_hwsim, hostapd and wpa_supplicant built with SAE, iw.
+#  Unloads and reloads mac80211_hwsim.
+#
+#  Usage: sudo bench/hwsim-sae.sh [stations] [threshold ...]
+#         sudo bench/hwsim-sae.sh 200 5 0
+# =============================================================================
+set -euo pipefail
+
+STATIONS="${1:-100}"
+shift || true
+if [[ $# -gt 0 ]]; then THRESHOLDS=("$@"); else THRESHOLDS=(5); fi
+
+NS=hss-sta
+SSID=hss-bench
+PASS=hotspot-bench-pw
+TIMEOUT=120
+TMP=$(mktemp -d /tmp/hwsim-sae.XXXXXX)
+
+info()  { echo "[INFO]  $*"; }
+die()   { echo "[FAIL]  $*" >&2; exit 1; }
+
+[[ $EUID -eq 0 ]] || die "must run as root"
+[[ "$STATIONS" =~ ^[0-9]+$ && $STATIONS -ge 1 && $STATIONS -le 1000 ]] ||
+    die "stations must be 1-1000"
+for t in "${THRESHOLDS[@]}"; do
+    [[ $t =~ ^[0-9]+$ ]] || die "threshold must be a whole number: $t"
+done
+for tool in hostapd wpa_supplicant iw modprobe; do
+    command -v "$tool" >/dev/null 2>&1 || die "need $tool"
+done
+
+# ── Radios ────────────────────────────────────────────────────────────────────
+
+stop_daemons() {
+    pkill -f "$TMP/hostapd.conf" 2>/dev/null || true
+    ip netns pids "$NS" 2>/dev/null | xargs -r kill 2>/dev/null || true
+    sleep 0.5
+}
+
+teardown() {
+    stop_daemons
+    ip netns del "$NS" 2>/dev/null || true
+    modprobe -r mac80211_hwsim 2>/dev/null || true
+    rm -rf "$TMP"
+}
+trap teardown EXIT
+
+modprobe -r mac80211_hwsim 2>/dev/null || true
+modprobe mac80211_hwsim radios=2 || die "mac80211_hwsim not available"
+sleep 1
+
+PHYS=()
+for p in /sys/class/ieee80211/*; do
+    [[ $(readlink -f "$p/device") == *hwsim* ]] && PHYS+=("$(basename "$p")")
+done
+[[ ${#PHYS[@]} -ge 2 ]] || die "expected two hwsim radios"
+AP_PHY=${PHYS[0]}
+STA_PHY=${PHYS[1]}
+AP_IF=$(ls "/sys/class/ieee80211/$AP_PHY/device/net" | head -n1)
+STA_IF=$(ls "/sys/class/ieee80211/$STA_PHY/device/net" | head -n1)
+
+ip netns add "$NS"
+iw phy "$STA_PHY" set netns name "$NS"
+ip netns exec "$NS" iw dev "$STA_IF" del
+for i in $(seq 0 $((STATIONS - 1))); do
+    ip netns exec "$NS" iw phy "$STA_PHY" interface add "hss$i" type managed
+    ip netns exec "$NS" ip link set "hss$i" address \
+        "$(printf '02:53:%02x:%02x:00:01' $((i >> 8)) $((i & 255)))"
+done
+
+# ── Measurement ───────────────────────────────────────────────────────────────
+
+# write_conf <mode> <threshold>: hostapd.conf and the station network block
+write_conf() {
+    local mode="$1" thr="$2" ap_sec sta_sec
+    case $mode in
+        wpa2)
+            ap_sec="wpa_key_mgmt=WPA-PSK"
+            sta_sec=$'key_mgmt=WPA-PSK'
+            ;;
+        sae-hnp|sae-h2e)
+            local pwe=0
+            [[ $mode == sae-h2e ]] && pwe=1
+            ap_sec=$(printf 'wpa_key_mgmt=SAE\nieee80211w=2\nsae_pwe=%d\nsae_groups=19\nsae_anti_clogging_threshold=%d' "$pwe" "$thr")
+            sta_sec=$(printf 'key_mgmt=SAE\nieee80211w=2\nsae_pwe=%d' "$pwe")
+            ;;
+    esac
+    cat > "$TMP/hostapd.conf" <<EOF
+interface=$AP_IF
+driver=nl80211
+ssid=$SSID
+hw_mode=g
+channel=6
+ieee80211n=1
+wmm_enabled=1
+max_num_sta=2007
+wpa=2
+wpa_passphrase=$PASS
+rsn_pairwise=CCMP
+$ap_sec
+EOF
+    cat > "$TMP/wpa.conf" <<EOF
+sae_groups=19
+network={
+    ssid="$SSID"
+    psk="$PASS"
+    scan_ssid=1
+    scan_freq=2437
+    $sta_sec
+}
+EOF
+}
+
+cpu_ticks() {
+    awk '{ print $14 + $15 }' "/proc/$1/stat"
+}
+
+authorized() {
+    iw dev "$AP_IF" station dump 2>/dev/null | grep -c 'authorized:.*yes' || true
+}
+
+measure() {
+    local label="$1" mode="$2" thr="$3" hpid args=() t0 now n
+    local t50=- t90=- tall=-
+
+    write_conf "$mode" "$thr"
+    hostapd -B -P "$TMP/hostapd.pid" "$TMP/hostapd.conf" >/dev/null ||
+        die "hostapd rejected the $label config (built without SAE?)"
+    sleep 1
+    hpid=$(cat "$TMP/hostapd.pid")
+
+    for i in $(seq 0 $((STATIONS - 1))); do
+        args+=(-i "hss$i" -c "$TMP/wpa.conf")
+        [[ $i -lt $((STATIONS - 1)) ]] && args+=(-N)
+    done
+
+    local c0 hz
+    hz=$(getconf CLK_TCK)
+    c0=$(cpu_ticks "$hpid")
+    t0=$(date +%s%N)
+    ip netns exec "$NS" wpa_supplicant -B "${args[@]}" >/dev/null
+
+    while :; do
+        n=$(authorized)
+        now=$(( ($(date +%s%N) - t0) / 1000000 ))
+        [[ $t50 == - && $n -ge $(( (STATIONS + 1) / 2 )) ]] && t50=$now
+        [[ $t90 == - && $n -ge $(( (STATIONS * 9 + 9) / 10 )) ]] && t90=$now
+        if [[ $n -ge $STATIONS ]]; then tall=$now; break; fi
+        [[ $now -ge $((TIMEOUT * 1000)) ]] && break
+        sleep 0.05
+    done
+
+    local cpu_ms=$(( ($(cpu_ticks "$hpid") - c0) * 1000 / hz ))
+    printf "%-16s %6d %8s %8s %8s %8d %10.2f\n" "$label" "$n" "$t50" "$t90" \
+           "$tall" "$cpu_ms" "$(awk -v c="$cpu_ms" -v n="$n" \
+                                 'BEGIN { print n ? c / n : 0 }')"
+    stop_daemons
+}
+
+info "AP $AP_IF ($AP_PHY), $STATIONS stations on $STA_PHY in $NS"
+info "times in ms from supplicant start; hostapd CPU over the burst"
+printf "%-16s %6s %8s %8s %8s %8s %10s\n" mode joined t50_ms t90_ms all_ms \
+       cpu_ms cpu_ms/join
+
+measure wpa2 wpa2 0
+for thr in "${THRESHOLDS[@]}"; do
+    measure "sae-hnp/ac=$thr" sae-hnp "$thr"
+    measure "sae-h2e/ac=$thr" sae-h2e "$thr"
+done
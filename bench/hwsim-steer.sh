@@ -0,0 +1,138 @@
+#!/usr/bin/env bash
+# =============================================================================
+#  Linux Hotspot Enabler — band steering check (mac80211_hwsim)
+#
+#  Three simulated radios: a 2.4 GHz AP (channel 6) and a 5 GHz AP
+#  (channel 36) with the same SSID and password in the root namespace,
+#  and a dual-band station with BSS Transition support in its own
+#  namespace. The station joins on 2.4 GHz first (the 5 GHz AP is not up
+#  yet), then "hotspot-enabler steer-sim" runs the steering module
+#  against the 2.4 GHz hostapd. The check passes when the station ends on
+#  the 5 GHz BSSID and the module counted the move.
+#
+#    [root ns: hostapd 2.4 GHz radio 0, hostapd 5 GHz radio 1]
+#                         ))) [hst-sta: wpa_supplicant, radio 2]
+#
+#  Needs mac80211_hwsim, hostapd, wpa_supplicant (with WNM), wpa_cli and
+#  iw. Sets the regulatory domain to US for channel 36. Unloads and
+#  reloads mac80211_hwsim.
+#
+#  Usage: sudo bench/hwsim-steer.sh [seconds] [binary]
+# =============================================================================
+set -euo pipefail
+
+DURATION="${1:-45}"
+BIN="${2:-./hotspot-enabler}"
+
+NS=hst-sta
+SSID=hst-bench
+PASS=hotspot-bench-pw
+CTRL=/var/run/hostapd            # HOSTAPD_CTRL_DIR, where steer.c looks
+TMP=$(mktemp -d /tmp/hwsim-steer.XXXXXX)
+
+info()  { echo "[INFO]  $*"; }
+pass()  { echo "[PASS]  $*"; }
+die()   { echo "[FAIL]  $*" >&2; exit 1; }
+
+[[ $EUID -eq 0 ]] || die "must run as root"
+[[ "$DURATION" =~ ^[0-9]+$ && $DURATION -ge 20 ]] || die "seconds must be >= 20"
+[[ -x $BIN ]] || die "no binary at $BIN (run make first)"
+for tool in hostapd wpa_supplicant wpa_cli iw modprobe; do
+    command -v "$tool" >/dev/null 2>&1 || die "need $tool"
+done
+
+# ── Radios ────────────────────────────────────────────────────────────────────
+
+teardown() {
+    pkill -f "$TMP/hostapd" 2>/dev/null || true
+    ip netns pids "$NS" 2>/dev/null | xargs -r kill 2>/dev/null || true
+    ip netns del "$NS" 2>/dev/null || true
+    modprobe -r mac80211_hwsim 2>/dev/null || true
+    rm -rf "$TMP"
+}
+trap teardown EXIT
+
+modprobe -r mac80211_hwsim 2>/dev/null || true
+modprobe mac80211_hwsim radios=3 || die "mac80211_hwsim not available"
+iw reg set US
+sleep 1
+
+PHYS=()
+for p in /sys/class/ieee80211/*; do
+    [[ $(readlink -f "$p/device") == *hwsim* ]] && PHYS+=("$(basename "$p")")
+done
+[[ ${#PHYS[@]} -ge 3 ]] || die "expected three hwsim radios"
+iface_of() { ls "/sys/class/ieee80211/$1/device/net" | head -n1; }
+AP2_IF=$(iface_of "${PHYS[0]}")
+AP5_IF=$(iface_of "${PHYS[1]}")
+STA_PHY=${PHYS[2]}
+STA_IF=$(iface_of "$STA_PHY")
+AP5_BSSID=$(cat "/sys/class/net/$AP5_IF/address")
+
+# write_ap <iface> <hw_mode> <channel>
+write_ap() {
+    cat > "$TMP/hostapd-$1.conf" <<EOF
+interface=$1
+driver=nl80211
+ctrl_interface=$CTRL
+ssid=$SSID
+country_code=US
+hw_mode=$2
+channel=$3
+ieee80211n=1
+wmm_enabled=1
+bss_transition=1
+wpa=2
+wpa_passphrase=$PASS
+wpa_key_mgmt=WPA-PSK
+rsn_pairwise=CCMP
+EOF
+}
+write_ap "$AP2_IF" g 6
+write_ap "$AP5_IF" a 36
+cat > "$TMP/wpa.conf" <<EOF
+ctrl_interface=$TMP/wpa
+network={
+    ssid="$SSID"
+    psk="$PASS"
+    key_mgmt=WPA-PSK
+}
+EOF
+
+# ── Join on 2.4 GHz ───────────────────────────────────────────────────────────
+
+hostapd -B "$TMP/hostapd-$AP2_IF.conf" >/dev/null
+
+ip netns add "$NS"
+iw phy "$STA_PHY" set netns name "$NS"
+ip netns exec "$NS" ip link set "$STA_IF" up
+ip netns exec "$NS" wpa_supplicant -B -i "$STA_IF" -c "$TMP/wpa.conf" >/dev/null
+
+wpa() { ip netns exec "$NS" wpa_cli -p "$TMP/wpa" -i "$STA_IF" "$@"; }
+field() { wpa status | sed -n "s/^$1=//p"; }
+
+for _ in $(seq 40); do
+    [[ $(field wpa_state) == COMPLETED ]] && break
+    sleep 0.25
+done
+[[ $(field wpa_state) == COMPLETED ]] || die "station did not associate"
+info "station $STA_IF joined $AP2_IF at $(field freq) MHz"
+
+hostapd -B "$TMP/hostapd-$AP5_IF.conf" >/dev/null ||
+    die "5 GHz AP did not start (channel 36 not allowed?)"
+sleep 2
+
+# ── Steer ─────────────────────────────────────────────────────────────────────
+
+info "steering to $AP5_BSSID (channel 36) for up to ${DURATION}s"
+"$BIN" steer-sim "$AP2_IF" "$AP5_BSSID" 36 "$DURATION" | tee "$TMP/steer.log"
+sleep 2
+
+freq=$(field freq)
+bssid=$(field bssid)
+moved=$(sed -n 's/^final .* moved=\([0-9]*\).*/\1/p' "$TMP/steer.log")
+info "station now at $freq MHz on $bssid"
+
+[[ $bssid == "$AP5_BSSID" ]] || die "station did not move to the 5 GHz AP"
+[[ ${moved:-0} -ge 1 ]] || die "the move was not counted"
+pass "station steered to 5 GHz and the move was counted"
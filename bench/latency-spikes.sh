@@ -0,0 +1,72 @@
+#!/usr/bin/env bash
+# =============================================================================
+#  Linux Hotspot Enabler — latency spike probe
+#
+#  Pings a hotspot client (or any host) every 20 ms and counts round trips
+#  above a threshold. On a radio shared by AP and STA, each background
+#  scan of the uplink shows up as a burst of such spikes, so running this
+#  with sta_tune = off and then on shows what the tuning buys:
+#
+#    sudo bench/latency-spikes.sh 60 192.168.12.57      # label: before
+#    sudo bench/latency-spikes.sh 60 192.168.12.57      # label: after
+#
+#  Without a target the first client in the dnsmasq lease file is used.
+#
+#  Usage: sudo bench/latency-spikes.sh [seconds] [target] [threshold_ms]
+# =============================================================================
+set -euo pipefail
+
+DURATION="${1:-60}"
+TARGET="${2:-}"
+THRESHOLD="${3:-30}"
+INTERVAL=0.02
+LEASES=/tmp/hotspot_enabler_dnsmasq.leases
+
+info()  { echo "[INFO]  $*"; }
+die()   { echo "[FAIL]  $*" >&2; exit 1; }
+
+[[ $EUID -eq 0 ]] || die "must run as root (ping intervals below 200 ms)"
+[[ "$DURATION" =~ ^[0-9]+$ ]] || die "duration must be whole seconds"
+[[ "$THRESHOLD" =~ ^[0-9]+$ ]] || die "threshold must be whole milliseconds"
+command -v ping >/dev/null 2>&1 || die "need ping (iputils)"
+
+if [[ -z $TARGET ]]; then
+    [[ -r $LEASES ]] || die "no target given and no lease file at $LEASES"
+    TARGET=$(awk 'NR == 1 { print $3 }' "$LEASES")
+    [[ -n $TARGET ]] || die "no target given and no clients in $LEASES"
+fi
+
+COUNT=$(awk -v d="$DURATION" -v i="$INTERVAL" 'BEGIN { printf "%d", d / i }')
+info "pinging $TARGET every ${INTERVAL}s for ${DURATION}s, spike > ${THRESHOLD} ms"
+
+# A spike run is consecutive samples over the threshold; lost replies
+# count as over. One off-channel scan is one run, however many samples.
+ping -n -O -i "$INTERVAL" -c "$COUNT" -W 1 "$TARGET" 2>/dev/null |
+awk -v thr="$THRESHOLD" -v secs="$DURATION" -v sent="$COUNT" '
+    /no answer yet/ {
+        over++; if (!in_run) { runs++; in_run = 1 }
+        next
+    }
+    /time=/ {
+        split($0, a, "time="); split(a[2], b, " "); rtt = b[1] + 0
+        n++; v[n] = rtt
+        if (rtt > thr) { over++; if (!in_run) { runs++; in_run = 1 } }
+        else in_run = 0
+        if (rtt > max) max = rtt
+    }
+    END {
+        lost = sent - n; if (lost < 0) lost = 0
+        if (n == 0) { print "no replies"; exit 1 }
+        # insertion sort is fine for a few thousand samples
+        for (i = 2; i <= n; i++) {
+            x = v[i]; j = i - 1
+            while (j > 0 && v[j] > x) { v[j + 1] = v[j]; j-- }
+            v[j + 1] = x
+        }
+        p50 = v[int(n * 0.50) > 0 ? int(n * 0.50) : 1]
+        p99 = v[int(n * 0.99) > 0 ? int(n * 0.99) : 1]
+        printf "%8s %8s %8s %8s %8s %8s %10s\n",
+               "samples", "lost", "p50_ms", "p99_ms", "max_ms", "spikes", "spikes/min"
+        printf "%8d %8d %8.1f %8.1f %8.1f %8d %10.1f\n",
+               n, lost, p50, p99, max, runs, runs * 60 / secs
+    }'
@@ -0,0 +1,306 @@
+#!/usr/bin/env bash
+# =============================================================================
+#  Linux Hotspot Enabler — NAT backend benchmark (network namespaces)
+#
+#  Measures forwarding throughput, packet rate, CPU per packet and ruleset
+#  setup/teardown latency for each way of installing the hotspot's NAT:
+#
+#    none            plain routing, no netfilter rules (baseline)
+#    legacy          iptables-legacy-restore into HOTSPOT_* chains
+#    iptables-nft    iptables-nft-restore, same rules on the nf_tables core
+#    nft             native "table inet hotspot"
+#    nft-flowtable   the same plus a flowtable: established flows skip
+#                    the forward chain entirely
+#
+#  Each backend runs with 1, 100 and 1000 per-client accounting entries
+#  (one counting rule per client address, the measured client last), the
+#  shape a per-client quota or meter takes at a busy site.
+#
+#    [hsn-cli] ──veth── [hsn-rtr: ap0 | up0] ──veth── [hsn-srv: sink]
+#
+#  Results go to a JSON file (OUT, default nat-backends-<time>.json) and
+#  a summary table on stdout. ENTRIES overrides the entry counts.
+#
+#  Usage: sudo bench/nat-backends.sh [seconds] [backend...]
+#         sudo ENTRIES="1 5000" bench/nat-backends.sh 5 nft nft-flowtable
+# =============================================================================
+set -euo pipefail
+
+DURATION="${1:-5}"
+shift || true
+if [[ $# -gt 0 ]]; then BACKENDS=("$@")
+else BACKENDS=(none legacy iptables-nft nft nft-flowtable); fi
+read -r -a COUNTS <<< "${ENTRIES:-1 100 1000}"
+OUT="${OUT:-nat-backends-$(date +%Y%m%d-%H%M%S).json}"
+
+CLI=hsn-cli
+RTR=hsn-rtr
+SRV=hsn-srv
+CLI_IP=192.168.12.10
+SRV_IP=10.99.0.2
+PORT=5203
+
+info()  { echo "[INFO]  $*"; }
+die()   { echo "[FAIL]  $*" >&2; exit 1; }
+
+[[ $EUID -eq 0 ]] || die "must run as root (creates network namespaces)"
+[[ "$DURATION" =~ ^[0-9]+$ ]] || die "duration must be whole seconds"
+command -v python3 >/dev/null 2>&1 || die "need python3 to generate traffic"
+
+# ── Topology ──────────────────────────────────────────────────────────────────
+
+teardown_ns() {
+    for ns in "$CLI" "$RTR" "$SRV"; do
+        ip netns del "$ns" 2>/dev/null || true
+    done
+}
+trap teardown_ns EXIT
+
+in_ns() { local ns="$1"; shift; ip netns exec "$ns" "$@"; }
+
+build_topology() {
+    teardown_ns
+    for ns in "$CLI" "$RTR" "$SRV"; do
+        ip netns add "$ns"
+        in_ns "$ns" ip link set lo up
+    done
+    ip link add veth-cli netns "$CLI" type veth peer name ap0 netns "$RTR"
+    ip link add veth-srv netns "$SRV" type veth peer name up0 netns "$RTR"
+    in_ns "$CLI" ip link set veth-cli up
+    in_ns "$SRV" ip link set veth-srv up
+    in_ns "$RTR" ip link set ap0 up
+    in_ns "$RTR" ip link set up0 up
+
+    in_ns "$CLI" ip addr add "$CLI_IP/24" dev veth-cli
+    in_ns "$CLI" ip route add default via 192.168.12.1
+    in_ns "$RTR" ip addr add 192.168.12.1/24 dev ap0
+    in_ns "$RTR" ip addr add 10.99.0.1/24 dev up0
+    in_ns "$SRV" ip addr add "$SRV_IP/24" dev veth-srv
+    in_ns "$RTR" sysctl -qw net.ipv4.ip_forward=1
+}
+
+# ── Rulesets ──────────────────────────────────────────────────────────────────
+
+# n-1 decoy client addresses, then the measured client
+client_addrs() {
+    local n="$1" i
+    for ((i = 1; i < n; i++)); do
+        echo "10.200.$((i / 250)).$((i % 250 + 1))"
+    done
+    echo "$CLI_IP"
+}
+
+ipt_ruleset() {
+    local n="$1" ip
+    echo "*filter"
+    echo ":HOTSPOT_FWD - [0:0]"
+    echo ":HOTSPOT_ACCT - [0:0]"
+    echo "-A HOTSPOT_FWD -i ap0 -j HOTSPOT_ACCT"
+    echo "-A HOTSPOT_FWD -i up0 -o ap0 -m state --state RELATED,ESTABLISHED -j ACCEPT"
+    echo "-A HOTSPOT_FWD -i ap0 -o up0 -j ACCEPT"
+    while read -r ip; do
+        echo "-A HOTSPOT_ACCT -s $ip/32"
+    done < <(client_addrs "$n")
+    echo "-A FORWARD -j HOTSPOT_FWD"
+    echo "COMMIT"
+    echo "*nat"
+    echo ":HOTSPOT_NAT - [0:0]"
+    echo "-A HOTSPOT_NAT -o up0 -j MASQUERADE"
+    echo "-A POSTROUTING -j HOTSPOT_NAT"
+    echo "COMMIT"
+}
+
+IPT_TEARDOWN='*filter
+-D FORWARD -j HOTSPOT_FWD
+-F HOTSPOT_FWD
+-X HOTSPOT_FWD
+-F HOTSPOT_ACCT
+-X HOTSPOT_ACCT
+COMMIT
+*nat
+-D POSTROUTING -j HOTSPOT_NAT
+-F HOTSPOT_NAT
+-X HOTSPOT_NAT
+COMMIT'
+
+nft_ruleset() {
+    local n="$1" flowtable="$2" ip
+    echo "table inet hotspot {"
+    if [[ $flowtable == yes ]]; then
+        echo "  flowtable ft { hook ingress priority 0; devices = { ap0, up0 }; }"
+    fi
+    echo "  chain acct {"
+    while read -r ip; do
+        echo "    ip saddr $ip counter"
+    done < <(client_addrs "$n")
+    echo "  }"
+    echo "  chain forward {"
+    echo "    type filter hook forward priority filter;"
+    if [[ $flowtable == yes ]]; then
+        echo "    ip protocol { tcp, udp } flow offload @ft"
+    fi
+    echo "    iifname \"ap0\" jump acct"
+    echo "    ct state established,related accept"
+    echo "    iifname \"ap0\" oifname \"up0\" accept"
+    echo "  }"
+    echo "  chain post {"
+    echo "    type nat hook postrouting priority srcnat;"
+    echo "    oifname \"up0\" masquerade"
+    echo "  }"
+    echo "}"
+}
+
+# Prints why a backend cannot run here, nothing if it can
+backend_missing() {
+    case "$1" in
+        none)          ;;
+        legacy)        command -v iptables-legacy-restore >/dev/null 2>&1 ||
+                           echo "iptables-legacy-restore not installed" ;;
+        iptables-nft)  command -v iptables-nft-restore >/dev/null 2>&1 ||
+                           echo "iptables-nft-restore not installed" ;;
+        nft|nft-flowtable)
+                       command -v nft >/dev/null 2>&1 || echo "nft not installed" ;;
+        *)             echo "unknown backend" ;;
+    esac
+}
+
+load_rules() {
+    local backend="$1" n="$2"
+    case "$backend" in
+        none)
+            # No NAT: the sink needs a route back to the client subnet
+            in_ns "$SRV" ip route add 192.168.12.0/24 via 10.99.0.1 ;;
+        legacy)        ipt_ruleset "$n" | in_ns "$RTR" iptables-legacy-restore --noflush ;;
+        iptables-nft)  ipt_ruleset "$n" | in_ns "$RTR" iptables-nft-restore --noflush ;;
+        nft)           nft_ruleset "$n" no  | in_ns "$RTR" nft -f - ;;
+        nft-flowtable) nft_ruleset "$n" yes | in_ns "$RTR" nft -f - ;;
+    esac
+}
+
+unload_rules() {
+    case "$1" in
+        none)          in_ns "$SRV" ip route del 192.168.12.0/24 ;;
+        legacy)        in_ns "$RTR" iptables-legacy-restore --noflush <<< "$IPT_TEARDOWN" ;;
+        iptables-nft)  in_ns "$RTR" iptables-nft-restore --noflush <<< "$IPT_TEARDOWN" ;;
+        nft|nft-flowtable) in_ns "$RTR" nft delete table inet hotspot ;;
+    esac
+}
+
+# ── Measurement ───────────────────────────────────────────────────────────────
+
+now_ns()      { date +%s%N; }
+cpu_jiffies() { awk '/^cpu / { print $4 + $8 }' /proc/stat; }
+
+# rx packets and bytes on the sink's veth
+sink_counters() {
+    in_ns "$SRV" awk '$1 == "veth-srv:" { print $3, $2 }' /proc/net/dev
+}
+
+PUMP_SRV='import socket
+s = socket.socket(); s.setsockopt(socket.SOL_SOCKET, socket.SO_REUSEADDR, 1)
+s.bind(("0.0.0.0", %d)); s.listen(1); c, _ = s.accept()
+while c.recv(1 << 16): pass'
+PUMP_CLI='import socket, time
+s = socket.create_connection(("%s", %d)); b = bytes(1 << 16); end = time.time() + %d
+while time.time() < end: s.sendall(b)'
+
+run_traffic() {
+    local srv_pid
+    if command -v iperf3 >/dev/null 2>&1; then
+        in_ns "$SRV" iperf3 -s -1 -p "$PORT" >/dev/null 2>&1 &
+        srv_pid=$!
+        sleep 0.5
+        in_ns "$CLI" iperf3 -c "$SRV_IP" -p "$PORT" -t "$DURATION" >/dev/null
+    else
+        # shellcheck disable=SC2059
+        in_ns "$SRV" python3 -c "$(printf "$PUMP_SRV" "$PORT")" &
+        srv_pid=$!
+        sleep 0.5
+        # shellcheck disable=SC2059
+        in_ns "$CLI" python3 -c "$(printf "$PUMP_CLI" "$SRV_IP" "$PORT" "$DURATION")"
+    fi
+    wait "$srv_pid" 2>/dev/null || true
+}
+
+HZ=$(getconf CLK_TCK)
+RESULTS=()
+
+# One JSON object per run; a skipped run has only "skipped"
+record() {
+    RESULTS+=("$1")
+}
+
+run_one() {
+    local backend="$1" n="$2" why t0 t1 t2 t3 j0 j1 p0 b0 p1 b1 s0 s1
+
+    why=$(backend_missing "$backend")
+    if [[ -n $why ]]; then
+        record "{\"backend\":\"$backend\",\"entries\":$n,\"skipped\":\"$why\"}"
+        printf "%-14s %7d  skipped: %s\n" "$backend" "$n" "$why"
+        return
+    fi
+
+    build_topology
+    t0=$(now_ns)
+    if ! load_rules "$backend" "$n" 2>/dev/null; then
+        record "{\"backend\":\"$backend\",\"entries\":$n,\"skipped\":\"ruleset rejected\"}"
+        printf "%-14s %7d  skipped: ruleset rejected\n" "$backend" "$n"
+        return
+    fi
+    t1=$(now_ns)
+
+    read -r p0 b0 < <(sink_counters)
+    j0=$(cpu_jiffies); s0=$(now_ns)
+    run_traffic
+    j1=$(cpu_jiffies); s1=$(now_ns)
+    read -r p1 b1 < <(sink_counters)
+
+    t2=$(now_ns)
+    unload_rules "$backend" 2>/dev/null || true
+    t3=$(now_ns)
+
+    local row
+    row=$(awk -v be="$backend" -v n="$n" -v p=$((p1 - p0)) -v b=$((b1 - b0)) \
+              -v j=$((j1 - j0)) -v hz="$HZ" -v secs_ns=$((s1 - s0)) \
+              -v setup_ns=$((t1 - t0)) -v down_ns=$((t3 - t2)) 'BEGIN {
+        secs = secs_ns / 1e9; cpu = j / hz
+        printf "{\"backend\":\"%s\",\"entries\":%d,\"setup_ms\":%.2f," \
+               "\"teardown_ms\":%.2f,\"seconds\":%.2f,\"packets\":%.0f," \
+               "\"pps\":%.0f,\"mbit_s\":%.1f,\"cpu_s\":%.2f,\"us_per_pkt\":%.3f}",
+               be, n, setup_ns / 1e6, down_ns / 1e6, secs, p, p / secs,
+               b * 8 / secs / 1e6, cpu, p ? cpu * 1e6 / p : 0
+    }')
+    record "$row"
+
+    awk -v r="$row" 'BEGIN {
+        # pull the numbers back out of the JSON row for the table
+        gsub(/[{}"]/, "", r); n = split(r, kv, ",")
+        for (i = 1; i <= n; i++) { split(kv[i], f, ":"); v[f[1]] = f[2] }
+        printf "%-14s %7d %9.2f %9.2f %10.0f %9.1f %9.3f\n", v["backend"],
+               v["entries"], v["setup_ms"], v["teardown_ms"], v["pps"],
+               v["mbit_s"], v["us_per_pkt"]
+    }'
+}
+
+# ── Main ──────────────────────────────────────────────────────────────────────
+
+info "${DURATION}s per run; entries: ${COUNTS[*]}; results: $OUT"
+printf "%-14s %7s %9s %9s %10s %9s %9s\n" \
+       backend entries setup_ms down_ms pps mbit_s us/pkt
+
+for backend in "${BACKENDS[@]}"; do
+    for n in "${COUNTS[@]}"; do
+        [[ $n =~ ^[1-9][0-9]*$ ]] || die "entry count must be a positive number: $n"
+        run_one "$backend" "$n"
+    done
+done
+
+{
+    printf '{\n  "duration_s": %d,\n  "kernel": "%s",\n  "runs": [\n' \
+           "$DURATION" "$(uname -r)"
+    for i in "${!RESULTS[@]}"; do
+        printf '    %s%s\n' "${RESULTS[$i]}" "$([[ $i -lt $((${#RESULTS[@]} - 1)) ]] && echo ,)"
+    done
+    printf '  ]\n}\n'
+} > "$OUT"
+info "wrote $OUT"
@@ -0,0 +1,194 @@
+#!/usr/bin/env bash
+# =============================================================================
+#  Linux Hotspot Enabler — forwarding cost benchmark (network namespaces)
+#
+#  Compares the per-packet CPU cost of the three uplink modes without any
+#  WiFi hardware:
+#
+#    nat       client 192.168.12.x → MASQUERADE + conntrack → server
+#    proxyarp  client on the server's subnet, routed as a /32, NOTRACK
+#    bridge    client and server on one Linux bridge, no netfilter
+#
+#    [hsb-cli] ──veth── [hsb-rtr] ──veth── [hsb-srv]
+#
+#  Traffic is a single TCP stream from client to server (iperf3, or a
+#  python3 socket pump when iperf3 is missing). CPU is the host-wide
+#  system + softirq time from /proc/stat during the run; the veth pairs
+#  do their forwarding work in softirq on the sending CPU.
+#
+#  Usage: sudo bench/netns-forward.sh [seconds] [mode...]
+# =============================================================================
+set -euo pipefail
+
+DURATION="${1:-10}"
+shift || true
+if [[ $# -gt 0 ]]; then MODES=("$@"); else MODES=(nat proxyarp bridge); fi
+
+CLI=hsb-cli
+RTR=hsb-rtr
+SRV=hsb-srv
+SRV_IP=10.99.0.2
+PORT=5201
+
+info()  { echo "[INFO]  $*"; }
+warn()  { echo "[WARN]  $*" >&2; }
+die()   { echo "[FAIL]  $*" >&2; exit 1; }
+
+[[ $EUID -eq 0 ]] || die "must run as root (creates network namespaces)"
+[[ "$DURATION" =~ ^[0-9]+$ ]] || die "duration must be whole seconds"
+
+if command -v iperf3 >/dev/null 2>&1; then
+    GEN=iperf3
+elif command -v python3 >/dev/null 2>&1; then
+    GEN=python3
+else
+    die "need iperf3 or python3 to generate traffic"
+fi
+
+# ── Topology ──────────────────────────────────────────────────────────────────
+
+teardown() {
+    for ns in "$CLI" "$RTR" "$SRV"; do
+        ip netns del "$ns" 2>/dev/null || true
+    done
+}
+trap teardown EXIT
+
+in_ns() { local ns="$1"; shift; ip netns exec "$ns" "$@"; }
+
+build_links() {
+    teardown
+    for ns in "$CLI" "$RTR" "$SRV"; do
+        ip netns add "$ns"
+        in_ns "$ns" ip link set lo up
+    done
+    ip link add veth-cli netns "$CLI" type veth peer name ap0 netns "$RTR"
+    ip link add veth-srv netns "$SRV" type veth peer name up0 netns "$RTR"
+    in_ns "$CLI" ip link set veth-cli up
+    in_ns "$SRV" ip link set veth-srv up
+    in_ns "$RTR" ip link set ap0 up
+    in_ns "$RTR" ip link set up0 up
+    in_ns "$SRV" ip addr add "$SRV_IP/24" dev veth-srv
+}
+
+# Firewall helper: iptables when present, else the nft equivalent
+have_iptables() { command -v iptables >/dev/null 2>&1; }
+have_nft()      { command -v nft >/dev/null 2>&1; }
+
+setup_nat() {
+    build_links
+    in_ns "$CLI" ip addr add 192.168.12.10/24 dev veth-cli
+    in_ns "$CLI" ip route add default via 192.168.12.1
+    in_ns "$RTR" ip addr add 192.168.12.1/24 dev ap0
+    in_ns "$RTR" ip addr add 10.99.0.1/24 dev up0
+    in_ns "$RTR" sysctl -qw net.ipv4.ip_forward=1
+    if have_iptables; then
+        in_ns "$RTR" iptables -t nat -A POSTROUTING -o up0 -j MASQUERADE
+        in_ns "$RTR" iptables -A FORWARD -i up0 -o ap0 -m state \
+            --state RELATED,ESTABLISHED -j ACCEPT
+        in_ns "$RTR" iptables -A FORWARD -i ap0 -o up0 -j ACCEPT
+    elif have_nft; then
+        in_ns "$RTR" nft -f - <<'EOF'
+table ip hsb {
+    chain post { type nat hook postrouting priority srcnat; oifname "up0" masquerade; }
+    chain fwd  { type filter hook forward priority filter; ct state established,related accept; iifname "ap0" accept; }
+}
+EOF
+    else
+        return 1
+    fi
+}
+
+setup_proxyarp() {
+    build_links
+    in_ns "$CLI" ip addr add 10.99.0.50/24 dev veth-cli
+    in_ns "$RTR" ip addr add 10.99.0.1/24 dev up0
+    in_ns "$RTR" ip addr add 10.99.0.1/32 dev ap0
+    in_ns "$RTR" ip route add 10.99.0.50/32 dev ap0
+    in_ns "$RTR" sysctl -qw net.ipv4.ip_forward=1
+    in_ns "$RTR" sysctl -qw net.ipv4.conf.ap0.proxy_arp=1
+    in_ns "$RTR" sysctl -qw net.ipv4.conf.up0.proxy_arp=1
+    if have_iptables; then
+        in_ns "$RTR" iptables -t raw -A PREROUTING -i ap0 -j CT --notrack
+        in_ns "$RTR" iptables -t raw -A PREROUTING -i up0 ! -d 10.99.0.1 -j CT --notrack
+    fi
+}
+
+setup_bridge() {
+    build_links
+    in_ns "$RTR" ip link add br0 type bridge
+    in_ns "$RTR" ip link set ap0 master br0
+    in_ns "$RTR" ip link set up0 master br0
+    in_ns "$RTR" ip link set br0 up
+    in_ns "$CLI" ip addr add 10.99.0.50/24 dev veth-cli
+}
+
+# ── Measurement ───────────────────────────────────────────────────────────────
+
+# system + softirq jiffies, summed over all CPUs
+cpu_jiffies() { awk '/^cpu / { print $4 + $8 }' /proc/stat; }
+
+# packets the router received from the client side
+rx_packets() { in_ns "$RTR" awk -v d="$1:" '$1 == d { print $3 }' /proc/net/dev; }
+
+PUMP_SRV='import socket
+s = socket.socket(); s.setsockopt(socket.SOL_SOCKET, socket.SO_REUSEADDR, 1)
+s.bind(("0.0.0.0", %d)); s.listen(1); c, _ = s.accept()
+while c.recv(1 << 16): pass'
+PUMP_CLI='import socket, time
+s = socket.create_connection(("%s", %d)); b = bytes(1 << 16); end = time.time() + %d
+while time.time() < end: s.sendall(b)'
+
+run_traffic() {
+    local srv_pid
+    if [[ $GEN == iperf3 ]]; then
+        in_ns "$SRV" iperf3 -s -1 -p "$PORT" >/dev/null 2>&1 &
+        srv_pid=$!
+        sleep 0.5
+        in_ns "$CLI" iperf3 -c "$SRV_IP" -p "$PORT" -t "$DURATION" >/dev/null
+    else
+        # shellcheck disable=SC2059
+        in_ns "$SRV" python3 -c "$(printf "$PUMP_SRV" "$PORT")" &
+        srv_pid=$!
+        sleep 0.5
+        # shellcheck disable=SC2059
+        in_ns "$CLI" python3 -c "$(printf "$PUMP_CLI" "$SRV_IP" "$PORT" "$DURATION")"
+    fi
+    wait "$srv_pid" 2>/dev/null || true
+}
+
+HZ=$(getconf CLK_TCK)
+
+measure() {
+    local mode="$1" j0 j1 p0 p1 t0 t1
+
+    p0=$(rx_packets ap0)
+    j0=$(cpu_jiffies); t0=$(date +%s.%N)
+    run_traffic
+    j1=$(cpu_jiffies); t1=$(date +%s.%N)
+    p1=$(rx_packets ap0)
+
+    awk -v m="$mode" -v p=$((p1 - p0)) -v j=$((j1 - j0)) -v hz="$HZ" \
+        -v t0="$t0" -v t1="$t1" 'BEGIN {
+        secs = t1 - t0; cpu = j / hz
+        printf "%-10s %12.0f %10.0f %10.2f %12.2f\n", m, p, p / secs, cpu,
+               p ? cpu * 1e6 / p : 0
+    }'
+}
+
+# ── Main ──────────────────────────────────────────────────────────────────────
+
+info "traffic: $GEN, ${DURATION}s per mode"
+printf "%-10s %12s %10s %10s %12s\n" mode packets pkt/s cpu_s us/pkt
+
+for mode in "${MODES[@]}"; do
+    case "$mode" in
+        nat|proxyarp|bridge) ;;
+        *) die "unknown mode '$mode' (nat, proxyarp, bridge)" ;;
+    esac
+    if ! "setup_$mode"; then
+        warn "$mode: needs iptables or nft, skipped"
+        continue
+    fi
+    measure "$mode"
+done
@@ -0,0 +1,141 @@
+#!/usr/bin/env bash
+# =============================================================================
+#  Linux Hotspot Enabler — LAN throughput server over veth
+#
+#  Runs the built-in throughput server ("hotspot-enabler lanperf-serve")
+#  on the gateway side of the client/gateway pair from netns-forward.sh
+#  and drives each test mode from the client. The server's CPU time
+#  (utime + stime from /proc) during each test gives the cost per Gbit/s;
+#  a veth pair has no line rate of its own, so "keeps up on one core"
+#  means the server needs well under one CPU second per second of test.
+#
+#    [hsl-cli 192.168.12.10] ──veth── [hsl-rtr ap0 192.168.12.1: lanperf]
+#
+#    down     TCP, server sendfile() from a memfd
+#    up       TCP, server recv(MSG_TRUNC)
+#    udp      paced datagrams at the given rate, loss seen by the client
+#
+#  Needs ip (iproute2) and python3 (the client side).
+#
+#  Usage: sudo bench/netns-lanperf.sh [seconds] [udp_mbps] [binary]
+# =============================================================================
+set -euo pipefail
+
+DURATION="${1:-10}"
+UDP_MBPS="${2:-500}"
+BIN="${3:-./hotspot-enabler}"
+
+CLI=hsl-cli
+RTR=hsl-rtr
+GW=192.168.12.1
+CLI_IP=192.168.12.10
+PORT=5201
+UDP_PORT=5301
+SRV_PID=
+
+info()  { echo "[INFO]  $*"; }
+die()   { echo "[FAIL]  $*" >&2; exit 1; }
+
+[[ $EUID -eq 0 ]] || die "must run as root (creates network namespaces)"
+[[ "$DURATION" =~ ^[0-9]+$ && $DURATION -ge 2 && $DURATION -le 60 ]] ||
+    die "seconds must be 2-60"
+[[ "$UDP_MBPS" =~ ^[0-9]+$ && $UDP_MBPS -ge 1 ]] || die "udp_mbps must be a whole number"
+[[ -x $BIN ]] || die "no binary at $BIN (run make first)"
+command -v python3 >/dev/null 2>&1 || die "need python3 for the client"
+BIN=$(readlink -f "$BIN")
+
+# ── Topology ──────────────────────────────────────────────────────────────────
+
+teardown() {
+    [[ -z $SRV_PID ]] || kill "$SRV_PID" 2>/dev/null || true
+    for ns in "$CLI" "$RTR"; do
+        ip netns del "$ns" 2>/dev/null || true
+    done
+}
+trap teardown EXIT
+teardown
+
+in_ns() { local ns="$1"; shift; ip netns exec "$ns" "$@"; }
+
+for ns in "$CLI" "$RTR"; do
+    ip netns add "$ns"
+    in_ns "$ns" ip link set lo up
+done
+ip link add veth-cli type veth peer name ap0
+ip link set veth-cli netns "$CLI"
+ip link set ap0 netns "$RTR"
+in_ns "$CLI" ip addr add "$CLI_IP/24" dev veth-cli
+in_ns "$CLI" ip link set veth-cli up
+in_ns "$RTR" ip addr add "$GW/24" dev ap0
+in_ns "$RTR" ip link set ap0 up
+
+ip netns exec "$RTR" "$BIN" lanperf-serve "$GW" "$PORT" > /dev/null &
+SRV_PID=$!
+sleep 0.5
+kill -0 "$SRV_PID" 2>/dev/null || die "lanperf-serve did not start"
+
+# ── Client ────────────────────────────────────────────────────────────────────
+
+# Prints "<client_mbps> <extra>" for one test
+CLIENT='import socket, sys, time
+mode, gw, port, secs, rate, uport = sys.argv[1:7]
+port, secs, rate, uport = int(port), int(secs), int(rate), int(uport)
+c = socket.create_connection((gw, port))
+buf = bytearray(1 << 20)
+if mode == "down":
+    c.sendall(b"down %d\n" % secs)
+    n, t0 = 0, time.time()
+    while True:
+        k = c.recv_into(buf)
+        if not k: break
+        n += k
+    print("%.1f -" % (n * 8 / (time.time() - t0) / 1e6))
+elif mode == "up":
+    c.sendall(b"up %d\n" % secs)
+    chunk, n, t0 = bytes(1 << 16), 0, time.time()
+    try:
+        while time.time() - t0 < secs:
+            c.sendall(chunk); n += len(chunk)
+    except OSError:
+        pass
+    print("%.1f -" % (n * 8 / (time.time() - t0) / 1e6))
+else:
+    u = socket.socket(socket.AF_INET, socket.SOCK_DGRAM)
+    u.setsockopt(socket.SOL_SOCKET, socket.SO_RCVBUF, 8 << 20)
+    u.bind(("0.0.0.0", uport)); u.settimeout(1.0)
+    c.sendall(b"udp %d %d %d\n" % (rate, secs, uport))
+    n, t0 = 0, time.time()
+    try:
+        while True:
+            u.recv_into(buf); n += 1
+    except socket.timeout:
+        pass
+    sent = int(c.recv(64).split()[1])
+    print("%.1f %.2f%%" % (n * 1400 * 8 / secs / 1e6,
+                            100.0 * (sent - n) / sent if sent else 0))'
+
+# Server CPU ticks, all threads
+ticks() { awk '{ print $14 + $15 }' "/proc/$SRV_PID/stat"; }
+
+measure() {
+    local mode="$1" c0 c1 hz out
+    hz=$(getconf CLK_TCK)
+    c0=$(ticks)
+    out=$(in_ns "$CLI" python3 -c "$CLIENT" "$mode" "$GW" "$PORT" \
+          "$DURATION" "$UDP_MBPS" "$UDP_PORT")
+    c1=$(ticks)
+    read -r mbps extra <<< "$out"
+    awk -v m="$mode" -v r="$mbps" -v x="$extra" -v c=$(( (c1 - c0) * 1000 / hz )) \
+        -v d="$DURATION" '
+        BEGIN {
+            cpu = c / (d * 10)                       # % of one core
+            per = r > 0 ? c / d / (r / 1000) : 0     # ms CPU per s per Gbit/s
+            printf "%-6s %10.1f %10.1f %12.1f %8s\n", m, r, cpu, per, x
+        }'
+}
+
+info "client $CLI_IP in $CLI, server $GW:$PORT in $RTR; ${DURATION}s per test"
+printf "%-6s %10s %10s %12s %8s\n" test mbps srv_cpu_% ms_cpu/Gbit udp_loss
+for mode in down up udp; do
+    measure "$mode"
+done
@@ -0,0 +1,99 @@
+/* Generated by tools/oui-gen.awk from data/oui-seed.txt -- do not edit */
+
+#include "oui.h"
+
+const uint32_t oui_entries = 195;
+
+const uint32_t oui_prefix[] = {
+    0x000000, 0x00000C, 0x000142, 0x000393, 0x00040E, 0x00041F, 0x000569, 0x00095B,
+    0x0009BF, 0x000A27, 0x000A95, 0x000C29, 0x000C6E, 0x000D93, 0x000E58, 0x000FB5,
+    0x001018, 0x001124, 0x00112F, 0x00125A, 0x0012FB, 0x001315, 0x001422, 0x001451,
+    0x00146C, 0x00155D, 0x00156D, 0x001599, 0x0015C1, 0x0015F2, 0x001632, 0x001656,
+    0x0016CB, 0x001731, 0x001788, 0x0017AB, 0x0017C9, 0x0017F2, 0x00184D, 0x001882,
+    0x00191D, 0x0019C5, 0x0019E3, 0x001A11, 0x001A92, 0x001B0D, 0x001B21, 0x001B2F,
+    0x001B63, 0x001B78, 0x001C42, 0x001D0D, 0x001D25, 0x001D60, 0x001E0B, 0x001E10,
+    0x001E2A, 0x001E8C, 0x001EC2, 0x001F32, 0x001F3B, 0x001F5B, 0x001FF3, 0x002119,
+    0x002147, 0x00216A, 0x00219B, 0x0021E9, 0x002215, 0x00223F, 0x002241, 0x0022FA,
+    0x002312, 0x002332, 0x002339, 0x002354, 0x00236C, 0x0023DF, 0x00241E, 0x002436,
+    0x00248C, 0x00248D, 0x0024B2, 0x0024D7, 0x0024E8, 0x002500, 0x00254B, 0x00259E,
+    0x0025B3, 0x0025BC, 0x002608, 0x002618, 0x002637, 0x00264A, 0x0026B0, 0x0026BB,
+    0x0026F2, 0x002722, 0x005056, 0x0050F2, 0x00A0C6, 0x00E04C, 0x00E0FC, 0x0418D6,
+    0x080027, 0x08606E, 0x0C47C9, 0x10BF48, 0x14CC20, 0x14DAE9, 0x180373, 0x18B430,
+    0x18FE34, 0x204E7F, 0x240AC4, 0x246511, 0x246F28, 0x24A43C, 0x280DFC, 0x281878,
+    0x286C07, 0x286ED4, 0x28CDC1, 0x28CFE9, 0x2C56DC, 0x30AEA4, 0x3480B3, 0x3810D5,
+    0x3C0754, 0x3C5AB4, 0x3CA62F, 0x3CA9F4, 0x3CD92B, 0x44650D, 0x50465D, 0x508F4C,
+    0x50C7BF, 0x546009, 0x5C0A5B, 0x5CAAFD, 0x5CCF7F, 0x600194, 0x640980, 0x641666,
+    0x647002, 0x6837E9, 0x687251, 0x705681, 0x74C246, 0x7C1E52, 0x7C7A91, 0x7CBB8A,
+    0x7CD1C3, 0x7CFF4D, 0x802AA8, 0x84F3EB, 0x8C705A, 0x8C7712, 0x94652D, 0x949F3E,
+    0x98B6E9, 0x98DAC4, 0xA040A0, 0xA088B4, 0xA4CF12, 0xAC220B, 0xACBC32, 0xB0A737,
+    0xB827EB, 0xB8AC6F, 0xB8E937, 0xC02506, 0xC04A00, 0xC0EEFB, 0xCC6DA0, 0xD023DB,
+    0xD83134, 0xD83ADD, 0xDC3A5E, 0xDC9FDB, 0xDCA632, 0xE45F01, 0xEC086B, 0xF01898,
+    0xF025B7, 0xF0272D, 0xF09FC2, 0xF4F26D, 0xF4F5D8, 0xF4F5E8, 0xF81654, 0xF8A45F,
+    0xF8B156, 0xF8D0AC, 0xFC65DE,
+    0
+};
+
+const uint16_t oui_name_index[] = {
+    0, 1, 1, 2, 3, 4, 5, 6, 7, 2, 2, 5,
+    8, 2, 9, 6, 10, 2, 8, 11, 12, 4, 13, 2,
+    6, 11, 14, 12, 4, 8, 12, 7, 2, 8, 15, 7,
+    12, 2, 6, 16, 7, 4, 2, 17, 8, 1, 18, 6,
+    2, 19, 20, 4, 12, 8, 19, 16, 6, 8, 2, 7,
+    18, 2, 2, 12, 7, 18, 13, 2, 8, 6, 2, 18,
+    2, 2, 12, 8, 2, 2, 7, 2, 8, 4, 6, 18,
+    13, 2, 2, 16, 19, 2, 2, 8, 12, 2, 2, 2,
+    6, 14, 5, 11, 21, 22, 16, 14, 23, 8, 24, 8,
+    25, 8, 13, 26, 27, 6, 27, 3, 27, 14, 4, 11,
+    28, 16, 29, 2, 8, 27, 28, 3, 2, 17, 3, 18,
+    19, 24, 8, 28, 25, 17, 12, 9, 27, 27, 28, 26,
+    25, 24, 14, 2, 24, 11, 18, 7, 2, 3, 14, 27,
+    18, 12, 30, 9, 7, 25, 6, 18, 27, 8, 2, 31,
+    32, 13, 9, 3, 25, 30, 31, 2, 31, 29, 31, 14,
+    29, 29, 25, 2, 12, 24, 14, 25, 17, 17, 18, 28,
+    13, 4, 24,
+    0
+};
+
+const uint32_t oui_name_offset[] = {
+    0, 6, 20, 26, 30, 61, 68, 76, 85, 102,
+    108, 117, 127, 147, 152, 170, 187, 207, 214, 230,
+    246, 256, 265, 287, 305, 325, 346, 356, 366, 388,
+    409, 439, 444,
+    0
+};
+
+const char oui_names[] =
+    "XEROX\0"
+    "Cisco Systems\0"
+    "Apple\0"
+    "AVM\0"
+    "Sony Interactive Entertainment\0"
+    "VMware\0"
+    "NETGEAR\0"
+    "Nintendo\0"
+    "ASUSTek COMPUTER\0"
+    "Sonos\0"
+    "Broadcom\0"
+    "Microsoft\0"
+    "Samsung Electronics\0"
+    "Dell\0"
+    "Ubiquiti Networks\0"
+    "Philips Lighting\0"
+    "HUAWEI TECHNOLOGIES\0"
+    "Google\0"
+    "Intel Corporate\0"
+    "Hewlett Packard\0"
+    "Parallels\0"
+    "Qualcomm\0"
+    "Realtek Semiconductor\0"
+    "PCS Systemtechnik\0"
+    "Amazon Technologies\0"
+    "TP-LINK TECHNOLOGIES\0"
+    "Nest Labs\0"
+    "Espressif\0"
+    "Xiaomi Communications\0"
+    "Raspberry Pi Trading\0"
+    "OnePlus Technology (Shenzhen)\0"
+    "Roku\0"
+    "Raspberry Pi Foundation\0"
+    "";
@@ -0,0 +1,18 @@
+/*
+ * bench.h - Built-in benchmark for Linux Hotspot Enabler
+ *
+ * "hotspot-enabler bench [iterations]" replays the work of one refresh
+ * tick (lease parse, status snapshot, TUI render) against synthetic
+ * data. It needs no root and no WiFi hardware, so it doubles as the
+ * training workload for "make pgo".
+ */
+
+#ifndef BENCH_H
+#define BENCH_H
+
+#define BENCH_DEFAULT_ITERATIONS  2000
+
+/* Run the benchmark and print per-operation CPU times. Returns 0 on success */
+int bench_run(int iterations);
+
+#endif /* BENCH_H */
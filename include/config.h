@@ -0,0 +1,44 @@
+/*
+ * config.h - Configuration file loading for Linux Hotspot Enabler
+ *
+ * Reads an optional key = value file that seeds the hotspot settings
+ * and enables optional services such as the status web dashboard and
+ * event hooks.
+ */
+
+#ifndef CONFIG_H
+#define CONFIG_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include "hotspot.h"
+#include "hooks.h"
+#include "lanperf.h"
+
+#define CONFIG_DEFAULT_PATH "/etc/hotspot-enabler.conf"
+
+/* ── Application Settings ────────────────────────────────────────────── */
+
+typedef struct {
+    char         http_listen[MAX_IP_LEN + 8];   /* "addr:port", "" = off */
+    int          http_max_viewers;
+    bool         lanperf;                       /* LAN throughput server */
+    int          lanperf_port;
+    int          lanperf_max_tests;
+    HookRegistry hooks;
+} AppConfig;
+
+/* ── Functions ───────────────────────────────────────────────────────── */
+
+/* Set default application settings */
+void config_default(AppConfig *app);
+
+/*
+ * Load settings from path into the hotspot config and app settings.
+ * A missing file is not an error. Returns false and fills err on a
+ * malformed line or unknown key.
+ */
+bool config_load(const char *path, HotspotConfig *hs, AppConfig *app,
+                 char *err, size_t errsize);
+
+#endif /* CONFIG_H */
@@ -0,0 +1,67 @@
+/*
+ * connlimit.h - Per-client connection caps for Linux Hotspot Enabler
+ *
+ * One client opening thousands of connections per second can fill
+ * nf_conntrack and pin softirq CPU for everybody. In NAT mode the
+ * hotspot's own nftables table ("table inet hotspot") caps every client
+ * address on the AP side with a meter on new connections per second
+ * and a ct count on concurrent ones. Clients that hit a cap are put in
+ * an "offenders" set for a minute, which the Clients screen shows.
+ *
+ * While the caps are active, nf_conntrack_max is raised to fit
+ * max_clients x the per-client cap, and the established-TCP and UDP
+ * timeouts are lowered to router values (never raised); all of it is
+ * restored on stop.
+ */
+
+#ifndef CONNLIMIT_H
+#define CONNLIMIT_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include "net_utils.h"
+
+#define CONNLIMIT_TABLE        "hotspot"
+#define CONNLIMIT_FLAG_SECS    60      /* offender mark lifetime */
+#define CONNLIMIT_HOST_CT      4096    /* conntrack room kept for the host */
+#define CONNLIMIT_DEFAULT_CT   1024    /* per-client budget when max is 0 */
+
+typedef struct {
+    int rate;       /* new connections per second per client, 0 = no cap */
+    int max;        /* concurrent connections per client, 0 = no cap */
+} ConnLimitConfig;
+
+/* Sysctl values before sizing (-1 = untouched) and whether the table is ours */
+typedef struct {
+    bool table;
+    long ct_max;
+    long ct_buckets;
+    long tcp_established;
+    long udp;
+    long udp_stream;
+} ConnLimitSaved;
+
+/* ── Functions ───────────────────────────────────────────────────────── */
+
+void connlimit_default(ConnLimitConfig *cfg);
+void connlimit_init(ConnLimitSaved *saved);
+
+/* Any cap configured? */
+bool connlimit_enabled(const ConnLimitConfig *cfg);
+
+/*
+ * Load the nftables caps for clients arriving on ap_iface and size
+ * conntrack for max_clients. Returns false with err set when nft is
+ * missing or rejects the table; sizing is still applied.
+ */
+bool connlimit_start(const ConnLimitConfig *cfg, const char *ap_iface,
+                     int max_clients, ConnLimitSaved *saved,
+                     char *err, size_t errsize);
+
+/* Delete the table and restore the conntrack sysctls */
+void connlimit_stop(ConnLimitSaved *saved);
+
+/* Addresses that hit a cap in the last CONNLIMIT_FLAG_SECS. Returns count */
+int connlimit_offenders(char ips[][MAX_IP_LEN], int max);
+
+#endif /* CONNLIMIT_H */
@@ -0,0 +1,114 @@
+/*
+ * coord.h - Multi-node coordination for Linux Hotspot Enabler
+ *
+ * Several hosts running the tool in one place announce themselves once
+ * a second on a UDP multicast group (TTL 1, one segment: a wired LAN or
+ * the uplink). Each announcement carries the SSID, AP channel, client
+ * count and limit, and whether the node has its own AP radio. From the
+ * peers heard in the last COORD_PEER_TIMEOUT seconds every node works
+ * out, on its own, two things:
+ *
+ *   channel  Nodes with a dedicated radio spread over 1/6/11 or the
+ *            non-DFS 5 GHz channels, weighted by the clients already
+ *            on each. When two share a channel, the one with the
+ *            highest id moves; nodes on a shared radio never move.
+ *   load     A node at overload_pct of max_clients, with a peer on the
+ *            same SSID well below it, stops taking new clients (and
+ *            answering probes) until it drops back.
+ *
+ * Every announcement carries an HMAC-SHA-256 under a shared key
+ * (coord_key) over the rest of the line, and a per-node sequence number
+ * so a recorded one cannot be replayed while its node is live. Anything
+ * else on the group is dropped. The content is not encrypted.
+ *
+ *   HSC2 mac=<64 hex> id=1a2b3c4d seq=42 ch=6 cl=3 max=10 ded=1 name=laptop-2 ssid=Hall
+ */
+
+#ifndef COORD_H
+#define COORD_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <time.h>
+#include "net_utils.h"
+
+#define COORD_MAGIC            "HSC2"
+#define COORD_DEFAULT_GROUP    "239.255.72.1"
+#define COORD_DEFAULT_PORT     47210
+#define COORD_ANNOUNCE_MS      1000
+#define COORD_PEER_TIMEOUT     5      /* seconds of silence before a peer goes */
+#define COORD_SETTLE_MS        2500   /* listen this long before a first pick */
+#define COORD_SWITCH_COOLDOWN  60     /* seconds between our own channel moves */
+#define COORD_LOAD_MARGIN      20     /* points a peer must be below us */
+#define COORD_MAX_PEERS        16
+#define COORD_MAX_EVENTS       32
+#define COORD_KEY_LEN          128
+#define COORD_MIN_KEY          16     /* characters */
+
+typedef struct {
+    bool enabled;
+    char iface[MAX_IFACE_NAME];  /* segment the hosts share (required) */
+    char key[COORD_KEY_LEN];     /* shared announcement key (required) */
+    char group[MAX_IP_LEN];
+    int  port;
+    int  overload_pct;           /* load that sends new clients elsewhere */
+} CoordConfig;
+
+typedef struct {
+    uint32_t id;
+    uint32_t seq;                /* last announcement accepted */
+    char     name[32];           /* host name */
+    char     ssid[MAX_SSID_LEN];
+    int      channel;            /* 0 = hotspot not running */
+    int      clients;
+    int      max_clients;
+    bool     dedicated;          /* own AP radio, free to change channel */
+    time_t   last_seen;
+} CoordPeer;
+
+/* ── Functions ───────────────────────────────────────────────────────── */
+
+/* Defaults: off, COORD_DEFAULT_GROUP:COORD_DEFAULT_PORT, 80 % */
+void coord_default(CoordConfig *cfg);
+
+/* Fails without coord_iface or with a key shorter than COORD_MIN_KEY */
+bool coord_start(const CoordConfig *cfg, char *err, size_t errsize);
+void coord_stop(void);
+bool coord_running(void);
+
+/* What this node announces. channel 0 = hotspot stopped */
+void coord_set_local(const char *ssid, int channel, int clients,
+                     int max_clients, bool dedicated);
+
+/* Channels our radio may use (regulatory); count 0 = every candidate */
+void coord_set_allowed(const int *channels, int count);
+
+/*
+ * The candidate channels of a band, least used by peers first. Waits
+ * until COORD_SETTLE_MS after the start so peers have been heard.
+ * Returns the number written to out.
+ */
+int coord_rank_channels(bool band5, int *out, int max);
+
+/* A channel to move to because ours is shared and we should yield; 0 = stay */
+int coord_wanted_channel(void);
+
+/* Refuse clients beyond this many (-1 = no cap) */
+int coord_admit_cap(void);
+
+/* Copy of the live peers. Returns the count */
+int coord_peers(CoordPeer *out, int max);
+
+/* Pop the next peer / decision message for the log. False when empty */
+bool coord_next_event(char *msg, size_t msgsize);
+
+/*
+ * "coord-sim IFACE CHANNEL CLIENTS MAX [SECONDS] [KEY]": run the protocol
+ * with a simulated dedicated-radio node and print its decisions, for
+ * testing several nodes in network namespaces. KEY defaults to a fixed
+ * test key. Returns a process exit status.
+ */
+int coord_simulate(int argc, char **argv);
+
+#endif /* COORD_H */
@@ -0,0 +1,15 @@
+/*
+ * doctor.h - Prerequisite diagnostics for Linux Hotspot Enabler
+ *
+ * "hotspot-enabler doctor" runs every prerequisite check at once and
+ * prints a ranked report, instead of starting the hotspot and reading
+ * the log to find out what is wrong.
+ */
+
+#ifndef DOCTOR_H
+#define DOCTOR_H
+
+/* Run all checks concurrently, print the report. Returns 1 on failure */
+int doctor_run(void);
+
+#endif /* DOCTOR_H */
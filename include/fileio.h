@@ -0,0 +1,115 @@
+/*
+ * fileio.h - Batched small-file I/O for Linux Hotspot Enabler
+ *
+ * Config writes, lease/procfs/sysfs reads and cleanup unlinks are queued
+ * in a FioBatch and submitted together. With io_uring the whole batch
+ * costs one or two io_uring_enter calls instead of open/read/close per
+ * file; on kernels without it (or where it is disabled) the same batch
+ * runs as plain syscalls.
+ *
+ * Frequently re-read sysfs/procfs files can be registered once: they
+ * stay open (as io_uring fixed files when available) and are read at
+ * offset 0 on every refresh.
+ */
+
+#ifndef FILEIO_H
+#define FILEIO_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <sys/types.h>
+
+#define FIO_MAX_OPS   16    /* per batch */
+#define FIO_MAX_REG   8     /* registered files */
+
+/* ── Batches ─────────────────────────────────────────────────────────── */
+
+typedef enum {
+    FIO_OP_READ,        /* whole (small) file into buf, NUL-terminated */
+    FIO_OP_WRITE,       /* create/truncate and write data */
+    FIO_OP_UNLINK
+} FioOpType;
+
+typedef struct {
+    FioOpType   type;
+    const char *path;   /* NULL for a registered slot */
+    int         slot;   /* registered slot for reads, -1 = path */
+    char       *buf;    /* read: destination */
+    const char *data;   /* write: source */
+    size_t      len;    /* read: buffer size; write: data length */
+    mode_t      mode;   /* write: permissions if the file is created */
+    long        result; /* bytes read/written, 0 for unlink, or -errno */
+    int         fd;     /* internal */
+} FioOp;
+
+typedef struct {
+    FioOp ops[FIO_MAX_OPS];
+    int   count;
+} FioBatch;
+
+typedef struct {
+    bool          uring;        /* io_uring backend active */
+    unsigned long batches;
+    unsigned long ops;
+    unsigned long syscalls;     /* made by this layer for batches */
+} FioStats;
+
+/* ── Functions ───────────────────────────────────────────────────────── */
+
+void fio_batch_init(FioBatch *batch);
+
+/* Queue an operation. Returns NULL when the batch is full */
+FioOp *fio_add_read(FioBatch *batch, const char *path, char *buf, size_t size);
+FioOp *fio_add_read_slot(FioBatch *batch, int slot, char *buf, size_t size);
+FioOp *fio_add_write(FioBatch *batch, const char *path,
+                     const char *data, size_t len, mode_t mode);
+FioOp *fio_add_unlink(FioBatch *batch, const char *path);
+
+/*
+ * Run every queued operation and fill in each result. Returns true if
+ * all of them succeeded (a missing file to unlink counts as success).
+ */
+bool fio_submit(FioBatch *batch);
+
+/* One-operation conveniences */
+bool fio_read_file(const char *path, char *buf, size_t size);
+bool fio_write_file(const char *path, const char *data, size_t len, mode_t mode);
+
+/* 64-bit FNV-1a of a buffer */
+uint64_t fio_hash(const void *data, size_t len);
+
+/*
+ * Write data to path only if the content changed. *hash is the hash of
+ * what is on disk, kept by the caller between calls; 0 means unknown,
+ * in which case the file is read and compared once; a missing file or
+ * a size change also drops it. A changed file is written to a temp file
+ * in the same directory and renamed into place. Returns 1 if the file
+ * was written, 0 if it was already up to date, -1 on error.
+ */
+int fio_update_file(const char *path, const char *data, size_t len,
+                    mode_t mode, uint64_t *hash);
+
+/*
+ * Create a directory with mode 0700, or tighten an existing one.
+ * Refuses symlinks and directories owned by another user.
+ */
+bool fio_private_dir(const char *path);
+
+/* Keep path open for repeated reads. Returns a slot, or -1 */
+int  fio_register(const char *path);
+void fio_unregister(int slot);
+
+/*
+ * Switch between io_uring and plain syscalls (io_uring is tried first by
+ * default). Returns whether io_uring is in use afterwards.
+ */
+bool fio_use_uring(bool enable);
+
+void fio_get_stats(FioStats *stats);
+void fio_reset_stats(void);
+
+/* Release the ring and close registered files */
+void fio_shutdown(void);
+
+#endif /* FILEIO_H */
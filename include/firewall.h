@@ -0,0 +1,51 @@
+/*
+ * firewall.h - NAT rule backends for Linux Hotspot Enabler
+ *
+ * The NAT uplink needs a MASQUERADE rule and two FORWARD rules. They can
+ * be installed one iptables process per rule (the original way, works
+ * everywhere), or as one iptables-restore --noflush transaction that
+ * fills a dedicated chain pair:
+ *
+ *   filter: FORWARD     -j HOTSPOT_FWD   (ESTABLISHED back in, AP out)
+ *   nat:    POSTROUTING -j HOTSPOT_NAT   (MASQUERADE out of the uplink)
+ *
+ * With a large ruleset every iptables call reloads the whole table, so
+ * the batch backend costs one load for setup and one for teardown, and
+ * leaves only two jump rules in the built-in chains.
+ */
+
+#ifndef FIREWALL_H
+#define FIREWALL_H
+
+#include <stdbool.h>
+#include <stddef.h>
+
+#define FW_CHAIN_FWD  "HOTSPOT_FWD"
+#define FW_CHAIN_NAT  "HOTSPOT_NAT"
+
+typedef enum {
+    FW_BACKEND_AUTO,        /* restore if iptables-restore exists */
+    FW_BACKEND_IPTABLES,    /* one iptables process per rule */
+    FW_BACKEND_RESTORE      /* iptables-restore --noflush, own chains */
+} FwBackend;
+
+/* ── Functions ───────────────────────────────────────────────────────── */
+
+/* Parse "auto", "iptables" or "restore" */
+bool fw_parse_backend(const char *value, FwBackend *backend);
+const char *fw_backend_name(FwBackend backend);
+
+/* The backend AUTO stands for on this system */
+FwBackend fw_resolve(FwBackend backend);
+
+/* Install the NAT rules for ap_iface behind uplink */
+bool fw_nat_setup(FwBackend backend, const char *ap_iface, const char *uplink,
+                  char *err, size_t errsize);
+
+/* Remove them again (quietly, whatever is left of them) */
+void fw_nat_teardown(FwBackend backend, const char *ap_iface, const char *uplink);
+
+/* Is the MASQUERADE rule in place? */
+bool fw_nat_present(FwBackend backend, const char *uplink);
+
+#endif /* FIREWALL_H */
@@ -0,0 +1,60 @@
+/*
+ * hapd.h - Persistent hostapd for Linux Hotspot Enabler
+ *
+ * One hostapd is started without any interface and a global control
+ * socket (-g). AP interfaces are added and removed through it:
+ *
+ *   ADD ap0 config=/run/hotspot-enabler/hostapd.conf    -> OK | FAIL
+ *   REMOVE ap0                                          -> OK | FAIL
+ *
+ * so a config swap (the startup fallback ladder, a stop and a restart)
+ * costs one round trip instead of a process start and the nl80211
+ * setup it drags in. Per-interface control sockets still come from
+ * ctrl_interface= in the config, so hostapd_cli works as before.
+ */
+
+#ifndef HAPD_H
+#define HAPD_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <sys/types.h>
+#include "hotspot.h"
+
+#define HAPD_GLOBAL_PATH  HOTSPOT_RUN_DIR "/hostapd-global"
+#define HAPD_PID_PATH     HOTSPOT_RUN_DIR "/hostapd.pid"
+#define HAPD_REPLY_MS     5000    /* ADD runs the whole interface setup */
+
+/* ── Functions ───────────────────────────────────────────────────────── */
+
+/*
+ * Make sure the daemon is up: reuse one answering PING on the global
+ * socket, otherwise start "<exec_prefix>hostapd -g ..." logging to
+ * log_path. Returns its pid, or 0 with err set.
+ */
+pid_t hapd_daemon_start(const char *exec_prefix, const char *log_path,
+                        char *err, size_t errsize);
+
+/* Pid of a daemon answering PING, 0 when there is none */
+pid_t hapd_daemon_pid(void);
+
+/*
+ * TERMINATE over the global control socket (the daemon drops any
+ * interfaces it still runs); SIGKILL if it is still alive after 3 s
+ */
+void hapd_daemon_stop(void);
+
+/* Bring iface up with conf_path. False with hostapd's reply in err */
+bool hapd_add(const char *iface, const char *conf_path,
+              char *err, size_t errsize);
+
+/* Take iface out of the daemon; harmless if it is not there */
+bool hapd_remove(const char *iface);
+
+/*
+ * Send one command on the global socket and wait up to timeout_ms for
+ * the reply (NUL-terminated, trailing newline stripped).
+ */
+bool hapd_request(const char *cmd, char *reply, size_t size, int timeout_ms);
+
+#endif /* HAPD_H */
@@ -0,0 +1,115 @@
+/*
+ * hooks.h - Asynchronous event hooks for Linux Hotspot Enabler
+ *
+ * Site-specific commands run on hotspot events (client joined, uplink
+ * changed, daemon crashed, ...). Each run receives the event as one
+ * line of JSON on stdin and executes on a bounded worker pool, so a
+ * slow hook never delays the main loop or the TUI.
+ */
+
+#ifndef HOOKS_H
+#define HOOKS_H
+
+#include <stdbool.h>
+#include "net_utils.h"
+
+#define HOOK_MAX_PER_EVENT   4
+#define HOOK_MAX_WORKERS     8
+#define HOOK_MAX_QUEUE       256
+#define HOOK_PAYLOAD_LEN     512
+
+/* ── Events ──────────────────────────────────────────────────────────── */
+
+typedef enum {
+    HOOK_HOTSPOT_STARTED,
+    HOOK_HOTSPOT_STOPPED,
+    HOOK_CLIENT_JOINED,
+    HOOK_CLIENT_LEFT,
+    HOOK_UPLINK_CHANGED,
+    HOOK_DAEMON_CRASHED,
+    HOOK_EVENT_COUNT
+} HookEvent;
+
+/* ── Registry (filled from the config file) ──────────────────────────── */
+
+typedef struct {
+    char commands[HOOK_EVENT_COUNT][HOOK_MAX_PER_EVENT][MAX_CMD_LEN];
+    int  count[HOOK_EVENT_COUNT];
+    int  timeout_s[HOOK_EVENT_COUNT];   /* 0 = use default_timeout_s */
+    int  default_timeout_s;
+    int  workers;
+    int  queue_limit;
+} HookRegistry;
+
+typedef struct {
+    int           configured;   /* total registered commands */
+    unsigned long queued;       /* currently waiting */
+    unsigned long completed;    /* exited with status 0 */
+    unsigned long failed;       /* non-zero exit or exec failure */
+    unsigned long timed_out;    /* killed after their timeout */
+    unsigned long dropped;      /* rejected because the queue was full */
+} HookStats;
+
+/* ── Functions ───────────────────────────────────────────────────────── */
+
+#ifndef HOTSPOT_NO_HOOKS
+
+/* Set registry defaults (2 workers, queue of 32, 10 s timeout) */
+void hooks_registry_default(HookRegistry *reg);
+
+/* Map between event names used in the config ("client_joined") and ids */
+bool hooks_event_from_name(const char *name, HookEvent *ev);
+const char *hooks_event_name(HookEvent ev);
+
+/* Register a command for an event. Returns false if the event is full */
+bool hooks_registry_add(HookRegistry *reg, HookEvent ev, const char *command);
+
+/* Start the worker pool. No threads are created if nothing is registered */
+bool hooks_start(const HookRegistry *reg);
+
+/*
+ * Queue an event. fields_fmt formats extra JSON members appended after
+ * "event" and "time", e.g. "\"mac\":\"%s\"". Never blocks: when the
+ * queue is full the run is dropped and counted.
+ */
+void hooks_emit(HookEvent ev, const char *fields_fmt, ...)
+    __attribute__((format(printf, 2, 3)));
+
+/* Snapshot of the pool counters */
+void hooks_get_stats(HookStats *stats);
+
+/*
+ * Stop the pool. Pending runs get a short grace period, then whatever
+ * is left is discarded and running hooks are killed.
+ */
+void hooks_stop(void);
+
+#else   /* built with WITH_HOOKS=0 */
+
+#include <string.h>
+
+static inline void hooks_registry_default(HookRegistry *reg)
+{
+    memset(reg, 0, sizeof(HookRegistry));
+}
+static inline bool hooks_event_from_name(const char *name, HookEvent *ev)
+{
+    return false;
+}
+static inline const char *hooks_event_name(HookEvent ev) { return ""; }
+static inline bool hooks_registry_add(HookRegistry *reg, HookEvent ev,
+                                      const char *command)
+{
+    return false;
+}
+static inline bool hooks_start(const HookRegistry *reg) { return true; }
+static inline void hooks_emit(HookEvent ev, const char *fields_fmt, ...) { }
+static inline void hooks_get_stats(HookStats *stats)
+{
+    memset(stats, 0, sizeof(HookStats));
+}
+static inline void hooks_stop(void) { }
+
+#endif /* HOTSPOT_NO_HOOKS */
+
+#endif /* HOOKS_H */
@@ -9,8 +9,18 @@
 #define HOTSPOT_H
 
 #include <stdbool.h>
+#include <stdint.h>
 #include <time.h>
 #include "net_utils.h"
+#include "procsched.h"
+#include "steer.h"
+#include "statune.h"
+#include "txq.h"
+#include "firewall.h"
+#include "connlimit.h"
+#include "uplink.h"
+#include "recorder.h"
+#include "coord.h"
 
 #define AP_IFACE_NAME     "ap0"
 #define AP_SUBNET         "192.168.12"
@@ -18,24 +28,72 @@
 #define AP_NETMASK        "255.255.255.0"
 #define AP_DHCP_START     "192.168.12.10"
 #define AP_DHCP_END       "192.168.12.254"
-
-#define HOSTAPD_CONF_PATH "/tmp/hotspot_enabler_hostapd.conf"
-#define DNSMASQ_CONF_PATH "/tmp/hotspot_enabler_dnsmasq.conf"
+#define AP_LEASE_SECS     43200
+
+/* Daemon configs hold the passphrase: private 0700 runtime directory */
+#define HOTSPOT_RUN_DIR   "/run/hotspot-enabler"
+#define HOSTAPD_CONF_PATH HOTSPOT_RUN_DIR "/hostapd.conf"
+#define DNSMASQ_CONF_PATH HOTSPOT_RUN_DIR "/dnsmasq.conf"
+#define HOSTAPD_LOG_PATH  HOTSPOT_RUN_DIR "/hostapd.log"
+#define LEGACY_HOSTAPD_CONF "/tmp/hotspot_enabler_hostapd.conf"
+#define LEGACY_DNSMASQ_CONF "/tmp/hotspot_enabler_dnsmasq.conf"
+#define LEGACY_HOSTAPD_LOG  "/tmp/hotspot_enabler_hostapd.log"
 #define DNSMASQ_LEASE_FILE "/tmp/hotspot_enabler_dnsmasq.leases"
-#define HOSTAPD_LOG_PATH  "/tmp/hotspot_enabler_hostapd.log"
+#define DNSMASQ_PID_PATH  "/tmp/hotspot_enabler_dnsmasq.pid"
+#define DNSMASQ_LOG_PATH  "/tmp/hotspot_enabler_dnsmasq.log"
+
+/* Live DHCP tables: read by dnsmasq after it drops root, so not private */
+#define DHCP_DIR          "/run/hotspot-enabler-dhcp"
+#define DHCP_HOSTS_DIR    DHCP_DIR "/hosts"   /* dhcp-hostsdir */
+#define DHCP_OPTS_DIR     DHCP_DIR "/opts"    /* dhcp-optsdir */
+#define DHCP_OPTS_PATH    DHCP_OPTS_DIR "/hotspot"
+#define HOSTAPD_CTRL_DIR  "/var/run/hostapd"
 
 /* ── Hotspot Configuration ───────────────────────────────────────────── */
 
+/* What to do when the AP channel needs radar detection (DFS) */
+typedef enum {
+    DFS_CAC,        /* stay on the channel, wait out the CAC */
+    DFS_AVOID       /* move to a non-DFS 5 GHz channel (needs ap_phy) */
+} DfsPolicy;
+
+/* Key management (see generate_hostapd_conf for the SAE tuning) */
+typedef enum {
+    SEC_WPA2,       /* WPA2-PSK only (default) */
+    SEC_TRANSITION, /* WPA2-PSK and WPA3-SAE, optional MFP */
+    SEC_SAE         /* WPA3-SAE only, H2E only, required MFP */
+} SecurityMode;
+
 typedef struct {
     char ssid[MAX_SSID_LEN];
     char password[MAX_SSID_LEN];
     int  channel;           /* 0 = auto (match client) */
     int  max_clients;
     bool hidden;
+    SecurityMode    security;
+    int             sae_anti_clogging; /* open SAE commits before tokens */
+    ProcSchedConfig sched;  /* hostapd, dnsmasq and main loop placement */
+    SteerConfig     steer;  /* 802.11v band steering to a 5 GHz peer */
+    char            ap_phy[MAX_IFACE_NAME];  /* dedicated AP radio, "" = share */
+    DfsPolicy       dfs_policy;
+    UplinkConfig    uplink;  /* NAT (default), bridge or proxy-ARP */
+    FwBackend       nat_backend; /* how NAT rules are installed */
+    ConnLimitConfig connlimit;   /* per-client connection caps (NAT mode) */
+    bool            sta_tune; /* no bgscan / power save on the uplink STA */
+    TxqAqlConfig    aql;     /* airtime queue limits for the AP phy */
+    RecConfig       recorder; /* 10 Hz flight recorder */
+    bool            netns;   /* AP radio, hostapd, dnsmasq in a namespace */
+    CoordConfig     coord;   /* multi-node channel / load coordination */
 } HotspotConfig;
 
 /* ── Hotspot Runtime State ───────────────────────────────────────────── */
 
+/* A rendered daemon config and whether the last render changed it */
+typedef struct {
+    uint64_t hash;          /* FNV-1a of the content on disk, 0 = unknown */
+    bool     changed;       /* last render differed (daemon needs reload) */
+} ConfFile;
+
 typedef enum {
     HS_STATE_STOPPED,
     HS_STATE_STARTING,
@@ -49,6 +107,11 @@ typedef struct {
     HotspotConfig   config;
     WifiInterface   wifi;           /* Client WiFi info */
     char            ap_iface[MAX_IFACE_NAME];
+    int             ap_channel;     /* channel hostapd was started on */
+    bool            dfs;            /* ap_channel needs radar detection */
+    time_t          cac_end;        /* CAC in progress until then, 0 = none */
+    long            log_pos;        /* hostapd log read offset */
+    char            event[MAX_CMD_LEN];   /* runtime message for the log */
     char            phy[MAX_IFACE_NAME];
     int             client_count;
     ConnectedClient clients[MAX_CLIENTS];
@@ -57,6 +120,20 @@ typedef struct {
     pid_t           hostapd_pid;
     pid_t           dnsmasq_pid;
     bool            ip_forward_was_enabled;
+    FwBackend       fw_backend;     /* NAT rules installed with, AUTO = none */
+    ConnLimitSaved  connlimit_saved; /* caps table + conntrack sysctls to undo */
+    ProcSchedSaved  self_sched;     /* main loop settings before boost */
+    ProcSchedSaved  hostapd_sched;  /* daemon settings before boost */
+    ProcSchedSaved  dnsmasq_sched;
+    char            notice[MAX_CMD_LEN];  /* non-fatal start warning */
+    UplinkSaved     uplink_saved;   /* bridge / proxy-ARP changes to undo */
+    StaTuneSaved    sta_saved;      /* uplink STA bgscan / power save to undo */
+    TxqAqlSaved     aql_saved;      /* AQL limits before tuning */
+    ConfFile        hostapd_conf;
+    ConfFile        dnsmasq_conf;
+    ConfFile        dhcp_opts;      /* DHCP_OPTS_PATH (SIGHUP, no restart) */
+    bool            detached;       /* left running for another process */
+    bool            netns;          /* running isolated (see netns.h) */
 } HotspotStatus;
 
 /* ── Functions ───────────────────────────────────────────────────────── */
@@ -67,6 +144,10 @@ void hotspot_init(HotspotStatus *status);
 /* Set default config values */
 void hotspot_default_config(HotspotConfig *config);
 
+/* "wpa2", "transition" or "sae"; parse returns false on anything else */
+const char *hotspot_security_name(SecurityMode mode);
+bool hotspot_parse_security(const char *name, SecurityMode *mode);
+
 /* Start the hotspot — creates AP interface, launches hostapd + dnsmasq */
 bool hotspot_start(HotspotStatus *status);
 
@@ -79,7 +160,20 @@ void hotspot_refresh_status(HotspotStatus *status);
 /* Get uptime string (e.g., "1h 23m 45s") */
 void hotspot_get_uptime_str(const HotspotStatus *status, char *buf, size_t bufsize);
 
+/*
+ * Adopt a hotspot left running by an earlier process (see state.h).
+ * Returns false with err set if there is none or it no longer checks
+ * out; err is "" when there is simply nothing to adopt.
+ */
+bool hotspot_reattach(HotspotStatus *status, char *err, size_t errsize);
+
+/* Stop managing the hotspot but leave it up for a later reattach */
+void hotspot_detach(HotspotStatus *status);
+
 /* Clean up everything (called on exit/signal) */
 void hotspot_cleanup(HotspotStatus *status);
 
+/* On exit, after the cleanup: stop the persistent hostapd we own */
+void hotspot_shutdown(void);
+
 #endif /* HOTSPOT_H */
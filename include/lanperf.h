@@ -0,0 +1,96 @@
+/*
+ * lanperf.h - Built-in LAN throughput test server for Linux Hotspot Enabler
+ *
+ * Lets hotspot clients measure throughput to the gateway itself, which
+ * separates Wi-Fi link problems from uplink problems.
+ *
+ * Commands are one line on a TCP connection from the AP subnet:
+ *
+ *   "down N\n"      server streams zeros for N seconds (default)
+ *   "up N\n"        server sinks whatever the client sends for N seconds
+ *   "udp M N P\n"   server paces M Mbit/s of numbered datagrams for N s
+ *                   to the client's UDP port P (ends early if the
+ *                   connection is reset), then answers "done <count>\n"
+ */
+
+#ifndef LANPERF_H
+#define LANPERF_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <time.h>
+#include "net_utils.h"
+
+#define LANPERF_DEFAULT_PORT   5201
+#define LANPERF_MAX_TESTS      8
+#define LANPERF_MAX_SECS       60
+
+/* ── Results ─────────────────────────────────────────────────────────── */
+
+typedef enum {
+    LANPERF_TCP_DOWN,
+    LANPERF_TCP_UP,
+    LANPERF_UDP_DOWN
+} LanPerfMode;
+
+typedef struct {
+    char               ip[MAX_IP_LEN];
+    LanPerfMode        mode;
+    unsigned long long bytes;
+    double             secs;
+    double             mbps;
+    time_t             when;
+} LanPerfResult;
+
+/* ── Functions ───────────────────────────────────────────────────────── */
+
+#ifndef HOTSPOT_NO_LANPERF
+
+/*
+ * Start the TCP and UDP listeners on bind_ip:port. The address does not
+ * need to exist yet (the AP gateway appears when the hotspot starts).
+ */
+bool lanperf_start(const char *bind_ip, int port, int max_tests,
+                   char *err, size_t errsize);
+
+/* Latest result for a client IP. Returns false if it never ran a test */
+bool lanperf_get_result(const char *ip, LanPerfResult *out);
+
+/* Short label such as "down" for a mode */
+const char *lanperf_mode_name(LanPerfMode mode);
+
+/* Stop listeners and wait for running tests to end */
+void lanperf_stop(void);
+
+/*
+ * "lanperf-serve IP [PORT] [SECONDS]": run the server on its own and
+ * print each result as it lands, for benchmarks in network namespaces.
+ * SECONDS 0 (default) runs until killed. Returns a process exit status.
+ */
+int lanperf_serve(int argc, char **argv);
+
+#else   /* built with WITH_LANPERF=0 */
+
+#include <stdio.h>
+
+static inline bool lanperf_start(const char *bind_ip, int port, int max_tests,
+                                 char *err, size_t errsize)
+{
+    snprintf(err, errsize, "not included in this build (WITH_LANPERF=0)");
+    return false;
+}
+static inline bool lanperf_get_result(const char *ip, LanPerfResult *out)
+{
+    return false;
+}
+static inline const char *lanperf_mode_name(LanPerfMode mode) { return ""; }
+static inline void lanperf_stop(void) { }
+static inline int lanperf_serve(int argc, char **argv)
+{
+    fprintf(stderr, "lanperf-serve: not included in this build (WITH_LANPERF=0)\n");
+    return 1;
+}
+
+#endif /* HOTSPOT_NO_LANPERF */
+
+#endif /* LANPERF_H */
@@ -9,6 +9,8 @@
 #define NET_UTILS_H
 
 #include <stdbool.h>
+#include <stddef.h>
+#include <time.h>
 
 #define MAX_IFACE_NAME    32
 #define MAX_SSID_LEN      64
@@ -48,8 +50,19 @@ typedef struct {
     char mac[MAX_MAC_LEN];
     char ip[MAX_IP_LEN];
     char hostname[MAX_SSID_LEN];
+    bool limited;           /* hit a per-client connection cap recently */
 } ConnectedClient;
 
+/* ── Channel Flags (from wiphy data) ─────────────────────────────────── */
+
+typedef struct {
+    bool found;         /* channel is listed for this phy */
+    int  freq_mhz;
+    bool disabled;      /* not allowed in the current regulatory domain */
+    bool no_ir;         /* may not initiate radiation (no beaconing) */
+    bool radar;         /* DFS channel: radar detection required */
+} ChannelFlags;
+
 /* ── Distro Info ─────────────────────────────────────────────────────── */
 
 typedef enum {
@@ -90,11 +103,22 @@ bool net_check_ap_support(const char *phy);
 /* Get the phy device name for an interface */
 bool net_get_phy_name(const char *iface, char *phy, size_t physize);
 
+/* Read regulatory flags of a channel from "iw phy <phy> info" */
+bool net_get_channel_flags(const char *phy, int channel, ChannelFlags *flags);
+
 /* Get the current channel of the WiFi interface */
 int net_get_current_channel(const char *iface);
 
-/* Get connected clients from DHCP leases */
-int net_get_connected_clients(ConnectedClient *clients, int max_clients);
+/*
+ * Get connected clients from DHCP leases granted or renewed at or after
+ * since (leases outlive a hotspot stop; a returning client renews)
+ */
+int net_get_connected_clients(ConnectedClient *clients, int max_clients,
+                              time_t since);
+
+/* Parse a dnsmasq lease file (used by the above and the benchmark) */
+int net_parse_lease_file(const char *path, ConnectedClient *clients,
+                         int max_clients);
 
 /* Execute a command and capture output */
 bool net_exec_cmd(const char *cmd, char *output, size_t output_size);
@@ -102,4 +126,7 @@ bool net_exec_cmd(const char *cmd, char *output, size_t output_size);
 /* Execute a command silently (no output capture) */
 int net_exec_silent(const char *cmd);
 
+/* Escape a string for use inside a JSON string literal */
+void net_json_escape(char *dst, size_t dstsize, const char *src);
+
 #endif /* NET_UTILS_H */
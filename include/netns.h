@@ -0,0 +1,47 @@
+/*
+ * netns.h - Network namespace isolation for Linux Hotspot Enabler
+ *
+ * With "isolation = netns" the dedicated AP radio (ap_phy) is moved
+ * into a private namespace, where ap0, hostapd and dnsmasq live. Host
+ * network managers never see the AP interface, so the NetworkManager /
+ * connman / wpa_supplicant hand-off and its waits are skipped. A veth
+ * pair links the namespace to the host: the namespace routes the AP
+ * subnet over it, and the host NATs it out of the uplink as usual.
+ *
+ *   ap0 ── [ns "hotspot"] hs-veth1 ══ hs-veth0 [host] ── NAT ── uplink
+ *   192.168.12.1/24   10.199.12.2/30   10.199.12.1/30
+ */
+
+#ifndef NETNS_H
+#define NETNS_H
+
+#include <stdbool.h>
+#include <stddef.h>
+
+#define NETNS_NAME        "hotspot"
+#define NETNS_EXEC        "ip netns exec " NETNS_NAME " "
+#define NETNS_VETH_HOST   "hs-veth0"
+#define NETNS_VETH_NS     "hs-veth1"
+#define NETNS_HOST_ADDR   "10.199.12.1"
+#define NETNS_NS_ADDR     "10.199.12.2"
+
+/* ── Functions ───────────────────────────────────────────────────────── */
+
+/*
+ * Create the namespace, move phy into it and wire the veth pair and
+ * routes for ap_subnet ("a.b.c.0/24"). Anything left by an earlier run
+ * is removed first. Returns false with err set; nothing is left behind.
+ */
+bool netns_setup(const char *phy, const char *ap_subnet,
+                 char *err, size_t errsize);
+
+/* Give phy back to the host and delete the veth pair and namespace */
+void netns_teardown(const char *phy);
+
+/* Namespace and host-side veth exist */
+bool netns_present(void);
+
+/* Interface exists inside the namespace */
+bool netns_has_iface(const char *iface);
+
+#endif /* NETNS_H */
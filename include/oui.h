@@ -0,0 +1,34 @@
+/*
+ * oui.h - Embedded MAC vendor lookup for Linux Hotspot Enabler
+ *
+ * The table is generated at build time by tools/oui-gen.awk from the
+ * IEEE MA-L list (OUI_SRC in the Makefile; data/oui-seed.txt when the
+ * system has no copy) and compiled in: sorted 24-bit prefixes with a
+ * 16-bit index into a pool of distinct vendor names. A lookup is a
+ * binary search over read-only data; nothing is read at run time.
+ */
+
+#ifndef OUI_H
+#define OUI_H
+
+#include <stdint.h>
+
+#define OUI_RANDOMIZED  "(randomized)"
+
+/* Generated table (build/oui_table.c) */
+extern const uint32_t oui_entries;
+extern const uint32_t oui_prefix[];
+extern const uint16_t oui_name_index[];
+extern const uint32_t oui_name_offset[];
+extern const char     oui_names[];
+
+/* ── Functions ───────────────────────────────────────────────────────── */
+
+/*
+ * Vendor for "aa:bb:cc:dd:ee:ff" (any separator or none). Locally
+ * administered addresses -- what phones use for private WiFi
+ * addresses -- give OUI_RANDOMIZED. Returns "" when not listed.
+ */
+const char *oui_vendor(const char *mac);
+
+#endif /* OUI_H */
@@ -0,0 +1,74 @@
+/*
+ * procsched.h - Scheduling priority and CPU placement for Linux Hotspot Enabler
+ *
+ * Optionally boosts hostapd, dnsmasq and the main loop so beaconing and
+ * EAPOL handling keep up when the host is busy, and restores their
+ * original settings when the hotspot stops (the daemons may outlive it).
+ */
+
+#ifndef PROCSCHED_H
+#define PROCSCHED_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <sched.h>
+#include <sys/types.h>
+
+#define PROCSCHED_CPUS_LEN  64
+
+/* ── Settings ────────────────────────────────────────────────────────── */
+
+typedef enum {
+    PROCSCHED_OFF,      /* leave the scheduler alone (default) */
+    PROCSCHED_NICE,     /* negative nice + best-effort I/O priority 0 */
+    PROCSCHED_FIFO      /* SCHED_FIFO at a low real-time priority */
+} ProcSchedMode;
+
+typedef struct {
+    ProcSchedMode mode;
+    int           rt_priority;              /* 1-99, for PROCSCHED_FIFO */
+    int           nice;                     /* -20..0, for PROCSCHED_NICE */
+    char          cpus[PROCSCHED_CPUS_LEN]; /* "0,2-3"; "" = any CPU */
+} ProcSchedConfig;
+
+/* Original settings of a process, captured before boosting it */
+typedef struct {
+    bool               saved;
+    int                policy;
+    struct sched_param param;
+    int                nice;
+    int                ioprio;
+    bool               has_affinity;
+    cpu_set_t          cpus;
+} ProcSchedSaved;
+
+/* ── Functions ───────────────────────────────────────────────────────── */
+
+/* Defaults: off, FIFO priority 10, nice -10, any CPU */
+void procsched_default(ProcSchedConfig *cfg);
+
+/* Parse "off", "nice" or "fifo" */
+bool procsched_parse_mode(const char *value, ProcSchedMode *mode);
+
+/* Parse a CPU list like "0,2-3" into a set. Returns false if invalid */
+bool procsched_parse_cpus(const char *spec, cpu_set_t *set);
+
+/*
+ * Apply cfg to pid (0 = the calling thread). When save is non-NULL the
+ * previous settings are stored there first. Returns false and fills
+ * err if any part could not be applied.
+ */
+bool procsched_apply(pid_t pid, const ProcSchedConfig *cfg,
+                     ProcSchedSaved *save, char *err, size_t errsize);
+
+/* Put back settings captured by procsched_apply */
+void procsched_restore(pid_t pid, ProcSchedSaved *save);
+
+/*
+ * What a daemon we spawn starts with: SCHED_OTHER, nice 0, no I/O
+ * class, any CPU. For a process adopted already boosted, whose own
+ * settings from before are lost.
+ */
+void procsched_saved_default(ProcSchedSaved *save);
+
+#endif /* PROCSCHED_H */
@@ -0,0 +1,106 @@
+/*
+ * recorder.h - Flight recorder for Linux Hotspot Enabler
+ *
+ * A thread samples the uplink STA (signal, bitrate, channel, link), the
+ * AP station count, both interfaces' counters and daemon liveness at
+ * REC_HZ into a fixed ring of REC_SAMPLES binary records, along with the
+ * RTT of an ICMP probe to the uplink gateway sent once a second. When something goes wrong -- hostapd or
+ * dnsmasq dies, the uplink drops, the probe spikes or keeps getting
+ * lost -- it records REC_POST_SAMPLES more and dumps the whole window
+ * to REC_DUMP_DIR. A dump can also be asked for at any time.
+ *
+ *   hotspot-enabler decode <dump>   renders a dump as CSV
+ */
+
+#ifndef RECORDER_H
+#define RECORDER_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <sys/types.h>
+#include "net_utils.h"
+
+#define REC_HZ              10
+#define REC_SAMPLES         (60 * REC_HZ)   /* one minute of history */
+#define REC_POST_SAMPLES    (3 * REC_HZ)    /* kept after a trigger */
+#define REC_COOLDOWN_SECS   30              /* between automatic dumps */
+#define REC_PROBE_EVERY     REC_HZ          /* ticks between probes */
+#define REC_LOST_TRIGGER    5               /* probes lost in a row */
+#define REC_DUMP_DIR        "/var/log/hotspot-enabler"
+#define REC_MAGIC           "HSFR"
+#define REC_VERSION         1
+
+/* ── Records (dump file layout, native byte order) ───────────────────── */
+
+enum {
+    REC_F_LINK       = 1 << 0,  /* uplink STA associated */
+    REC_F_HOSTAPD    = 1 << 1,  /* hostapd alive */
+    REC_F_DNSMASQ    = 1 << 2,  /* dnsmasq alive (or not used) */
+    REC_F_PROBE_LOST = 1 << 3,  /* a probe timed out this tick */
+    REC_F_TRIGGER    = 1 << 4   /* the sample that triggered the dump */
+};
+
+typedef struct {
+    uint64_t t_ms;              /* wall clock, ms since the epoch */
+    uint64_t ap_rx_bytes;
+    uint64_t ap_tx_bytes;
+    uint64_t sta_rx_bytes;
+    uint64_t sta_tx_bytes;
+    uint32_t ap_rx_packets;
+    uint32_t ap_tx_packets;
+    uint32_t ap_drops;          /* rx + tx dropped */
+    uint32_t sta_drops;
+    uint32_t sta_bitrate_kbps;  /* 0 = unknown */
+    int32_t  rtt_us;            /* probe reply this tick, -1 = none */
+    int16_t  sta_signal_dbm;    /* 0 = unknown */
+    uint16_t sta_channel;
+    uint16_t ap_stations;
+    uint16_t flags;             /* REC_F_* */
+} RecSample;
+
+typedef struct {
+    char     magic[4];          /* REC_MAGIC */
+    uint16_t version;
+    uint16_t sample_size;       /* sizeof(RecSample) when written */
+    uint32_t count;
+    uint32_t hz;
+    char     reason[64];
+    char     ap_iface[16];
+    char     sta_iface[16];
+} RecHeader;
+
+/* ── Runtime ─────────────────────────────────────────────────────────── */
+
+typedef struct {
+    bool enabled;
+    int  spike_ms;              /* probe RTT that triggers a dump */
+} RecConfig;
+
+/* Defaults: on, 250 ms spike threshold */
+void recorder_default(RecConfig *cfg);
+
+/*
+ * Start sampling. Fails only if the sampler itself cannot run; a missing
+ * raw ICMP socket leaves the RTT column empty and is reported through
+ * recorder_next_event().
+ */
+bool recorder_start(const RecConfig *cfg, const char *ap_iface,
+                    const char *sta_iface, const char *phy,
+                    pid_t hostapd_pid, pid_t dnsmasq_pid,
+                    char *err, size_t errsize);
+void recorder_stop(void);
+
+/* Station count from the last status refresh (used without debugfs) */
+void recorder_note_clients(int count);
+
+/* Ask for a dump of the current window. Async-signal-safe */
+void recorder_request_dump(void);
+
+/* Pop the next "dumped to ..." message for the log. False when empty */
+bool recorder_next_event(char *msg, size_t msgsize);
+
+/* Print a dump as CSV on stdout. Returns a process exit status */
+int recorder_decode(const char *path);
+
+#endif /* RECORDER_H */
@@ -0,0 +1,27 @@
+/*
+ * sha256.h - SHA-256 and HMAC-SHA-256 for Linux Hotspot Enabler
+ *
+ * Self-contained (FIPS 180-4, RFC 2104), so authenticating the short
+ * coordination announcements needs no crypto library.
+ */
+
+#ifndef SHA256_H
+#define SHA256_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#define SHA256_LEN  32
+
+/* Digest of a buffer */
+void sha256(const void *data, size_t len, uint8_t out[SHA256_LEN]);
+
+/* HMAC-SHA-256 of msg under key (any key length) */
+void sha256_hmac(const void *key, size_t keylen, const void *msg, size_t len,
+                 uint8_t out[SHA256_LEN]);
+
+/* Compare two digests without stopping at the first difference */
+bool sha256_equal(const uint8_t a[SHA256_LEN], const uint8_t b[SHA256_LEN]);
+
+#endif /* SHA256_H */
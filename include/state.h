@@ -0,0 +1,38 @@
+/*
+ * state.h - Persisted runtime state for Linux Hotspot Enabler
+ *
+ * While the hotspot runs, everything needed to adopt it from another
+ * process (daemon pids, interfaces, channel, uplink changes to undo)
+ * is kept in HOTSPOT_STATE_PATH. A new process -- after a detach, an
+ * upgrade or a UI crash -- loads it, checks that hostapd, dnsmasq, the
+ * AP interface and the forwarding setup are really still there, and
+ * takes over without restarting anything.
+ */
+
+#ifndef STATE_H
+#define STATE_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include "hotspot.h"
+
+#define HOTSPOT_STATE_PATH  HOTSPOT_RUN_DIR "/state"
+#define STATE_VERSION       1
+
+/*
+ * Write the state of a running hotspot. owned = this process manages
+ * it (false when detaching). Only written when the content changed.
+ */
+bool state_save(const HotspotStatus *status, bool owned);
+
+/*
+ * Load HOTSPOT_STATE_PATH into status (runtime fields and the settings
+ * the daemons were started with) and verify it against the system.
+ * Returns false with err set if there is nothing usable to adopt;
+ * err is "" when there simply is no state file.
+ */
+bool state_load(HotspotStatus *status, char *err, size_t errsize);
+
+void state_remove(void);
+
+#endif /* STATE_H */
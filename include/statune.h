@@ -0,0 +1,46 @@
+/*
+ * statune.h - Uplink STA radio tuning for Linux Hotspot Enabler
+ *
+ * With AP and STA sharing one radio, every background scan of the
+ * client side takes the radio off-channel, and the AP stops beaconing
+ * and forwarding until it comes back. STA power save adds wake-up delay
+ * on the uplink. While the hotspot runs, bgscan of the connected network
+ * is switched off through the wpa_supplicant control socket and power
+ * save through nl80211 (iw); both are put back on stop.
+ */
+
+#ifndef STATUNE_H
+#define STATUNE_H
+
+#include <stdbool.h>
+#include <stddef.h>
+
+#define STATUNE_BGSCAN_LEN  128
+
+/* What was changed, and the values to put back */
+typedef struct {
+    int  network_id;                    /* supplicant network, -1 = bgscan untouched */
+    char bgscan[STATUNE_BGSCAN_LEN];    /* previous value as quoted by wpa_cli */
+    int  power_save;                    /* previous: 1 on, 0 off, -1 untouched */
+} StaTuneSaved;
+
+/* ── Functions ───────────────────────────────────────────────────────── */
+
+/* Mark everything untouched */
+void statune_init(StaTuneSaved *saved);
+
+/*
+ * Switch off power save on iface, and bgscan as well when the AP shares
+ * its radio. Previous values go to saved. Returns false with err set if
+ * a part could not be applied; whatever did apply is still recorded.
+ */
+bool statune_apply(const char *iface, bool shared_radio, StaTuneSaved *saved,
+                   char *err, size_t errsize);
+
+/* Put back what statune_apply changed */
+void statune_restore(const char *iface, StaTuneSaved *saved);
+
+/* "bgscan off, power save off" or "" if nothing was changed */
+void statune_describe(const StaTuneSaved *saved, char *buf, size_t size);
+
+#endif /* STATUNE_H */
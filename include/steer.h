@@ -0,0 +1,96 @@
+/*
+ * steer.h - 2.4 → 5 GHz band steering for Linux Hotspot Enabler
+ *
+ * When the hotspot runs on 2.4 GHz and another AP with the same SSID
+ * runs on 5 GHz (a second radio, or a second instance of this tool),
+ * clients that support 802.11v and 5 GHz are asked to move there with
+ * a BSS Transition Management request sent through hostapd.
+ */
+
+#ifndef STEER_H
+#define STEER_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <time.h>
+#include "net_utils.h"
+
+#define STEER_POLL_SECS       2
+#define STEER_SAMPLES         3     /* strong samples in a row before a request */
+#define STEER_VERDICT_SECS    10    /* client must leave within this to count */
+#define STEER_MAX_EVENTS      32
+#define STEER_STA_BYTES       (256 * 1024)   /* all_sta output: ~1 KB x 255 stations */
+
+/* ── Config ──────────────────────────────────────────────────────────── */
+
+typedef struct {
+    bool enabled;
+    char peer_bssid[MAX_MAC_LEN];   /* BSS on the other band */
+    int  peer_channel;
+    int  min_signal;                /* dBm; steer above min + hysteresis */
+    int  hysteresis;                /* dB */
+    int  cooldown_s;                /* between attempts for one client */
+    int  max_attempts;              /* then leave the client alone */
+} SteerConfig;
+
+/* ── Per-client state ────────────────────────────────────────────────── */
+
+typedef enum {
+    STEER_IDLE,         /* not a candidate (yet) */
+    STEER_PENDING,      /* request sent, waiting for the client to leave */
+    STEER_MOVED,        /* left within STEER_VERDICT_SECS */
+    STEER_IGNORED,      /* stayed; retried after the cooldown */
+    STEER_GAVE_UP       /* max_attempts reached */
+} SteerState;
+
+typedef struct {
+    char       mac[MAX_MAC_LEN];
+    int        signal_dbm;      /* 0 = unknown */
+    bool       btm;             /* advertises BSS Transition support */
+    bool       dual_band;       /* lists a 5 GHz operating class */
+    bool       present;         /* associated to this AP right now */
+    int        strong_samples;
+    int        attempts;
+    SteerState state;
+    time_t     last_request;
+} SteerClient;
+
+typedef struct {
+    int           tracked;
+    int           capable;      /* btm && dual_band, currently associated */
+    unsigned long requests;
+    unsigned long moved;
+    unsigned long ignored;      /* stayed, or hostapd refused the request */
+} SteerStats;
+
+/* ── Functions ───────────────────────────────────────────────────────── */
+
+/* Defaults: off, steer above -65 dBm + 5 dB, 120 s cooldown, 3 attempts */
+void steer_default(SteerConfig *cfg);
+
+/* 5 GHz operating class (global, Table E-4) for a channel; 0 if unknown */
+int steer_op_class(int channel);
+
+/*
+ * Start polling hostapd on ap_iface. Fails (with err) if the AP is not
+ * on 2.4 GHz or the peer is not a 5 GHz BSS.
+ */
+bool steer_start(const SteerConfig *cfg, const char *ap_iface, int ap_channel,
+                 char *err, size_t errsize);
+
+/* Pop the next outcome message for the log. Returns false when empty */
+bool steer_next_event(char *msg, size_t msgsize);
+
+void steer_get_stats(SteerStats *stats);
+
+/* Stop the polling thread and forget all clients */
+void steer_stop(void);
+
+/*
+ * "steer-sim IFACE PEER_BSSID PEER_CHANNEL [SECONDS]": steer the clients
+ * of a hostapd already running on IFACE and print the outcomes, for
+ * testing on mac80211_hwsim radios. Returns a process exit status.
+ */
+int steer_simulate(int argc, char **argv);
+
+#endif /* STEER_H */
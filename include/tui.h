@@ -1,8 +1,8 @@
 /*
  * tui.h - Terminal User Interface for Linux Hotspot Enabler
  *
- * Responsive ncurses-based TUI with dashboard, config, clients,
- * and log screens with keyboard navigation.
+ * Responsive ncurses-based TUI with dashboard, config, clients, log
+ * and queue screens with keyboard navigation.
  */
 
 #ifndef TUI_H
@@ -42,6 +42,7 @@ typedef enum {
     SCREEN_CONFIG,
     SCREEN_CLIENTS,
     SCREEN_LOG,
+    SCREEN_QUEUES,
     SCREEN_COUNT
 } TuiScreen;
 
@@ -54,6 +55,7 @@ typedef enum {
     CFG_BAND_INFO,       /* Read-only: auto-detected from client channel */
     CFG_MAX_CLIENTS,
     CFG_HIDDEN,
+    CFG_SECURITY,
     CFG_FIELD_COUNT
 } ConfigField;
 
@@ -88,6 +90,10 @@ typedef struct {
     int            log_count;
     int            log_scroll;
     int            client_scroll;
+    TxqSnapshot    txq;             /* Queues screen, read while it is shown */
+    TxqSnapshot    txq_prev;        /* previous read, for airtime rates */
+    double         txq_interval;    /* seconds between the two */
+    time_t         txq_time;
 } TuiState;
 
 /* ── Functions ───────────────────────────────────────────────────────── */
@@ -95,6 +101,13 @@ typedef struct {
 /* Initialize ncurses and the TUI state */
 void tui_init(TuiState *tui, HotspotStatus *hs_status);
 
+/*
+ * Set up the TUI on an arbitrary terminal stream instead of the real
+ * terminal (used by the benchmark to render to /dev/null)
+ */
+bool tui_init_offscreen(TuiState *tui, HotspotStatus *hs_status,
+                        FILE *out, FILE *in, int rows, int cols);
+
 /* Main event loop — blocks until user quits */
 void tui_run(TuiState *tui);
 
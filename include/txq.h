@@ -0,0 +1,84 @@
+/*
+ * txq.h - mac80211 TXQ / AQL statistics and tuning for Linux Hotspot Enabler
+ *
+ * Latency under load on WiFi is mostly queueing in mac80211, the driver
+ * and the firmware. mac80211 keeps per-station TXQs (fq_codel) and
+ * limits how much airtime may sit in the lower queues (Airtime Queue
+ * Limits, AQL). Both are exposed in debugfs:
+ *
+ *   ieee80211/<phy>/aql_txq_limit              per-AC low/high limit (us)
+ *   ieee80211/<phy>/aql_pending                airtime queued below mac80211
+ *   ieee80211/<phy>/netdev:<if>/stations/<mac>/aqm       TXQ backlog, drops
+ *   ieee80211/<phy>/netdev:<if>/stations/<mac>/airtime   RX/TX airtime
+ *
+ * Without debugfs (not mounted, or a kernel without MAC80211_DEBUGFS)
+ * snapshots come back unavailable with the reason, and tuning fails.
+ */
+
+#ifndef TXQ_H
+#define TXQ_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include "net_utils.h"
+
+#define TXQ_DEBUGFS_ROOT  "/sys/kernel/debug/ieee80211"
+#define TXQ_NUM_AC        4         /* VO, VI, BE, BK */
+
+/* ── Statistics ──────────────────────────────────────────────────────── */
+
+typedef struct {
+    char          mac[MAX_MAC_LEN];
+    unsigned long backlog_bytes;    /* summed over the station's TIDs */
+    unsigned long backlog_packets;
+    unsigned long drops;
+    unsigned long marks;            /* ECN */
+    unsigned long tx_packets;
+    unsigned long airtime_tx_us;
+    unsigned long airtime_rx_us;
+} TxqStation;
+
+typedef struct {
+    bool          available;
+    char          why[MAX_LINE_LEN];        /* set when !available */
+    bool          have_limits;
+    int           limit_low[TXQ_NUM_AC];    /* AQL per AC, us */
+    int           limit_high[TXQ_NUM_AC];
+    long          pending_us;               /* below mac80211, -1 = unknown */
+    int           count;
+    TxqStation    stations[MAX_CLIENTS];
+} TxqSnapshot;
+
+/* ── Tuning ──────────────────────────────────────────────────────────── */
+
+typedef struct {
+    int low;        /* us; 0 = leave AQL alone */
+    int high;
+} TxqAqlConfig;
+
+/* Limits in place before tuning */
+typedef struct {
+    bool saved;
+    int  low[TXQ_NUM_AC];
+    int  high[TXQ_NUM_AC];
+} TxqAqlSaved;
+
+/* ── Functions ───────────────────────────────────────────────────────── */
+
+const char *txq_ac_name(int ac);
+
+/* Read the phy's AQL state and the stations of iface into snap */
+bool txq_read(const char *phy, const char *iface, TxqSnapshot *snap);
+
+/*
+ * Set every AC of phy to cfg's low/high limits, saving the previous
+ * ones. Returns false with err set if debugfs is missing or a write
+ * was refused.
+ */
+bool txq_aql_apply(const char *phy, const TxqAqlConfig *cfg,
+                   TxqAqlSaved *saved, char *err, size_t errsize);
+
+/* Put back limits saved by txq_aql_apply */
+void txq_aql_restore(const char *phy, TxqAqlSaved *saved);
+
+#endif /* TXQ_H */
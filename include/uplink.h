@@ -0,0 +1,98 @@
+/*
+ * uplink.h - How hotspot clients reach the uplink network
+ *
+ *   nat       Clients get 192.168.12.0/24 and are masqueraded (default)
+ *   bridge    AP joins a Linux bridge with an Ethernet uplink; clients are
+ *             on the upstream LAN and use its DHCP server
+ *   proxyarp  For a WiFi uplink, where a STA cannot be bridged: the host
+ *             answers ARP on both sides, routes each client as a /32 and
+ *             relays DHCP to the upstream server (parprouted style)
+ *
+ * The last two keep clients on the upstream LAN (printers, casting) and
+ * skip masquerade; connection tracking is skipped where the kernel
+ * allows it.
+ */
+
+#ifndef UPLINK_H
+#define UPLINK_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include "net_utils.h"
+
+#define UPLINK_DEFAULT_BRIDGE  "br-hotspot"
+#define UPLINK_MAX_ADDRS       8
+
+/* ── Config ──────────────────────────────────────────────────────────── */
+
+typedef enum {
+    UPLINK_NAT,
+    UPLINK_BRIDGE,
+    UPLINK_PROXYARP
+} UplinkMode;
+
+typedef struct {
+    UplinkMode mode;
+    char bridge[MAX_IFACE_NAME];        /* bridge mode: bridge to join */
+    char bridge_port[MAX_IFACE_NAME];   /* Ethernet port to build it from */
+    char dhcp_server[MAX_IP_LEN];       /* proxyarp relay target, "" = gateway */
+} UplinkConfig;
+
+/* What setup changed, so stop can put it back */
+typedef struct {
+    bool created_bridge;
+    char moved_addrs[UPLINK_MAX_ADDRS][MAX_IP_LEN + 4];   /* "a.b.c.d/nn" */
+    int  moved_count;
+    char moved_gateway[MAX_IP_LEN];
+    int  bridge_nf_call;        /* saved bridge-nf-call-iptables (host-wide), -1 = n/a */
+    int  sta_proxy_arp;         /* saved proxy_arp on the uplink, -1 = n/a */
+    char ap_addr[MAX_IP_LEN];   /* /32 put on the AP in proxyarp mode */
+    char routes[MAX_CLIENTS][MAX_IP_LEN];   /* per-client /32 routes */
+    int  route_count;
+} UplinkSaved;
+
+/* ── Functions ───────────────────────────────────────────────────────── */
+
+void uplink_default(UplinkConfig *cfg);
+bool uplink_parse_mode(const char *value, UplinkMode *mode);
+const char *uplink_mode_name(UplinkMode mode);
+
+/*
+ * Bridge mode, before hostapd starts: make sure cfg->bridge exists. If
+ * it does not and bridge_port is set, create it, enslave the port and
+ * move the port's addresses and default route onto the bridge. Also
+ * turns net.bridge.bridge-nf-call-iptables off for every bridge on the
+ * host until uplink_stop().
+ */
+bool uplink_prepare_bridge(const UplinkConfig *cfg, UplinkSaved *save,
+                           char *err, size_t errsize);
+
+/*
+ * Proxy-ARP mode, after hostapd starts: borrow the uplink address as a
+ * /32 on the AP, enable proxy_arp on both sides and exempt client
+ * traffic from connection tracking. IP forwarding is the caller's job.
+ */
+bool uplink_start_proxyarp(const char *ap_iface, const char *sta_iface,
+                           const char *sta_ip, UplinkSaved *save,
+                           char *err, size_t errsize);
+
+/*
+ * Where proxyarp mode relays DHCP: cfg->dhcp_server, else the default
+ * gateway on sta_iface. out is "" if neither is known.
+ */
+void uplink_dhcp_server(const UplinkConfig *cfg, const char *sta_iface,
+                        char *out, size_t outsize);
+
+/*
+ * Client list for bridge/proxyarp modes (no local lease file). In
+ * proxyarp mode this also keeps one /32 route per client in sync.
+ */
+int uplink_get_clients(const UplinkConfig *cfg, const char *ap_iface,
+                       UplinkSaved *save, ConnectedClient *clients,
+                       int max_clients);
+
+/* Undo whatever setup did (safe to call in any mode, or twice) */
+void uplink_stop(const UplinkConfig *cfg, const char *ap_iface,
+                 const char *sta_iface, UplinkSaved *save);
+
+#endif /* UPLINK_H */
@@ -0,0 +1,61 @@
+/*
+ * web.h - Local HTTP status dashboard for Linux Hotspot Enabler
+ *
+ * Optional embedded HTTP server bound to loopback or the AP gateway.
+ * Serves a static dashboard page, a JSON snapshot at /status and a
+ * Server-Sent Events stream of status deltas at /events.
+ */
+
+#ifndef WEB_H
+#define WEB_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include "hotspot.h"
+
+#define WEB_MAX_VIEWERS_LIMIT  64
+
+/* ── Functions ───────────────────────────────────────────────────────── */
+
+#ifndef HOTSPOT_NO_WEB
+
+/*
+ * Start the server thread on "addr:port". Only 127.0.0.1, localhost
+ * and AP_GATEWAY are accepted. Returns false and fills err on failure.
+ */
+bool web_start(const char *listen_spec, int max_viewers,
+               char *err, size_t errsize);
+
+/*
+ * Publish the current status. Called from the main loop; returns
+ * immediately unless a viewer is connected or a request is waiting.
+ */
+void web_publish(const HotspotStatus *status);
+
+/* Number of connected /events viewers */
+int web_viewer_count(void);
+
+/* Stop the server thread and close all connections */
+void web_stop(void);
+
+/* Full status snapshot as served by /status (malloc'd, caller frees) */
+char *web_status_json(const HotspotStatus *status);
+
+#else   /* built with WITH_WEB=0 */
+
+#include <stdio.h>
+
+static inline bool web_start(const char *listen_spec, int max_viewers,
+                             char *err, size_t errsize)
+{
+    snprintf(err, errsize, "not included in this build (WITH_WEB=0)");
+    return false;
+}
+static inline void web_publish(const HotspotStatus *status) { }
+static inline int  web_viewer_count(void) { return 0; }
+static inline void web_stop(void) { }
+static inline char *web_status_json(const HotspotStatus *status) { return NULL; }
+
+#endif /* HOTSPOT_NO_WEB */
+
+#endif /* WEB_H */
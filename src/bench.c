@@ -0,0 +1,258 @@
+/*
+ * bench.c - Built-in benchmark for Linux Hotspot Enabler
+ *
+ * Times use CLOCK_PROCESS_CPUTIME_ID, so the numbers are CPU cost per
+ * operation and do not depend on what else the machine is doing. The
+ * TUI is rendered through a real ncurses screen whose output goes to
+ * /dev/null, cycling through every screen like a scripted session.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "bench.h"
+#include "fileio.h"
+#include "hotspot.h"
+#include "web.h"
+#ifndef HOTSPOT_NO_TUI
+#include "tui.h"
+#endif
+
+#define BENCH_CLIENTS  48
+#define BENCH_ROWS     40
+#define BENCH_COLS     120
+
+/* ── Helpers ─────────────────────────────────────────────────────────── */
+
+static double cpu_us(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &ts);
+    return ts.tv_sec * 1e6 + ts.tv_nsec / 1e3;
+}
+
+/* Synthetic dnsmasq lease file; every fifth client has no hostname */
+static bool write_leases(char *path, size_t pathsize)
+{
+    snprintf(path, pathsize, "/tmp/hotspot-bench-XXXXXX");
+    int fd = mkstemp(path);
+    if (fd < 0) return false;
+
+    FILE *fp = fdopen(fd, "w");
+    if (!fp) {
+        close(fd);
+        unlink(path);
+        return false;
+    }
+
+    long expiry = (long)time(NULL) + 3600;
+    for (int i = 0; i < BENCH_CLIENTS; i++) {
+        char host[32];
+        if (i % 5 == 4) snprintf(host, sizeof(host), "*");
+        else            snprintf(host, sizeof(host), "client-device-%02d", i);
+        fprintf(fp, "%ld 02:1a:2b:3c:%02x:%02x %s.%d %s 01:02:1a:2b:3c:%02x:%02x\n",
+                expiry, i / 256, i % 256, AP_SUBNET, 10 + i, host,
+                i / 256, i % 256);
+    }
+    fclose(fp);
+    return true;
+}
+
+static void fill_status(HotspotStatus *st)
+{
+    hotspot_init(st);
+    st->state      = HS_STATE_RUNNING;
+    st->start_time = time(NULL) - 3725;
+    snprintf(st->phy, sizeof(st->phy), "phy0");
+
+    WifiInterface *w = &st->wifi;
+    snprintf(w->name, sizeof(w->name), "wlan0");
+    snprintf(w->ssid, sizeof(w->ssid), "Upstream \"Office\" WiFi");
+    snprintf(w->ip,   sizeof(w->ip),   "10.20.30.40");
+    snprintf(w->mac,  sizeof(w->mac),  "00:11:22:33:44:55");
+    w->channel     = 36;
+    w->signal_dbm  = -54;
+    w->connected   = true;
+    w->supports_ap = true;
+}
+
+static double wall_us(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1e6 + ts.tv_nsec / 1e3;
+}
+
+/*
+ * File I/O of one refresh tick (lease file + the registered sysfs MAC
+ * read) and of hotspot_cleanup's temp-file unlinks, on one backend.
+ */
+static void bench_fileio(const char *leases, int iterations, bool uring)
+{
+    static const char *names[] = {
+        "hostapd.conf", "dnsmasq.conf", "leases", "hostapd.log",
+        "dnsmasq.pid", "dnsmasq.log"
+    };
+    enum { NFILES = sizeof(names) / sizeof(names[0]) };
+
+    if (fio_use_uring(uring) != uring) {
+        printf("    %-16s %12s\n", "io_uring", "unavailable");
+        return;
+    }
+
+    static ConnectedClient clients[MAX_CLIENTS];
+    char mac[32];
+    int slot = fio_register("/sys/class/net/lo/address");
+
+    fio_reset_stats();
+    double t0 = cpu_us();
+    for (int i = 0; i < iterations; i++) {
+        net_parse_lease_file(leases, clients, MAX_CLIENTS);
+        FioBatch b;
+        fio_batch_init(&b);
+        fio_add_read_slot(&b, slot, mac, sizeof(mac));
+        fio_submit(&b);
+    }
+    double tick_us = (cpu_us() - t0) / iterations;
+    FioStats st;
+    fio_get_stats(&st);
+    double tick_sys = (double)st.syscalls / iterations;
+    fio_unregister(slot);
+
+    /* Cleanup: create the six files untimed, time the unlink batch */
+    char dir[] = "/tmp/hotspot-bench-io-XXXXXX";
+    double cleanup_us = -1;
+    unsigned long cleanup_sys = 0;
+    if (mkdtemp(dir)) {
+        char paths[NFILES][MAX_PATH_LEN];
+        int rounds = iterations < 200 ? iterations : 200;
+        double total = 0;
+        for (int r = 0; r < rounds; r++) {
+            FioBatch b;
+            fio_batch_init(&b);
+            for (int f = 0; f < NFILES; f++) {
+                snprintf(paths[f], sizeof(paths[f]), "%s/%s", dir, names[f]);
+                fio_add_write(&b, paths[f], "x\n", 2, 0600);
+            }
+            fio_submit(&b);
+
+            fio_batch_init(&b);
+            for (int f = 0; f < NFILES; f++) fio_add_unlink(&b, paths[f]);
+            fio_reset_stats();
+            double w0 = wall_us();
+            fio_submit(&b);
+            total += wall_us() - w0;
+            fio_get_stats(&st);
+            cleanup_sys = st.syscalls;
+        }
+        cleanup_us = total / rounds;
+        rmdir(dir);
+    }
+
+    printf("    %-16s %12.1f %10.2f µs %8lu %10.2f µs\n",
+           uring ? "io_uring" : "plain syscalls", tick_sys, tick_us,
+           cleanup_sys, cleanup_us);
+}
+
+static void print_row(const char *name, double us, const char *note)
+{
+    if (us < 0) printf("  %-18s %10s\n", name, "n/a");
+    else        printf("  %-18s %10.2f µs%s%s\n", name, us, note[0] ? "  " : "", note);
+}
+
+/* ── Benchmark ───────────────────────────────────────────────────────── */
+
+int bench_run(int iterations)
+{
+    if (iterations <= 0) iterations = BENCH_DEFAULT_ITERATIONS;
+
+    char path[MAX_PATH_LEN];
+    if (!write_leases(path, sizeof(path))) {
+        perror("bench: lease file");
+        return 1;
+    }
+
+    static HotspotStatus st;
+    fill_status(&st);
+
+    /* 1. Lease parse (every refresh tick) */
+    double t0 = cpu_us();
+    for (int i = 0; i < iterations; i++)
+        st.client_count = net_parse_lease_file(path, st.clients, MAX_CLIENTS);
+    double parse_us = (cpu_us() - t0) / iterations;
+
+    /* 2. Status snapshot (web_publish with a viewer connected) */
+    double snap_us = -1;
+    char *probe = web_status_json(&st);
+    if (probe) {
+        free(probe);
+        t0 = cpu_us();
+        for (int i = 0; i < iterations; i++) free(web_status_json(&st));
+        snap_us = (cpu_us() - t0) / iterations;
+    }
+
+    /* 3. TUI render, cycling screens and scroll positions */
+    double render_us = -1;
+#ifndef HOTSPOT_NO_TUI
+    FILE *null = fopen("/dev/null", "r+");
+    static TuiState tui;
+    bool have_tui = null && tui_init_offscreen(&tui, &st, null, null,
+                                               BENCH_ROWS, BENCH_COLS);
+    if (have_tui) {
+        for (int i = 0; i < 150; i++)
+            tui_log(&tui, (LogLevel)(i % 4), "Benchmark log line %d", i);
+
+        t0 = cpu_us();
+        for (int i = 0; i < iterations; i++) {
+            tui.current_screen = (TuiScreen)(i % SCREEN_COUNT);
+            tui.client_scroll  = (i / SCREEN_COUNT) % 8;
+            tui.log_scroll     = (i / SCREEN_COUNT) % 32;
+            tui_redraw(&tui);
+        }
+        render_us = (cpu_us() - t0) / iterations;
+        tui.current_screen = SCREEN_DASHBOARD;
+    }
+#endif
+
+    /* 4. One refresh tick of the main loop */
+    t0 = cpu_us();
+    for (int i = 0; i < iterations; i++) {
+        st.client_count = net_parse_lease_file(path, st.clients, MAX_CLIENTS);
+        free(web_status_json(&st));
+#ifndef HOTSPOT_NO_TUI
+        if (have_tui) tui_redraw(&tui);
+#endif
+    }
+    double tick_us = (cpu_us() - t0) / iterations;
+
+#ifndef HOTSPOT_NO_TUI
+    if (have_tui) tui_cleanup(&tui);
+    if (null) fclose(null);
+#endif
+    unlink(path);
+
+    char note[64];
+    snprintf(note, sizeof(note), "(screens cycled, %dx%d)",
+             BENCH_COLS, BENCH_ROWS);
+
+    printf("  Benchmark — %d iterations, %d clients\n\n",
+           iterations, st.client_count);
+    print_row("Lease parse", parse_us, "");
+    print_row("Status snapshot", snap_us, "");
+    print_row("TUI render", render_us, note);
+    print_row("CPU per tick", tick_us, render_us < 0 ? "(parse + snapshot)"
+                                     : "(parse + snapshot + dashboard render)");
+
+    if (write_leases(path, sizeof(path))) {
+        printf("\n  File I/O           syscalls/tick    tick CPU   cleanup syscalls, wall\n");
+        bench_fileio(path, iterations, false);
+        bench_fileio(path, iterations, true);
+        fio_use_uring(true);
+        unlink(path);
+    }
+    printf("\n");
+    return 0;
+}
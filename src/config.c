@@ -0,0 +1,345 @@
+/*
+ * config.c - Configuration file loading for Linux Hotspot Enabler
+ *
+ * Format: one "key = value" per line, lines starting with '#' are
+ * comments.
+ *
+ *   ssid        = LinuxHotspot
+ *   password    = password123
+ *   http_listen = 127.0.0.1:8080
+ *   hook.client_joined = /usr/local/bin/notify-join
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+#include <ctype.h>
+#include <errno.h>
+#include <arpa/inet.h>
+
+#include "config.h"
+
+/* ── Defaults ────────────────────────────────────────────────────────── */
+
+void config_default(AppConfig *app)
+{
+    memset(app, 0, sizeof(AppConfig));
+    app->http_max_viewers  = 4;
+    app->lanperf_port      = LANPERF_DEFAULT_PORT;
+    app->lanperf_max_tests = 2;
+    hooks_registry_default(&app->hooks);
+}
+
+/* ── Helpers ─────────────────────────────────────────────────────────── */
+
+static char *trim(char *s)
+{
+    while (isspace((unsigned char)*s)) s++;
+    char *end = s + strlen(s);
+    while (end > s && isspace((unsigned char)end[-1])) end--;
+    *end = '\0';
+    return s;
+}
+
+static bool parse_bool(const char *value, bool *out)
+{
+    if (strcasecmp(value, "yes") == 0 || strcasecmp(value, "true") == 0 ||
+        strcasecmp(value, "on") == 0  || strcmp(value, "1") == 0) {
+        *out = true;
+        return true;
+    }
+    if (strcasecmp(value, "no") == 0 || strcasecmp(value, "false") == 0 ||
+        strcasecmp(value, "off") == 0 || strcmp(value, "0") == 0) {
+        *out = false;
+        return true;
+    }
+    return false;
+}
+
+static bool parse_int(const char *value, int min, int max, int *out)
+{
+    char *end;
+    long v = strtol(value, &end, 10);
+    if (*value == '\0' || *end != '\0' || v < min || v > max) return false;
+    *out = (int)v;
+    return true;
+}
+
+/*
+ * "hook.<event> = command" registers a hook (repeatable per event),
+ * "hook.<event>.timeout = seconds" overrides the timeout for that event.
+ */
+static bool apply_hook_key(const char *key, const char *value,
+                           HookRegistry *reg)
+{
+    char name[64];
+    snprintf(name, sizeof(name), "%s", key + strlen("hook."));
+
+    char *dot = strchr(name, '.');
+    if (dot) *dot = '\0';
+
+    HookEvent ev;
+    if (!hooks_event_from_name(name, &ev)) return false;
+
+    if (!dot) return hooks_registry_add(reg, ev, value);
+    if (strcmp(dot + 1, "timeout") == 0)
+        return parse_int(value, 1, 3600, &reg->timeout_s[ev]);
+    return false;
+}
+
+/* ── Apply one key ───────────────────────────────────────────────────── */
+
+static bool apply_key(const char *key, const char *value,
+                      HotspotConfig *hs, AppConfig *app)
+{
+    if (strcmp(key, "ssid") == 0) {
+        if (value[0] == '\0' || strlen(value) > 32) return false;
+        snprintf(hs->ssid, sizeof(hs->ssid), "%s", value);
+    }
+    else if (strcmp(key, "password") == 0) {
+        if (strlen(value) < 8 || strlen(value) > 63) return false;
+        snprintf(hs->password, sizeof(hs->password), "%s", value);
+    }
+    else if (strcmp(key, "channel") == 0) {
+        return parse_int(value, 0, 196, &hs->channel);
+    }
+    else if (strcmp(key, "max_clients") == 0) {
+        return parse_int(value, 1, 255, &hs->max_clients);
+    }
+    else if (strcmp(key, "hidden") == 0) {
+        return parse_bool(value, &hs->hidden);
+    }
+    else if (strcmp(key, "security") == 0) {
+        return hotspot_parse_security(value, &hs->security);
+    }
+    else if (strcmp(key, "sae_anti_clogging") == 0) {
+        return parse_int(value, 0, 1000, &hs->sae_anti_clogging);
+    }
+    else if (strcmp(key, "sched_policy") == 0) {
+        return procsched_parse_mode(value, &hs->sched.mode);
+    }
+    else if (strcmp(key, "sched_priority") == 0) {
+        return parse_int(value, 1, 99, &hs->sched.rt_priority);
+    }
+    else if (strcmp(key, "sched_nice") == 0) {
+        return parse_int(value, -20, 0, &hs->sched.nice);
+    }
+    else if (strcmp(key, "sched_cpus") == 0) {
+        cpu_set_t set;
+        if (strlen(value) >= sizeof(hs->sched.cpus) ||
+            !procsched_parse_cpus(value, &set)) return false;
+        snprintf(hs->sched.cpus, sizeof(hs->sched.cpus), "%s", value);
+    }
+    else if (strcmp(key, "ap_phy") == 0) {
+        if (strlen(value) >= sizeof(hs->ap_phy)) return false;
+        snprintf(hs->ap_phy, sizeof(hs->ap_phy), "%s", value);
+    }
+    else if (strcmp(key, "dfs_policy") == 0) {
+        if (strcasecmp(value, "cac") == 0)        hs->dfs_policy = DFS_CAC;
+        else if (strcasecmp(value, "avoid") == 0) hs->dfs_policy = DFS_AVOID;
+        else return false;
+    }
+    else if (strcmp(key, "uplink_mode") == 0) {
+        return uplink_parse_mode(value, &hs->uplink.mode);
+    }
+    else if (strcmp(key, "nat_backend") == 0) {
+        return fw_parse_backend(value, &hs->nat_backend);
+    }
+    else if (strcmp(key, "client_conn_rate") == 0) {
+        return parse_int(value, 0, 100000, &hs->connlimit.rate);
+    }
+    else if (strcmp(key, "client_conn_max") == 0) {
+        return parse_int(value, 0, 1000000, &hs->connlimit.max);
+    }
+    else if (strcmp(key, "bridge") == 0) {
+        if (!value[0] || strlen(value) >= sizeof(hs->uplink.bridge)) return false;
+        snprintf(hs->uplink.bridge, sizeof(hs->uplink.bridge), "%s", value);
+    }
+    else if (strcmp(key, "bridge_port") == 0) {
+        if (strlen(value) >= sizeof(hs->uplink.bridge_port)) return false;
+        snprintf(hs->uplink.bridge_port, sizeof(hs->uplink.bridge_port), "%s", value);
+    }
+    else if (strcmp(key, "dhcp_server") == 0) {
+        struct in_addr addr;
+        if (inet_pton(AF_INET, value, &addr) != 1) return false;
+        snprintf(hs->uplink.dhcp_server, sizeof(hs->uplink.dhcp_server), "%s", value);
+    }
+    else if (strcmp(key, "sta_tune") == 0) {
+        return parse_bool(value, &hs->sta_tune);
+    }
+    else if (strcmp(key, "aql_limit") == 0) {
+        /* "off" or "<low>,<high>" in microseconds of airtime */
+        if (strcasecmp(value, "off") == 0) {
+            hs->aql.low = hs->aql.high = 0;
+            return true;
+        }
+        int low, high;
+        char extra;
+        if (sscanf(value, "%d,%d%c", &low, &high, &extra) != 2 ||
+            low < 500 || high < low || high > 100000) return false;
+        hs->aql.low  = low;
+        hs->aql.high = high;
+    }
+    else if (strcmp(key, "isolation") == 0) {
+        if (strcasecmp(value, "netns") == 0)    hs->netns = true;
+        else if (strcasecmp(value, "off") == 0) hs->netns = false;
+        else return false;
+    }
+    else if (strcmp(key, "recorder") == 0) {
+        return parse_bool(value, &hs->recorder.enabled);
+    }
+    else if (strcmp(key, "recorder_spike_ms") == 0) {
+        return parse_int(value, 20, 10000, &hs->recorder.spike_ms);
+    }
+    else if (strcmp(key, "steer") == 0) {
+        return parse_bool(value, &hs->steer.enabled);
+    }
+    else if (strcmp(key, "steer_peer") == 0) {
+        if (strlen(value) != 17) return false;
+        snprintf(hs->steer.peer_bssid, sizeof(hs->steer.peer_bssid), "%s", value);
+    }
+    else if (strcmp(key, "steer_peer_channel") == 0) {
+        return parse_int(value, 36, 177, &hs->steer.peer_channel) &&
+               steer_op_class(hs->steer.peer_channel) != 0;
+    }
+    else if (strcmp(key, "steer_min_signal") == 0) {
+        return parse_int(value, -90, -30, &hs->steer.min_signal);
+    }
+    else if (strcmp(key, "steer_hysteresis") == 0) {
+        return parse_int(value, 0, 20, &hs->steer.hysteresis);
+    }
+    else if (strcmp(key, "steer_cooldown") == 0) {
+        return parse_int(value, 10, 3600, &hs->steer.cooldown_s);
+    }
+    else if (strcmp(key, "steer_max_attempts") == 0) {
+        return parse_int(value, 1, 10, &hs->steer.max_attempts);
+    }
+    else if (strcmp(key, "coord") == 0) {
+        return parse_bool(value, &hs->coord.enabled);
+    }
+    else if (strcmp(key, "coord_iface") == 0) {
+        if (strlen(value) >= sizeof(hs->coord.iface)) return false;
+        snprintf(hs->coord.iface, sizeof(hs->coord.iface), "%s", value);
+    }
+    else if (strcmp(key, "coord_key") == 0) {
+        if (strlen(value) >= sizeof(hs->coord.key)) return false;
+        snprintf(hs->coord.key, sizeof(hs->coord.key), "%s", value);
+    }
+    else if (strcmp(key, "coord_group") == 0) {
+        struct in_addr addr;
+        if (inet_pton(AF_INET, value, &addr) != 1 ||
+            !IN_MULTICAST(ntohl(addr.s_addr))) return false;
+        snprintf(hs->coord.group, sizeof(hs->coord.group), "%s", value);
+    }
+    else if (strcmp(key, "coord_port") == 0) {
+        return parse_int(value, 1, 65535, &hs->coord.port);
+    }
+    else if (strcmp(key, "coord_overload") == 0) {
+        return parse_int(value, 50, 100, &hs->coord.overload_pct);
+    }
+    else if (strcmp(key, "http_listen") == 0) {
+        snprintf(app->http_listen, sizeof(app->http_listen), "%s", value);
+    }
+    else if (strcmp(key, "http_max_viewers") == 0) {
+        return parse_int(value, 1, 64, &app->http_max_viewers);
+    }
+    else if (strcmp(key, "lanperf") == 0) {
+        return parse_bool(value, &app->lanperf);
+    }
+    else if (strcmp(key, "lanperf_port") == 0) {
+        return parse_int(value, 1, 65535, &app->lanperf_port);
+    }
+    else if (strcmp(key, "lanperf_max_tests") == 0) {
+        return parse_int(value, 1, LANPERF_MAX_TESTS, &app->lanperf_max_tests);
+    }
+    else if (strcmp(key, "hook_workers") == 0) {
+        return parse_int(value, 1, HOOK_MAX_WORKERS, &app->hooks.workers);
+    }
+    else if (strcmp(key, "hook_queue") == 0) {
+        return parse_int(value, 1, HOOK_MAX_QUEUE, &app->hooks.queue_limit);
+    }
+    else if (strcmp(key, "hook_timeout") == 0) {
+        return parse_int(value, 1, 3600, &app->hooks.default_timeout_s);
+    }
+    else if (strncmp(key, "hook.", 5) == 0) {
+        return apply_hook_key(key, value, &app->hooks);
+    }
+    else {
+        return false;
+    }
+    return true;
+}
+
+/* ── Compiled-out features ───────────────────────────────────────────── */
+
+/*
+ * Keys for modules left out of this build (see the WITH_* Makefile
+ * options). Returns the option that enables the key, or NULL.
+ */
+static const char *disabled_feature(const char *key)
+{
+#ifdef HOTSPOT_NO_WEB
+    if (strncmp(key, "http_", 5) == 0) return "WITH_WEB=1";
+#endif
+#ifdef HOTSPOT_NO_LANPERF
+    if (strncmp(key, "lanperf", 7) == 0) return "WITH_LANPERF=1";
+#endif
+#ifdef HOTSPOT_NO_HOOKS
+    if (strncmp(key, "hook", 4) == 0) return "WITH_HOOKS=1";
+#endif
+    (void)key;
+    return NULL;
+}
+
+/* ── Load ────────────────────────────────────────────────────────────── */
+
+bool config_load(const char *path, HotspotConfig *hs, AppConfig *app,
+                 char *err, size_t errsize)
+{
+    FILE *fp = fopen(path, "r");
+    if (!fp) {
+        if (errno == ENOENT) return true;
+        snprintf(err, errsize, "%s: cannot open", path);
+        return false;
+    }
+
+    char line[MAX_CMD_LEN];
+    int lineno = 0;
+    bool ok = true;
+
+    while (fgets(line, sizeof(line), fp)) {
+        lineno++;
+
+        /* Comments only at line start — passwords may contain '#' */
+        char *s = trim(line);
+        if (*s == '\0' || *s == '#') continue;
+
+        char *eq = strchr(s, '=');
+        if (!eq) {
+            snprintf(err, errsize, "%s:%d: expected key = value", path, lineno);
+            ok = false;
+            break;
+        }
+        *eq = '\0';
+        char *key   = trim(s);
+        char *value = trim(eq + 1);
+
+        const char *feature = disabled_feature(key);
+        if (feature) {
+            snprintf(err, errsize, "%s:%d: '%s' needs a build with %s",
+                     path, lineno, key, feature);
+            ok = false;
+            break;
+        }
+        if (!apply_key(key, value, hs, app)) {
+            snprintf(err, errsize, "%s:%d: invalid setting '%s'",
+                     path, lineno, key);
+            ok = false;
+            break;
+        }
+    }
+    fclose(fp);
+
+    return ok;
+}
@@ -0,0 +1,215 @@
+/*
+ * connlimit.c - Per-client connection caps for Linux Hotspot Enabler
+ *
+ * The caps run in the forward hook just ahead of the filter priority,
+ * on ct state new only, so established traffic never meets them. The
+ * rate meter is a dynamic set with a limit per address; the concurrency
+ * cap is a dynamic set with ct count, which garbage-collects itself as
+ * connections close. Both drop (not reject) so a flooding client gets
+ * no extra packets back.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+
+#include "connlimit.h"
+#include "fileio.h"
+
+#define CT_SYSCTL(name)  "/proc/sys/net/netfilter/nf_conntrack_" name
+
+#define CT_MAX_PATH          CT_SYSCTL("max")
+#define CT_BUCKETS_PATH      CT_SYSCTL("buckets")
+#define CT_TCP_EST_PATH      CT_SYSCTL("tcp_timeout_established")
+#define CT_UDP_PATH          CT_SYSCTL("udp_timeout")
+#define CT_UDP_STREAM_PATH   CT_SYSCTL("udp_timeout_stream")
+
+/* Router values (as on OpenWrt); the kernel defaults are 5 days / 30 s / 120 s */
+#define TCP_ESTABLISHED_SECS  7440
+#define UDP_SECS              60
+#define UDP_STREAM_SECS       180
+
+/* ── Config ──────────────────────────────────────────────────────────── */
+
+void connlimit_default(ConnLimitConfig *cfg)
+{
+    cfg->rate = 0;
+    cfg->max  = 0;
+}
+
+void connlimit_init(ConnLimitSaved *saved)
+{
+    saved->table           = false;
+    saved->ct_max          = -1;
+    saved->ct_buckets      = -1;
+    saved->tcp_established = -1;
+    saved->udp             = -1;
+    saved->udp_stream      = -1;
+}
+
+bool connlimit_enabled(const ConnLimitConfig *cfg)
+{
+    return cfg->rate > 0 || cfg->max > 0;
+}
+
+/* ── Sysctls ─────────────────────────────────────────────────────────── */
+
+static long read_long(const char *path)
+{
+    char buf[32];
+    if (!fio_read_file(path, buf, sizeof(buf))) return -1;
+    return strtol(buf, NULL, 10);
+}
+
+static bool write_long(const char *path, long value)
+{
+    char buf[32];
+    int len = snprintf(buf, sizeof(buf), "%ld\n", value);
+    return fio_write_file(path, buf, (size_t)len, 0644);
+}
+
+/* Move a sysctl towards target (up if raise, else down); remember the old value */
+static void adjust(const char *path, long target, bool raise, long *saved)
+{
+    long cur = read_long(path);
+    if (cur < 0) return;
+    if (raise ? cur >= target : cur <= target) return;
+    if (write_long(path, target)) *saved = cur;
+}
+
+static void size_conntrack(const ConnLimitConfig *cfg, int max_clients,
+                           ConnLimitSaved *saved)
+{
+    long per_client = cfg->max > 0 ? cfg->max : CONNLIMIT_DEFAULT_CT;
+    long ct_max = (long)max_clients * per_client + CONNLIMIT_HOST_CT;
+
+    adjust(CT_MAX_PATH, ct_max, true, &saved->ct_max);
+
+    /* Keep hash chains short: one bucket per four entries (writable since 5.x) */
+    long buckets = 1;
+    while (buckets < ct_max / 4) buckets <<= 1;
+    adjust(CT_BUCKETS_PATH, buckets, true, &saved->ct_buckets);
+
+    adjust(CT_TCP_EST_PATH,    TCP_ESTABLISHED_SECS, false, &saved->tcp_established);
+    adjust(CT_UDP_PATH,        UDP_SECS,             false, &saved->udp);
+    adjust(CT_UDP_STREAM_PATH, UDP_STREAM_SECS,      false, &saved->udp_stream);
+}
+
+static void restore_sysctl(const char *path, long *saved)
+{
+    if (*saved >= 0) write_long(path, *saved);
+    *saved = -1;
+}
+
+/* ── nftables ────────────────────────────────────────────────────────── */
+
+static bool run_nft(const char *input)
+{
+    FILE *fp = popen("nft -f - 2>/dev/null", "w");
+    if (!fp) return false;
+    fputs(input, fp);
+    return pclose(fp) == 0;
+}
+
+static bool load_table(const ConnLimitConfig *cfg, const char *ap_iface)
+{
+    char rate_rule[256] = "", count_rule[256] = "";
+
+    if (cfg->rate > 0)
+        snprintf(rate_rule, sizeof(rate_rule),
+                 "        iifname \"%s\" ct state new add @conn_rate "
+                 "{ ip saddr limit rate over %d/second burst %d packets } "
+                 "update @offenders { ip saddr } counter drop\n",
+                 ap_iface, cfg->rate, cfg->rate * 2);
+    if (cfg->max > 0)
+        snprintf(count_rule, sizeof(count_rule),
+                 "        iifname \"%s\" ct state new add @conn_count "
+                 "{ ip saddr ct count over %d } "
+                 "update @offenders { ip saddr } counter drop\n",
+                 ap_iface, cfg->max);
+
+    /* Re-creating the table replaces whatever a crashed run left */
+    char input[2048];
+    snprintf(input, sizeof(input),
+             "table inet " CONNLIMIT_TABLE "\n"
+             "delete table inet " CONNLIMIT_TABLE "\n"
+             "table inet " CONNLIMIT_TABLE " {\n"
+             "    set conn_rate {\n"
+             "        type ipv4_addr; size 65535; flags dynamic, timeout; timeout 10s;\n"
+             "    }\n"
+             "    set conn_count {\n"
+             "        type ipv4_addr; size 65535; flags dynamic;\n"
+             "    }\n"
+             "    set offenders {\n"
+             "        type ipv4_addr; size 1024; flags dynamic, timeout; timeout %ds;\n"
+             "    }\n"
+             "    chain forward {\n"
+             "        type filter hook forward priority filter - 5; policy accept;\n"
+             "%s%s"
+             "    }\n"
+             "}\n",
+             CONNLIMIT_FLAG_SECS, rate_rule, count_rule);
+    return run_nft(input);
+}
+
+/* ── Start / Stop ────────────────────────────────────────────────────── */
+
+bool connlimit_start(const ConnLimitConfig *cfg, const char *ap_iface,
+                     int max_clients, ConnLimitSaved *saved,
+                     char *err, size_t errsize)
+{
+    connlimit_init(saved);
+    size_conntrack(cfg, max_clients, saved);
+
+    if (net_exec_silent("which nft >/dev/null 2>&1") != 0) {
+        snprintf(err, errsize, "nft is not installed");
+        return false;
+    }
+    if (!load_table(cfg, ap_iface)) {
+        snprintf(err, errsize, "nft rejected the " CONNLIMIT_TABLE " table "
+                 "(kernel without ct count / dynamic sets?)");
+        return false;
+    }
+    saved->table = true;
+    return true;
+}
+
+void connlimit_stop(ConnLimitSaved *saved)
+{
+    if (saved->table)
+        net_exec_silent("nft delete table inet " CONNLIMIT_TABLE " 2>/dev/null");
+
+    restore_sysctl(CT_MAX_PATH,        &saved->ct_max);
+    restore_sysctl(CT_BUCKETS_PATH,    &saved->ct_buckets);
+    restore_sysctl(CT_TCP_EST_PATH,    &saved->tcp_established);
+    restore_sysctl(CT_UDP_PATH,        &saved->udp);
+    restore_sysctl(CT_UDP_STREAM_PATH, &saved->udp_stream);
+    saved->table = false;
+}
+
+/* "elements = { 192.168.12.57 timeout 1m expires 43s, 192.168.12.80 ... }" */
+int connlimit_offenders(char ips[][MAX_IP_LEN], int max)
+{
+    char out[8192] = {0};
+    net_exec_cmd("nft list set inet " CONNLIMIT_TABLE " offenders 2>/dev/null",
+                 out, sizeof(out));
+
+    const char *p = strstr(out, "elements");
+    if (!p || !(p = strchr(p, '{'))) return 0;
+
+    int count = 0;
+    while (*p && *p != '}' && count < max) {
+        p++;
+        while (*p == ' ' || *p == '\t' || *p == '\n') p++;
+        if (isdigit((unsigned char)*p)) {
+            size_t len = strspn(p, "0123456789.");
+            if (len < MAX_IP_LEN) {
+                memcpy(ips[count], p, len);
+                ips[count++][len] = '\0';
+            }
+        }
+        p += strcspn(p, ",}");
+    }
+    return count;
+}
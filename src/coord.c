@@ -0,0 +1,642 @@
+/*
+ * coord.c - Multi-node coordination for Linux Hotspot Enabler
+ *
+ * One thread owns the multicast socket: it announces this node every
+ * COORD_ANNOUNCE_MS (sooner after a local change), drains peer
+ * announcements between, drops silent peers and re-evaluates the load
+ * cap. Channel decisions are made on request by the main loop, from
+ * the same peer table. Every node runs the same rules on (almost) the
+ * same table, so they agree without any negotiation round trips.
+ * Peers are only learned from announcements whose HMAC checks out.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdarg.h>
+#include <unistd.h>
+#include <signal.h>
+#include <errno.h>
+#include <poll.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include <net/if.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+#include <sys/socket.h>
+#include <sys/random.h>
+
+#include "coord.h"
+#include "sha256.h"
+
+static const int g_chan24[] = { 1, 6, 11 };
+static const int g_chan5[]  = { 36, 40, 44, 48, 149, 153, 157, 161 };
+
+#define MAC_PREFIX  COORD_MAGIC " mac="
+#define MAC_HEX     (SHA256_LEN * 2)
+#define SIM_KEY     "coord-sim-shared-test-key"
+
+/* ── State ───────────────────────────────────────────────────────────── */
+
+static struct {
+    atomic_bool     running;
+    atomic_bool     announce_now;
+    pthread_t       thread;
+    int             fd;
+    struct sockaddr_in group;
+    uint32_t        id;
+    uint32_t        seq;            /* per announcement */
+    char            name[32];
+    long            started_ms;
+
+    pthread_mutex_t lock;
+    CoordConfig     cfg;
+    char            ssid[MAX_SSID_LEN];
+    int             channel;
+    int             clients;
+    int             max_clients;
+    bool            dedicated;
+    time_t          last_switch;
+    int             allowed[16];
+    int             allowed_count;
+    CoordPeer       peers[COORD_MAX_PEERS];
+    int             peer_count;
+    int             cap;            /* -1 = none */
+    unsigned long   rejected;       /* failed authentication or replayed */
+    char            events[COORD_MAX_EVENTS][MAX_LINE_LEN];
+    int             ev_head;
+    int             ev_count;
+} g_coord = {
+    .fd   = -1,
+    .cap  = -1,
+    .lock = PTHREAD_MUTEX_INITIALIZER,
+};
+
+static long mono_ms(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1000L + ts.tv_nsec / 1000000L;
+}
+
+/* Caller holds the lock */
+static void push_event(const char *fmt, ...)
+    __attribute__((format(printf, 1, 2)));
+
+static void push_event(const char *fmt, ...)
+{
+    int slot = (g_coord.ev_head + g_coord.ev_count) % COORD_MAX_EVENTS;
+    if (g_coord.ev_count == COORD_MAX_EVENTS)
+        g_coord.ev_head = (g_coord.ev_head + 1) % COORD_MAX_EVENTS;
+    else
+        g_coord.ev_count++;
+
+    va_list args;
+    va_start(args, fmt);
+    vsnprintf(g_coord.events[slot], MAX_LINE_LEN, fmt, args);
+    va_end(args);
+}
+
+/* ── Config ──────────────────────────────────────────────────────────── */
+
+void coord_default(CoordConfig *cfg)
+{
+    memset(cfg, 0, sizeof(CoordConfig));
+    cfg->enabled      = false;
+    snprintf(cfg->group, sizeof(cfg->group), "%s", COORD_DEFAULT_GROUP);
+    cfg->port         = COORD_DEFAULT_PORT;
+    cfg->overload_pct = 80;
+}
+
+/* ── Channel rules (caller holds the lock) ───────────────────────────── */
+
+static bool overlaps(int a, int b)
+{
+    if (a <= 14 && b <= 14) return abs(a - b) < 5;   /* 20 MHz at 5 MHz spacing */
+    return a == b;
+}
+
+static int load_pct(int clients, int max_clients)
+{
+    return max_clients > 0 ? clients * 100 / max_clients : 0;
+}
+
+/* Peers already on ch, weighted by their clients */
+static int channel_cost(int ch)
+{
+    int cost = 0;
+    for (int i = 0; i < g_coord.peer_count; i++) {
+        const CoordPeer *p = &g_coord.peers[i];
+        if (p->channel > 0 && overlaps(p->channel, ch))
+            cost += 1 + p->clients;
+    }
+    return cost;
+}
+
+/* Per-node order among equal costs, so simultaneous starters differ */
+static uint32_t tiebreak(int ch)
+{
+    uint32_t h = g_coord.id ^ (uint32_t)ch * 0x9e3779b1u;
+    h ^= h >> 16;
+    h *= 0x85ebca6bu;
+    return h ^ (h >> 13);
+}
+
+static bool allowed(int ch)
+{
+    if (g_coord.allowed_count == 0) return true;
+    for (int i = 0; i < g_coord.allowed_count; i++)
+        if (g_coord.allowed[i] == ch) return true;
+    return false;
+}
+
+static int rank_locked(bool band5, int *out, int max)
+{
+    const int *cand = band5 ? g_chan5 : g_chan24;
+    int ncand = band5 ? (int)(sizeof(g_chan5) / sizeof(g_chan5[0]))
+                      : (int)(sizeof(g_chan24) / sizeof(g_chan24[0]));
+    int cost[16], n = 0;
+
+    for (int i = 0; i < ncand && n < max && n < 16; i++) {
+        if (!allowed(cand[i])) continue;
+        int c = channel_cost(cand[i]), j = n++;
+        /* Insertion by (cost, tiebreak) */
+        while (j > 0 && (cost[j - 1] > c ||
+                         (cost[j - 1] == c && tiebreak(out[j - 1]) > tiebreak(cand[i])))) {
+            out[j] = out[j - 1];
+            cost[j] = cost[j - 1];
+            j--;
+        }
+        out[j] = cand[i];
+        cost[j] = c;
+    }
+    return n;
+}
+
+/*
+ * The load cap, re-evaluated every announcement. Capping needs a peer
+ * on the same SSID (somewhere for the clients to go) that is below the
+ * threshold and COORD_LOAD_MARGIN points below us; 10 points of
+ * hysteresis on the way back.
+ */
+static void update_cap(void)
+{
+    int load = load_pct(g_coord.clients, g_coord.max_clients);
+    int over = g_coord.cfg.overload_pct;
+    const CoordPeer *helper = NULL;
+
+    for (int i = 0; i < g_coord.peer_count; i++) {
+        const CoordPeer *p = &g_coord.peers[i];
+        int pl = load_pct(p->clients, p->max_clients);
+        if (p->channel > 0 && strcmp(p->ssid, g_coord.ssid) == 0 &&
+            pl < over && pl + COORD_LOAD_MARGIN <= load &&
+            (!helper || pl < load_pct(helper->clients, helper->max_clients)))
+            helper = p;
+    }
+
+    bool active = g_coord.channel > 0;
+    if (g_coord.cap < 0 && active && load >= over && helper) {
+        g_coord.cap = g_coord.clients;
+        push_event("Coordination: at %d%% load, new clients go to %s "
+                   "(%d%%, channel %d)", load, helper->name,
+                   load_pct(helper->clients, helper->max_clients),
+                   helper->channel);
+    } else if (g_coord.cap >= 0 && (!active || load < over - 10 || !helper)) {
+        g_coord.cap = -1;
+        if (active)
+            push_event("Coordination: taking new clients again (%d%% load)", load);
+    }
+}
+
+/* ── Wire format ─────────────────────────────────────────────────────── */
+
+/*
+ * "HSC2 mac=<hex> <body>": the HMAC covers the body, everything after
+ * the space that follows the hex.
+ */
+static void announce(void)
+{
+    char body[224], msg[320];
+    uint8_t mac[SHA256_LEN];
+
+    pthread_mutex_lock(&g_coord.lock);
+    int len = snprintf(body, sizeof(body),
+                       "id=%08x seq=%u ch=%d cl=%d max=%d ded=%d name=%s ssid=%s",
+                       g_coord.id, ++g_coord.seq, g_coord.channel, g_coord.clients,
+                       g_coord.max_clients, g_coord.dedicated ? 1 : 0,
+                       g_coord.name, g_coord.ssid);
+    if (len > 0 && len < (int)sizeof(body))
+        sha256_hmac(g_coord.cfg.key, strlen(g_coord.cfg.key), body, (size_t)len, mac);
+    pthread_mutex_unlock(&g_coord.lock);
+    if (len <= 0 || len >= (int)sizeof(body)) return;
+
+    int off = snprintf(msg, sizeof(msg), "%s", MAC_PREFIX);
+    for (int i = 0; i < SHA256_LEN; i++)
+        off += snprintf(msg + off, sizeof(msg) - (size_t)off, "%02x", mac[i]);
+    off += snprintf(msg + off, sizeof(msg) - (size_t)off, " %s", body);
+
+    sendto(g_coord.fd, msg, (size_t)off, 0,
+           (struct sockaddr *)&g_coord.group, sizeof(g_coord.group));
+}
+
+/* The body of an announcement whose HMAC matches our key, else NULL */
+static const char *authenticated_body(const char *buf)
+{
+    const size_t plen = strlen(MAC_PREFIX);
+    if (strncmp(buf, MAC_PREFIX, plen) != 0 ||
+        strlen(buf) <= plen + MAC_HEX || buf[plen + MAC_HEX] != ' ')
+        return NULL;
+
+    uint8_t got[SHA256_LEN], want[SHA256_LEN];
+    for (int i = 0; i < SHA256_LEN; i++) {
+        unsigned int byte;
+        if (sscanf(buf + plen + 2 * i, "%2x", &byte) != 1) return NULL;
+        got[i] = (uint8_t)byte;
+    }
+
+    const char *body = buf + plen + MAC_HEX + 1;
+    sha256_hmac(g_coord.cfg.key, strlen(g_coord.cfg.key), body, strlen(body), want);
+    return sha256_equal(got, want) ? body : NULL;
+}
+
+/* Caller holds the lock. Logged once: a wrong key repeats every second */
+static void reject(const char *why)
+{
+    if (g_coord.rejected++ == 0)
+        push_event("Coordination: dropping announcements that %s", why);
+}
+
+static void receive(void)
+{
+    char buf[512];
+    ssize_t n;
+
+    while ((n = recv(g_coord.fd, buf, sizeof(buf) - 1, MSG_DONTWAIT)) > 0) {
+        buf[n] = '\0';
+        buf[strcspn(buf, "\r\n")] = '\0';
+
+        const char *body = authenticated_body(buf);
+        if (!body) {
+            pthread_mutex_lock(&g_coord.lock);
+            reject("fail authentication (coord_key differs?)");
+            pthread_mutex_unlock(&g_coord.lock);
+            continue;
+        }
+
+        CoordPeer in = {0};
+        int ded = 0, off = 0;
+        if (sscanf(body, "id=%x seq=%u ch=%d cl=%d max=%d ded=%d name=%31s ssid=%n",
+                   &in.id, &in.seq, &in.channel, &in.clients, &in.max_clients,
+                   &ded, in.name, &off) != 7 || off == 0 || in.id == g_coord.id ||
+            in.channel < 0 || in.channel > 196 || in.clients < 0 ||
+            in.max_clients < 0)
+            continue;
+        snprintf(in.ssid, sizeof(in.ssid), "%s", body + off);
+        in.dedicated = (ded != 0);
+        in.last_seen = time(NULL);
+
+        pthread_mutex_lock(&g_coord.lock);
+        int i = 0;
+        while (i < g_coord.peer_count && g_coord.peers[i].id != in.id) i++;
+        if (i < g_coord.peer_count && in.seq <= g_coord.peers[i].seq) {
+            reject("replay an earlier sequence number");
+            pthread_mutex_unlock(&g_coord.lock);
+            continue;
+        }
+        if (i == g_coord.peer_count) {
+            if (i == COORD_MAX_PEERS) {
+                pthread_mutex_unlock(&g_coord.lock);
+                continue;
+            }
+            g_coord.peer_count++;
+            push_event("Coordination: peer %s (%08x) on %s", in.name, in.id,
+                       in.channel ? "the air" : "standby");
+        } else if (g_coord.peers[i].channel != in.channel && in.channel) {
+            push_event("Coordination: peer %s now on channel %d",
+                       in.name, in.channel);
+        }
+        g_coord.peers[i] = in;
+        pthread_mutex_unlock(&g_coord.lock);
+    }
+}
+
+static void expire_peers(void)
+{
+    time_t cutoff = time(NULL) - COORD_PEER_TIMEOUT;
+
+    pthread_mutex_lock(&g_coord.lock);
+    for (int i = 0; i < g_coord.peer_count; ) {
+        if (g_coord.peers[i].last_seen < cutoff) {
+            push_event("Coordination: peer %s (%08x) gone",
+                       g_coord.peers[i].name, g_coord.peers[i].id);
+            g_coord.peers[i] = g_coord.peers[--g_coord.peer_count];
+        } else {
+            i++;
+        }
+    }
+    update_cap();
+    pthread_mutex_unlock(&g_coord.lock);
+}
+
+/* ── Thread ──────────────────────────────────────────────────────────── */
+
+static void *coord_thread(void *arg)
+{
+    long next = 0;
+
+    while (atomic_load(&g_coord.running)) {
+        long now = mono_ms();
+        if (now >= next || atomic_exchange(&g_coord.announce_now, false)) {
+            announce();
+            expire_peers();
+            next = now + COORD_ANNOUNCE_MS;
+        }
+
+        struct pollfd pfd = { .fd = g_coord.fd, .events = POLLIN };
+        if (poll(&pfd, 1, 200) > 0) receive();
+    }
+    return NULL;
+}
+
+static bool open_socket(const CoordConfig *cfg, const char *iface,
+                        char *err, size_t errsize)
+{
+    struct ip_mreqn mreq = {0};
+    mreq.imr_ifindex = (int)if_nametoindex(iface);
+    if (mreq.imr_ifindex == 0) {
+        snprintf(err, errsize, "no interface %s", iface);
+        return false;
+    }
+
+    memset(&g_coord.group, 0, sizeof(g_coord.group));
+    g_coord.group.sin_family = AF_INET;
+    g_coord.group.sin_port   = htons((uint16_t)cfg->port);
+    if (inet_pton(AF_INET, cfg->group, &g_coord.group.sin_addr) != 1 ||
+        !IN_MULTICAST(ntohl(g_coord.group.sin_addr.s_addr))) {
+        snprintf(err, errsize, "%s is not a multicast address", cfg->group);
+        return false;
+    }
+    mreq.imr_multiaddr = g_coord.group.sin_addr;
+
+    int fd = socket(AF_INET, SOCK_DGRAM | SOCK_CLOEXEC, 0);
+    if (fd < 0) {
+        snprintf(err, errsize, "socket: %s", strerror(errno));
+        return false;
+    }
+
+    /* Bound to the group: unicast to the port is not ours to read */
+    int one = 1, ttl = 1;
+    setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+    if (bind(fd, (struct sockaddr *)&g_coord.group, sizeof(g_coord.group)) != 0 ||
+        setsockopt(fd, IPPROTO_IP, IP_ADD_MEMBERSHIP, &mreq, sizeof(mreq)) != 0 ||
+        setsockopt(fd, IPPROTO_IP, IP_MULTICAST_IF, &mreq, sizeof(mreq)) != 0 ||
+        setsockopt(fd, IPPROTO_IP, IP_MULTICAST_TTL, &ttl, sizeof(ttl)) != 0) {
+        snprintf(err, errsize, "%s:%d on %s: %s", cfg->group, cfg->port,
+                 iface, strerror(errno));
+        close(fd);
+        return false;
+    }
+
+    g_coord.fd = fd;
+    return true;
+}
+
+bool coord_start(const CoordConfig *cfg, char *err, size_t errsize)
+{
+    if (atomic_load(&g_coord.running)) return true;
+
+    /* The default route may be a shared network: no guessing the segment */
+    if (!cfg->iface[0]) {
+        snprintf(err, errsize, "set coord_iface to the segment the hosts share");
+        return false;
+    }
+    if (strlen(cfg->key) < COORD_MIN_KEY) {
+        snprintf(err, errsize, "set coord_key (at least %d characters, the "
+                 "same on every node)", COORD_MIN_KEY);
+        return false;
+    }
+    if (!open_socket(cfg, cfg->iface, err, errsize)) return false;
+
+    if (getrandom(&g_coord.id, sizeof(g_coord.id), 0) != sizeof(g_coord.id))
+        g_coord.id = (uint32_t)getpid() ^ (uint32_t)mono_ms();
+    if (gethostname(g_coord.name, sizeof(g_coord.name)) != 0 || !g_coord.name[0])
+        snprintf(g_coord.name, sizeof(g_coord.name), "node");
+    g_coord.name[sizeof(g_coord.name) - 1] = '\0';
+    for (char *p = g_coord.name; *p; p++)
+        if (*p == ' ') *p = '_';
+
+    pthread_mutex_lock(&g_coord.lock);
+    g_coord.cfg        = *cfg;
+    g_coord.peer_count = 0;
+    g_coord.cap        = -1;
+    g_coord.rejected   = 0;
+    g_coord.ev_head    = g_coord.ev_count = 0;
+    pthread_mutex_unlock(&g_coord.lock);
+    g_coord.started_ms = mono_ms();
+
+    /* Keep SIGINT/SIGWINCH on the main thread */
+    sigset_t all, old;
+    sigfillset(&all);
+    pthread_sigmask(SIG_SETMASK, &all, &old);
+    atomic_store(&g_coord.running, true);
+    bool ok = (pthread_create(&g_coord.thread, NULL, coord_thread, NULL) == 0);
+    pthread_sigmask(SIG_SETMASK, &old, NULL);
+
+    if (!ok) {
+        atomic_store(&g_coord.running, false);
+        close(g_coord.fd);
+        g_coord.fd = -1;
+        snprintf(err, errsize, "cannot start coordination thread");
+        return false;
+    }
+    return true;
+}
+
+void coord_stop(void)
+{
+    if (!atomic_load(&g_coord.running)) return;
+
+    /* A last "stopped" announcement so peers stop counting on us */
+    pthread_mutex_lock(&g_coord.lock);
+    g_coord.channel = 0;
+    pthread_mutex_unlock(&g_coord.lock);
+    announce();
+
+    atomic_store(&g_coord.running, false);
+    pthread_join(g_coord.thread, NULL);
+    close(g_coord.fd);
+    g_coord.fd = -1;
+}
+
+bool coord_running(void)
+{
+    return atomic_load(&g_coord.running);
+}
+
+/* ── Queries ─────────────────────────────────────────────────────────── */
+
+void coord_set_local(const char *ssid, int channel, int clients,
+                     int max_clients, bool dedicated)
+{
+    pthread_mutex_lock(&g_coord.lock);
+    bool changed = g_coord.channel != channel ||
+                   strcmp(g_coord.ssid, ssid) != 0;
+    if (g_coord.channel > 0 && channel > 0 && g_coord.channel != channel)
+        g_coord.last_switch = time(NULL);
+    snprintf(g_coord.ssid, sizeof(g_coord.ssid), "%s", ssid);
+    g_coord.channel     = channel;
+    g_coord.clients     = clients;
+    g_coord.max_clients = max_clients;
+    g_coord.dedicated   = dedicated;
+    pthread_mutex_unlock(&g_coord.lock);
+
+    if (changed) atomic_store(&g_coord.announce_now, true);
+}
+
+void coord_set_allowed(const int *channels, int count)
+{
+    pthread_mutex_lock(&g_coord.lock);
+    if (count > (int)(sizeof(g_coord.allowed) / sizeof(g_coord.allowed[0])))
+        count = (int)(sizeof(g_coord.allowed) / sizeof(g_coord.allowed[0]));
+    memcpy(g_coord.allowed, channels, (size_t)count * sizeof(int));
+    g_coord.allowed_count = count;
+    pthread_mutex_unlock(&g_coord.lock);
+}
+
+int coord_rank_channels(bool band5, int *out, int max)
+{
+    long wait = g_coord.started_ms + COORD_SETTLE_MS - mono_ms();
+    if (coord_running() && wait > 0) usleep((useconds_t)wait * 1000);
+
+    pthread_mutex_lock(&g_coord.lock);
+    int n = rank_locked(band5, out, max);
+    pthread_mutex_unlock(&g_coord.lock);
+    return n;
+}
+
+/*
+ * Ours overlaps a peer's: the dedicated node with the highest id among
+ * those sharing it moves (one at a time, so movers do not collide on
+ * the same target); nodes on a shared radio cannot move and are
+ * treated as fixed. Only a strictly less used channel is worth a move.
+ */
+int coord_wanted_channel(void)
+{
+    int want = 0;
+
+    pthread_mutex_lock(&g_coord.lock);
+    int ch = g_coord.channel;
+    bool ready = ch > 0 && g_coord.dedicated &&
+                 mono_ms() - g_coord.started_ms >= COORD_SETTLE_MS &&
+                 time(NULL) - g_coord.last_switch >= COORD_SWITCH_COOLDOWN;
+
+    bool conflict = false, yield = true;
+    for (int i = 0; ready && i < g_coord.peer_count; i++) {
+        const CoordPeer *p = &g_coord.peers[i];
+        if (p->channel <= 0 || !overlaps(p->channel, ch)) continue;
+        conflict = true;
+        if (p->dedicated && p->id > g_coord.id) yield = false;
+    }
+
+    if (conflict && yield) {
+        int rank[16];
+        int n = rank_locked(ch > 14, rank, 16);
+        if (n > 0 && rank[0] != ch && channel_cost(rank[0]) < channel_cost(ch)) {
+            want = rank[0];
+            push_event("Coordination: channel %d is shared, moving to %d",
+                       ch, want);
+        }
+    }
+    pthread_mutex_unlock(&g_coord.lock);
+    return want;
+}
+
+int coord_admit_cap(void)
+{
+    pthread_mutex_lock(&g_coord.lock);
+    int cap = g_coord.cap;
+    pthread_mutex_unlock(&g_coord.lock);
+    return cap;
+}
+
+int coord_peers(CoordPeer *out, int max)
+{
+    pthread_mutex_lock(&g_coord.lock);
+    int n = g_coord.peer_count < max ? g_coord.peer_count : max;
+    memcpy(out, g_coord.peers, (size_t)n * sizeof(CoordPeer));
+    pthread_mutex_unlock(&g_coord.lock);
+    return n;
+}
+
+bool coord_next_event(char *msg, size_t msgsize)
+{
+    bool found = false;
+
+    pthread_mutex_lock(&g_coord.lock);
+    if (g_coord.ev_count > 0) {
+        snprintf(msg, msgsize, "%s", g_coord.events[g_coord.ev_head]);
+        g_coord.ev_head = (g_coord.ev_head + 1) % COORD_MAX_EVENTS;
+        g_coord.ev_count--;
+        found = true;
+    }
+    pthread_mutex_unlock(&g_coord.lock);
+    return found;
+}
+
+/* ── Simulation ──────────────────────────────────────────────────────── */
+
+int coord_simulate(int argc, char **argv)
+{
+    if (argc < 4) {
+        fprintf(stderr, "usage: coord-sim IFACE CHANNEL CLIENTS MAX [SECONDS] [KEY]\n");
+        return 2;
+    }
+
+    CoordConfig cfg;
+    coord_default(&cfg);
+    cfg.enabled = true;
+    snprintf(cfg.iface, sizeof(cfg.iface), "%s", argv[0]);
+    int channel = atoi(argv[1]);
+    int clients = atoi(argv[2]);
+    int max_clients = atoi(argv[3]);
+    int seconds = argc > 4 ? atoi(argv[4]) : 30;
+    snprintf(cfg.key, sizeof(cfg.key), "%s", argc > 5 ? argv[5] : SIM_KEY);
+
+    char err[MAX_LINE_LEN];
+    if (!coord_start(&cfg, err, sizeof(err))) {
+        fprintf(stderr, "coord-sim: %s\n", err);
+        return 1;
+    }
+    printf("# node %08x on %s\n", g_coord.id, cfg.iface);
+
+    if (channel == 0) {
+        int rank[16];
+        channel = coord_rank_channels(false, rank, 16) > 0 ? rank[0] : 6;
+        printf("t=0 picked channel %d\n", channel);
+    }
+    coord_set_local("sim", channel, clients, max_clients, true);
+
+    long t0 = mono_ms();
+    char msg[MAX_LINE_LEN];
+    while (mono_ms() - t0 < seconds * 1000L) {
+        usleep(250000);
+        int want = coord_wanted_channel();
+        if (want) {
+            channel = want;
+            coord_set_local("sim", channel, clients, max_clients, true);
+        }
+        while (coord_next_event(msg, sizeof(msg)))
+            printf("t=%ld %s\n", (mono_ms() - t0) / 1000, msg);
+        fflush(stdout);
+    }
+
+    CoordPeer peers[COORD_MAX_PEERS];
+    int npeers = coord_peers(peers, COORD_MAX_PEERS);
+    pthread_mutex_lock(&g_coord.lock);
+    unsigned long rejected = g_coord.rejected;
+    pthread_mutex_unlock(&g_coord.lock);
+    printf("final id=%08x channel=%d cap=%d peers=%d rejected=%lu\n", g_coord.id,
+           channel, coord_admit_cap(), npeers, rejected);
+    coord_stop();
+    return 0;
+}
@@ -0,0 +1,477 @@
+/*
+ * doctor.c - Prerequisite diagnostics for Linux Hotspot Enabler
+ *
+ * Each check runs on its own thread and fills one DoctorResult; the
+ * report is sorted by severity so the blocking problems come first.
+ * Checks read /proc and /sys directly where they can and only shell
+ * out for iw/iptables/nft, so the whole run stays well under a second.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdarg.h>
+#include <unistd.h>
+#include <dirent.h>
+#include <time.h>
+#include <pthread.h>
+#include <sys/stat.h>
+
+#include "doctor.h"
+#include "hotspot.h"
+#include "netns.h"
+
+/* ── Results ─────────────────────────────────────────────────────────── */
+
+typedef enum {
+    DR_FAIL,        /* hotspot will not work */
+    DR_WARN,        /* may cause trouble */
+    DR_OK
+} DoctorSeverity;
+
+typedef struct DoctorResult {
+    const char     *name;
+    DoctorSeverity  severity;
+    char            message[MAX_CMD_LEN];
+    double          elapsed_ms;
+    void          (*fn)(struct DoctorResult *);
+    int             order;          /* position in the table, for stable sort */
+    pthread_t       thread;
+    bool            threaded;
+} DoctorResult;
+
+static void set_result(DoctorResult *r, DoctorSeverity sev, const char *fmt, ...)
+    __attribute__((format(printf, 3, 4)));
+
+static void set_result(DoctorResult *r, DoctorSeverity sev, const char *fmt, ...)
+{
+    va_list args;
+    va_start(args, fmt);
+    vsnprintf(r->message, sizeof(r->message), fmt, args);
+    va_end(args);
+    r->severity = sev;
+}
+
+/* Append ", text" to the message (used to collect several findings) */
+static void append_msg(char *buf, size_t bufsize, const char *text)
+{
+    size_t len = strlen(buf);
+    snprintf(buf + len, bufsize - len, "%s%s", len ? ", " : "", text);
+}
+
+static bool read_first_line(const char *path, char *buf, size_t bufsize)
+{
+    FILE *fp = fopen(path, "r");
+    if (!fp) return false;
+    bool ok = (fgets(buf, (int)bufsize, fp) != NULL);
+    fclose(fp);
+    if (ok) buf[strcspn(buf, "\n")] = '\0';
+    return ok;
+}
+
+/* Find a running process by its comm name. Returns its pid or 0 */
+static pid_t find_process(const char *comm)
+{
+    DIR *dir = opendir("/proc");
+    if (!dir) return 0;
+
+    struct dirent *entry;
+    pid_t found = 0;
+    while (!found && (entry = readdir(dir)) != NULL) {
+        if (entry->d_name[0] < '1' || entry->d_name[0] > '9') continue;
+
+        char path[MAX_PATH_LEN], name[64];
+        snprintf(path, sizeof(path), "/proc/%.32s/comm", entry->d_name);
+        if (read_first_line(path, name, sizeof(name)) &&
+            strcmp(name, comm) == 0) {
+            found = (pid_t)atoi(entry->d_name);
+        }
+    }
+    closedir(dir);
+    return found;
+}
+
+/* ── Checks ──────────────────────────────────────────────────────────── */
+
+static void check_root(DoctorResult *r)
+{
+    if (geteuid() == 0)
+        set_result(r, DR_OK, "running as root");
+    else
+        set_result(r, DR_WARN, "not root: some checks are incomplete, "
+                               "and starting the hotspot needs sudo");
+}
+
+static void check_deps(DoctorResult *r)
+{
+    DependencyStatus ds = net_check_dependencies();
+    char missing[MAX_LINE_LEN] = {0};
+
+    if (!ds.has_iw)       append_msg(missing, sizeof(missing), "iw");
+    if (!ds.has_hostapd)  append_msg(missing, sizeof(missing), "hostapd");
+    if (!ds.has_dnsmasq)  append_msg(missing, sizeof(missing), "dnsmasq");
+    if (!ds.has_iptables) append_msg(missing, sizeof(missing), "iptables");
+
+    if (ds.all_present) {
+        set_result(r, DR_OK, "iw, hostapd, dnsmasq and iptables found");
+    } else {
+        char cmd[MAX_CMD_LEN];
+        net_get_install_command(cmd, sizeof(cmd));
+        set_result(r, DR_FAIL, "missing: %s — install with: %s", missing, cmd);
+    }
+}
+
+static void check_rfkill(DoctorResult *r)
+{
+    DIR *dir = opendir("/sys/class/rfkill");
+    if (!dir) {
+        set_result(r, DR_OK, "no rfkill switches");
+        return;
+    }
+
+    struct dirent *entry;
+    char blocked[MAX_LINE_LEN] = {0};
+    bool hard = false;
+    int wlan = 0;
+
+    while ((entry = readdir(dir)) != NULL) {
+        if (entry->d_name[0] == '.') continue;
+
+        char path[MAX_PATH_LEN], val[32], name[64];
+        snprintf(path, sizeof(path), "/sys/class/rfkill/%.64s/type", entry->d_name);
+        if (!read_first_line(path, val, sizeof(val)) || strcmp(val, "wlan") != 0)
+            continue;
+        wlan++;
+
+        snprintf(path, sizeof(path), "/sys/class/rfkill/%.64s/name", entry->d_name);
+        if (!read_first_line(path, name, sizeof(name)))
+            snprintf(name, sizeof(name), "%.63s", entry->d_name);
+
+        snprintf(path, sizeof(path), "/sys/class/rfkill/%.64s/hard", entry->d_name);
+        if (read_first_line(path, val, sizeof(val)) && atoi(val) == 1) {
+            hard = true;
+            append_msg(blocked, sizeof(blocked), name);
+            continue;
+        }
+        snprintf(path, sizeof(path), "/sys/class/rfkill/%.64s/soft", entry->d_name);
+        if (read_first_line(path, val, sizeof(val)) && atoi(val) == 1)
+            append_msg(blocked, sizeof(blocked), name);
+    }
+    closedir(dir);
+
+    if (hard)
+        set_result(r, DR_FAIL, "hard-blocked: %s (check the WiFi switch/key)",
+                   blocked);
+    else if (blocked[0])
+        set_result(r, DR_WARN, "soft-blocked: %s (run: rfkill unblock wifi)",
+                   blocked);
+    else
+        set_result(r, DR_OK, "%d WiFi radio(s), none blocked", wlan);
+}
+
+static void check_interface(DoctorResult *r)
+{
+    WifiInterface wifi;
+    if (!net_detect_wifi_interface(&wifi)) {
+        set_result(r, DR_FAIL, "no wireless interface found");
+        return;
+    }
+
+    char phy[MAX_IFACE_NAME] = "?";
+    net_get_phy_name(wifi.name, phy, sizeof(phy));
+
+    if (!wifi.supports_ap)
+        set_result(r, DR_FAIL, "%s (%s): no AP+managed interface combination; "
+                   "use a second adapter for the hotspot", wifi.name, phy);
+    else
+        set_result(r, DR_OK, "%s (%s) supports AP/STA concurrency",
+                   wifi.name, phy);
+}
+
+static void check_channel(DoctorResult *r)
+{
+    WifiInterface wifi;
+    char phy[MAX_IFACE_NAME];
+    char country[64] = {0};
+
+    net_exec_cmd("iw reg get 2>/dev/null | grep -m1 -o 'country [A-Z0-9]*'",
+                 country, sizeof(country));
+    country[strcspn(country, "\n")] = '\0';
+
+    if (!net_detect_wifi_interface(&wifi) ||
+        !net_get_phy_name(wifi.name, phy, sizeof(phy))) {
+        set_result(r, DR_WARN, "no WiFi interface to check");
+        return;
+    }
+    if (!wifi.connected || wifi.channel <= 0) {
+        set_result(r, DR_WARN, "%s not connected; AP falls back to channel 6 (%s)",
+                   wifi.name, country[0] ? country : "no regdomain");
+        return;
+    }
+
+    ChannelFlags cf;
+    if (!net_get_channel_flags(phy, wifi.channel, &cf)) {
+        set_result(r, DR_WARN, "channel %d not listed for %s (%s)",
+                   wifi.channel, phy, country[0] ? country : "no regdomain");
+    } else if (cf.disabled) {
+        set_result(r, DR_FAIL, "channel %d is disabled in %s",
+                   wifi.channel, country[0] ? country : "this regdomain");
+    } else if (cf.radar) {
+        set_result(r, DR_WARN, "channel %d is a DFS channel (radar detection, "
+                   "CAC wait before beaconing; %s)", wifi.channel, country);
+    } else if (cf.no_ir) {
+        set_result(r, DR_WARN, "channel %d is no-IR in %s: AP may be refused",
+                   wifi.channel, country);
+    } else {
+        set_result(r, DR_OK, "channel %d (%d MHz) allows AP, %s",
+                   wifi.channel, cf.freq_mhz, country[0] ? country : "world");
+    }
+}
+
+static void check_managers(DoctorResult *r)
+{
+    static const char *names[] = {
+        "NetworkManager", "connmand", "iwd", "wpa_supplicant",
+        "systemd-network"
+    };
+    char found[MAX_LINE_LEN] = {0};
+    bool iwd = false;
+
+    for (size_t i = 0; i < sizeof(names) / sizeof(names[0]); i++) {
+        if (find_process(names[i])) {
+            append_msg(found, sizeof(found), names[i]);
+            if (strcmp(names[i], "iwd") == 0) iwd = true;
+        }
+    }
+
+    if (!found[0])
+        set_result(r, DR_OK, "no network manager running");
+    else if (iwd)
+        set_result(r, DR_WARN, "running: %s — iwd may grab the AP interface",
+                   found);
+    else
+        set_result(r, DR_OK, "running: %s (AP interface will be unmanaged)",
+                   found);
+}
+
+/*
+ * Scan /proc/net/{udp,udp6,tcp,tcp6} for sockets bound to a port.
+ * Returns true if one is bound to the wildcard address (which blocks
+ * dnsmasq); "where" collects the addresses found.
+ */
+static bool port_bound(int port, char *where, size_t wsize)
+{
+    static const char *tables[] = {
+        "/proc/net/udp", "/proc/net/udp6", "/proc/net/tcp", "/proc/net/tcp6"
+    };
+    bool wildcard = false;
+
+    for (size_t t = 0; t < sizeof(tables) / sizeof(tables[0]); t++) {
+        FILE *fp = fopen(tables[t], "r");
+        if (!fp) continue;
+
+        char line[MAX_LINE_LEN];
+        bool tcp = (strstr(tables[t], "tcp") != NULL);
+        if (!fgets(line, sizeof(line), fp)) { fclose(fp); continue; }
+
+        while (fgets(line, sizeof(line), fp)) {
+            char local[64];
+            unsigned int st;
+            if (sscanf(line, "%*d: %63s %*s %x", local, &st) != 2) continue;
+            if (tcp && st != 0x0A) continue;        /* TCP_LISTEN only */
+
+            char *colon = strrchr(local, ':');
+            if (!colon || (int)strtol(colon + 1, NULL, 16) != port) continue;
+            *colon = '\0';
+
+            bool any = (strspn(local, "0") == strlen(local));
+            wildcard |= any;
+
+            char addr[MAX_IP_LEN];
+            if (any) {
+                snprintf(addr, sizeof(addr), "*");
+            } else if (strlen(local) == 8) {
+                unsigned int a = (unsigned int)strtoul(local, NULL, 16);
+                snprintf(addr, sizeof(addr), "%u.%u.%u.%u",
+                         a & 0xff, (a >> 8) & 0xff, (a >> 16) & 0xff, a >> 24);
+            } else {
+                snprintf(addr, sizeof(addr), "[v6]");
+            }
+            if (!strstr(where, addr)) append_msg(where, wsize, addr);
+        }
+        fclose(fp);
+    }
+    return wildcard;
+}
+
+static void check_ports(DoctorResult *r)
+{
+    char dns[MAX_LINE_LEN] = {0}, dhcp[MAX_LINE_LEN] = {0};
+    bool dns_any  = port_bound(53, dns, sizeof(dns));
+    bool dhcp_any = port_bound(67, dhcp, sizeof(dhcp));
+
+    if (dns_any || dhcp_any) {
+        set_result(r, DR_FAIL, "port %s bound on all addresses (53: %s; 67: %s) — "
+                   "stop the other DNS/DHCP server",
+                   dns_any ? "53" : "67", dns[0] ? dns : "free",
+                   dhcp[0] ? dhcp : "free");
+    } else if (dns[0] || dhcp[0]) {
+        set_result(r, DR_OK, "53: %s; 67: %s (specific addresses, no conflict)",
+                   dns[0] ? dns : "free", dhcp[0] ? dhcp : "free");
+    } else {
+        set_result(r, DR_OK, "ports 53 and 67 are free");
+    }
+}
+
+static void check_forwarding(DoctorResult *r)
+{
+    char val[8] = {0};
+    if (!read_first_line("/proc/sys/net/ipv4/ip_forward", val, sizeof(val))) {
+        set_result(r, DR_WARN, "cannot read ip_forward");
+        return;
+    }
+
+    char policy[MAX_LINE_LEN] = {0};
+    net_exec_cmd("iptables -S FORWARD 2>/dev/null | head -1",
+                 policy, sizeof(policy));
+
+    if (strstr(policy, "-P FORWARD DROP"))
+        set_result(r, DR_WARN, "ip_forward=%s, FORWARD policy is DROP "
+                   "(Docker/firewalld?) — hotspot rules are appended after it",
+                   val);
+    else
+        set_result(r, DR_OK, "ip_forward=%s (enabled while hotspot runs)", val);
+}
+
+static void check_nat(DoctorResult *r)
+{
+    char out[4096] = {0};
+    char found[MAX_LINE_LEN] = {0};
+
+    net_exec_cmd("iptables -t nat -S POSTROUTING 2>/dev/null", out, sizeof(out));
+    if (strstr(out, AP_SUBNET "."))
+        append_msg(found, sizeof(found), "iptables nat rule for " AP_SUBNET ".0/24");
+
+    out[0] = '\0';
+    net_exec_cmd("iptables -S FORWARD 2>/dev/null | grep -E ' -[io] ap[0-3] '",
+                 out, sizeof(out));
+    if (out[0])
+        append_msg(found, sizeof(found), "leftover FORWARD rules for ap0-ap3");
+
+    if (net_exec_silent("iptables -t nat -S " FW_CHAIN_NAT " >/dev/null 2>&1") == 0 ||
+        net_exec_silent("iptables -S " FW_CHAIN_FWD " >/dev/null 2>&1") == 0)
+        append_msg(found, sizeof(found),
+                   "leftover " FW_CHAIN_FWD "/" FW_CHAIN_NAT " chains");
+
+    out[0] = '\0';
+    net_exec_cmd("nft list ruleset 2>/dev/null | grep -c '" AP_SUBNET "\\.'",
+                 out, sizeof(out));
+    if (atoi(out) > 0)
+        append_msg(found, sizeof(found), "nftables rules for " AP_SUBNET ".0/24");
+
+    if (found[0])
+        set_result(r, DR_WARN, "%s", found);
+    else
+        set_result(r, DR_OK, "no conflicting NAT rules");
+}
+
+static void check_stale(DoctorResult *r)
+{
+    static const char *names[] = { "ap0", "ap1", "ap2", "ap3" };
+    char found[MAX_LINE_LEN] = {0};
+
+    for (size_t i = 0; i < sizeof(names) / sizeof(names[0]); i++) {
+        char path[MAX_PATH_LEN];
+        struct stat st;
+        snprintf(path, sizeof(path), "/sys/class/net/%s", names[i]);
+        if (stat(path, &st) == 0) append_msg(found, sizeof(found), names[i]);
+    }
+
+    if (find_process("hostapd")) append_msg(found, sizeof(found), "hostapd running");
+    if (access("/run/netns/" NETNS_NAME, F_OK) == 0)
+        append_msg(found, sizeof(found), "namespace " NETNS_NAME);
+
+    struct stat st;
+    if (stat(LEGACY_HOSTAPD_CONF, &st) == 0)
+        append_msg(found, sizeof(found), "world-readable config in /tmp");
+
+    if (found[0])
+        set_result(r, DR_WARN, "leftovers from a previous run: %s", found);
+    else
+        set_result(r, DR_OK, "no stale interfaces or daemons");
+}
+
+/* ── Runner ──────────────────────────────────────────────────────────── */
+
+static void *check_thread(void *arg)
+{
+    DoctorResult *r = arg;
+    struct timespec a, b;
+
+    clock_gettime(CLOCK_MONOTONIC, &a);
+    r->fn(r);
+    clock_gettime(CLOCK_MONOTONIC, &b);
+    r->elapsed_ms = (b.tv_sec - a.tv_sec) * 1e3 + (b.tv_nsec - a.tv_nsec) / 1e6;
+    return NULL;
+}
+
+static int by_severity(const void *a, const void *b)
+{
+    const DoctorResult *ra = a, *rb = b;
+    if (ra->severity != rb->severity)
+        return (int)ra->severity - (int)rb->severity;
+    return ra->order - rb->order;
+}
+
+int doctor_run(void)
+{
+    DoctorResult checks[] = {
+        { .name = "Privileges",     .fn = check_root },
+        { .name = "Dependencies",   .fn = check_deps },
+        { .name = "rfkill",         .fn = check_rfkill },
+        { .name = "AP/STA support", .fn = check_interface },
+        { .name = "Channel/regdom", .fn = check_channel },
+        { .name = "Net managers",   .fn = check_managers },
+        { .name = "Ports 53/67",    .fn = check_ports },
+        { .name = "IP forwarding",  .fn = check_forwarding },
+        { .name = "NAT rules",      .fn = check_nat },
+        { .name = "Stale state",    .fn = check_stale },
+    };
+    int n = (int)(sizeof(checks) / sizeof(checks[0]));
+
+    struct timespec a, b;
+    clock_gettime(CLOCK_MONOTONIC, &a);
+
+    for (int i = 0; i < n; i++) {
+        checks[i].order    = i;
+        checks[i].severity = DR_WARN;
+        snprintf(checks[i].message, sizeof(checks[i].message), "check did not run");
+        checks[i].threaded = (pthread_create(&checks[i].thread, NULL,
+                                             check_thread, &checks[i]) == 0);
+        if (!checks[i].threaded) check_thread(&checks[i]);
+    }
+    for (int i = 0; i < n; i++) {
+        if (checks[i].threaded) pthread_join(checks[i].thread, NULL);
+    }
+
+    clock_gettime(CLOCK_MONOTONIC, &b);
+    double total = (b.tv_sec - a.tv_sec) * 1e3 + (b.tv_nsec - a.tv_nsec) / 1e6;
+
+    qsort(checks, (size_t)n, sizeof(DoctorResult), by_severity);
+
+    int fails = 0, warns = 0;
+    printf("  Doctor report — %d checks in %.0f ms\n\n", n, total);
+    for (int i = 0; i < n; i++) {
+        const char *tag;
+        switch (checks[i].severity) {
+            case DR_FAIL: tag = "✗ FAIL"; fails++; break;
+            case DR_WARN: tag = "⚠ WARN"; warns++; break;
+            default:      tag = "✓ OK  "; break;
+        }
+        printf("  %s  %-15s %5.0f ms  %s\n", tag, checks[i].name,
+               checks[i].elapsed_ms, checks[i].message);
+    }
+
+    printf("\n  %d failed, %d warning(s).\n\n", fails, warns);
+    return fails > 0 ? 1 : 0;
+}
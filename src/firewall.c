@@ -0,0 +1,184 @@
+/*
+ * firewall.c - NAT rule backends for Linux Hotspot Enabler
+ *
+ * iptables-restore --noflush commits each table atomically and keeps
+ * everything else in it. Declaring a user chain that already exists
+ * flushes it, so a leftover HOTSPOT_* chain from a crashed run is simply
+ * refilled. Teardown deletes the jumps and chains in one transaction;
+ * if that fails (a jump already gone, or duplicated by hand) it falls
+ * back to single commands that tolerate any partial state.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+
+#include "firewall.h"
+#include "net_utils.h"
+
+/* ── Backend selection ───────────────────────────────────────────────── */
+
+bool fw_parse_backend(const char *value, FwBackend *backend)
+{
+    if (strcasecmp(value, "auto") == 0)     { *backend = FW_BACKEND_AUTO;     return true; }
+    if (strcasecmp(value, "iptables") == 0) { *backend = FW_BACKEND_IPTABLES; return true; }
+    if (strcasecmp(value, "restore") == 0)  { *backend = FW_BACKEND_RESTORE;  return true; }
+    return false;
+}
+
+const char *fw_backend_name(FwBackend backend)
+{
+    switch (backend) {
+        case FW_BACKEND_IPTABLES: return "iptables";
+        case FW_BACKEND_RESTORE:  return "restore";
+        default:                  return "auto";
+    }
+}
+
+FwBackend fw_resolve(FwBackend backend)
+{
+    if (backend != FW_BACKEND_AUTO) return backend;
+    return net_exec_silent("which iptables-restore >/dev/null 2>&1") == 0
+           ? FW_BACKEND_RESTORE : FW_BACKEND_IPTABLES;
+}
+
+/* ── iptables-restore ────────────────────────────────────────────────── */
+
+static bool run_restore(const char *input)
+{
+    FILE *fp = popen("iptables-restore --noflush 2>/dev/null", "w");
+    if (!fp) return false;
+    fputs(input, fp);
+    return pclose(fp) == 0;
+}
+
+static bool restore_setup(const char *ap_iface, const char *uplink)
+{
+    char input[1024];
+    snprintf(input, sizeof(input),
+             "*filter\n"
+             ":" FW_CHAIN_FWD " - [0:0]\n"
+             "-A " FW_CHAIN_FWD " -i %s -o %s -m state --state RELATED,ESTABLISHED -j ACCEPT\n"
+             "-A " FW_CHAIN_FWD " -i %s -o %s -j ACCEPT\n"
+             "-A FORWARD -j " FW_CHAIN_FWD "\n"
+             "COMMIT\n"
+             "*nat\n"
+             ":" FW_CHAIN_NAT " - [0:0]\n"
+             "-A " FW_CHAIN_NAT " -o %s -j MASQUERADE\n"
+             "-A POSTROUTING -j " FW_CHAIN_NAT "\n"
+             "COMMIT\n",
+             uplink, ap_iface, ap_iface, uplink, uplink);
+    return run_restore(input);
+}
+
+static void restore_teardown(void)
+{
+    static const char input[] =
+        "*filter\n"
+        "-D FORWARD -j " FW_CHAIN_FWD "\n"
+        "-F " FW_CHAIN_FWD "\n"
+        "-X " FW_CHAIN_FWD "\n"
+        "COMMIT\n"
+        "*nat\n"
+        "-D POSTROUTING -j " FW_CHAIN_NAT "\n"
+        "-F " FW_CHAIN_NAT "\n"
+        "-X " FW_CHAIN_NAT "\n"
+        "COMMIT\n";
+    if (run_restore(input)) return;
+
+    /* Partial state: drop every jump, then the chains, one by one */
+    for (int i = 0; i < 8 &&
+         net_exec_silent("iptables -D FORWARD -j " FW_CHAIN_FWD " 2>/dev/null") == 0; i++)
+        ;
+    for (int i = 0; i < 8 &&
+         net_exec_silent("iptables -t nat -D POSTROUTING -j " FW_CHAIN_NAT " 2>/dev/null") == 0; i++)
+        ;
+    net_exec_silent("iptables -F " FW_CHAIN_FWD " 2>/dev/null; "
+                    "iptables -X " FW_CHAIN_FWD " 2>/dev/null; "
+                    "iptables -t nat -F " FW_CHAIN_NAT " 2>/dev/null; "
+                    "iptables -t nat -X " FW_CHAIN_NAT " 2>/dev/null");
+}
+
+/* ── One process per rule ────────────────────────────────────────────── */
+
+static bool iptables_setup(const char *ap_iface, const char *uplink)
+{
+    char cmd[MAX_CMD_LEN];
+    bool ok = true;
+
+    /* NAT masquerade */
+    snprintf(cmd, sizeof(cmd),
+             "iptables -t nat -A POSTROUTING -o %s -j MASQUERADE", uplink);
+    ok &= net_exec_silent(cmd) == 0;
+
+    /* Allow forwarding */
+    snprintf(cmd, sizeof(cmd),
+             "iptables -A FORWARD -i %s -o %s -m state "
+             "--state RELATED,ESTABLISHED -j ACCEPT", uplink, ap_iface);
+    ok &= net_exec_silent(cmd) == 0;
+
+    snprintf(cmd, sizeof(cmd),
+             "iptables -A FORWARD -i %s -o %s -j ACCEPT", ap_iface, uplink);
+    ok &= net_exec_silent(cmd) == 0;
+
+    return ok;
+}
+
+static void iptables_teardown(const char *ap_iface, const char *uplink)
+{
+    char cmd[MAX_CMD_LEN];
+
+    snprintf(cmd, sizeof(cmd),
+             "iptables -t nat -D POSTROUTING -o %s -j MASQUERADE 2>/dev/null",
+             uplink);
+    net_exec_silent(cmd);
+
+    snprintf(cmd, sizeof(cmd),
+             "iptables -D FORWARD -i %s -o %s -m state "
+             "--state RELATED,ESTABLISHED -j ACCEPT 2>/dev/null",
+             uplink, ap_iface);
+    net_exec_silent(cmd);
+
+    snprintf(cmd, sizeof(cmd),
+             "iptables -D FORWARD -i %s -o %s -j ACCEPT 2>/dev/null",
+             ap_iface, uplink);
+    net_exec_silent(cmd);
+}
+
+/* ── NAT rules ───────────────────────────────────────────────────────── */
+
+bool fw_nat_setup(FwBackend backend, const char *ap_iface, const char *uplink,
+                  char *err, size_t errsize)
+{
+    if (fw_resolve(backend) == FW_BACKEND_RESTORE) {
+        if (restore_setup(ap_iface, uplink)) return true;
+        snprintf(err, errsize, "iptables-restore rejected the hotspot chains");
+        return false;
+    }
+    if (iptables_setup(ap_iface, uplink)) return true;
+    snprintf(err, errsize, "iptables rejected a NAT rule");
+    return false;
+}
+
+void fw_nat_teardown(FwBackend backend, const char *ap_iface, const char *uplink)
+{
+    if (fw_resolve(backend) == FW_BACKEND_RESTORE)
+        restore_teardown();
+    else
+        iptables_teardown(ap_iface, uplink);
+}
+
+bool fw_nat_present(FwBackend backend, const char *uplink)
+{
+    char cmd[MAX_CMD_LEN];
+    if (fw_resolve(backend) == FW_BACKEND_RESTORE)
+        snprintf(cmd, sizeof(cmd),
+                 "iptables -t nat -C " FW_CHAIN_NAT " -o %s -j MASQUERADE 2>/dev/null",
+                 uplink);
+    else
+        snprintf(cmd, sizeof(cmd),
+                 "iptables -t nat -C POSTROUTING -o %s -j MASQUERADE 2>/dev/null",
+                 uplink);
+    return net_exec_silent(cmd) == 0;
+}
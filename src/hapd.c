@@ -0,0 +1,166 @@
+/*
+ * hapd.c - Persistent hostapd for Linux Hotspot Enabler
+ *
+ * The global control interface is a Unix datagram socket; hostapd
+ * answers to the sender's address, so the client binds a path of its
+ * own. A filesystem path rather than an abstract name: abstract names
+ * are per network namespace, and with isolation hostapd runs in one.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <poll.h>
+#include <signal.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+
+#include "hapd.h"
+#include "fileio.h"
+
+#define HAPD_START_POLLS  30      /* x 100 ms for the socket to answer */
+
+/* ── Global control socket ───────────────────────────────────────────── */
+
+static bool set_addr(struct sockaddr_un *addr, const char *path)
+{
+    memset(addr, 0, sizeof(*addr));
+    addr->sun_family = AF_UNIX;
+    if (strlen(path) >= sizeof(addr->sun_path)) return false;
+    strcpy(addr->sun_path, path);
+    return true;
+}
+
+bool hapd_request(const char *cmd, char *reply, size_t size, int timeout_ms)
+{
+    struct sockaddr_un local, dest;
+    char path[sizeof(local.sun_path)];
+
+    snprintf(path, sizeof(path), HOTSPOT_RUN_DIR "/hapd-%d", (int)getpid());
+    if (!set_addr(&local, path) || !set_addr(&dest, HAPD_GLOBAL_PATH))
+        return false;
+
+    int fd = socket(AF_UNIX, SOCK_DGRAM | SOCK_CLOEXEC, 0);
+    if (fd < 0) return false;
+
+    bool ok = false;
+    unlink(path);
+    if (bind(fd, (struct sockaddr *)&local, sizeof(local)) == 0 &&
+        connect(fd, (struct sockaddr *)&dest, sizeof(dest)) == 0 &&
+        send(fd, cmd, strlen(cmd), 0) == (ssize_t)strlen(cmd)) {
+        struct pollfd pfd = { .fd = fd, .events = POLLIN };
+        int rc;
+        while ((rc = poll(&pfd, 1, timeout_ms)) < 0 && errno == EINTR)
+            ;
+        ssize_t n = rc > 0 ? recv(fd, reply, size - 1, 0) : -1;
+        if (n >= 0) {
+            while (n > 0 && (reply[n - 1] == '\n' || reply[n - 1] == '\r'))
+                n--;
+            reply[n] = '\0';
+            ok = true;
+        }
+    }
+    close(fd);
+    unlink(path);
+    return ok;
+}
+
+static bool hapd_ping(int timeout_ms)
+{
+    char reply[16];
+    return hapd_request("PING", reply, sizeof(reply), timeout_ms) &&
+           strcmp(reply, "PONG") == 0;
+}
+
+/* ── Daemon ──────────────────────────────────────────────────────────── */
+
+static pid_t read_pidfile(void)
+{
+    char buf[32];
+    if (!fio_read_file(HAPD_PID_PATH, buf, sizeof(buf))) return 0;
+    pid_t pid = (pid_t)atoi(buf);
+    return pid > 0 && kill(pid, 0) == 0 ? pid : 0;
+}
+
+pid_t hapd_daemon_pid(void)
+{
+    return hapd_ping(500) ? read_pidfile() : 0;
+}
+
+pid_t hapd_daemon_start(const char *exec_prefix, const char *log_path,
+                        char *err, size_t errsize)
+{
+    pid_t pid = hapd_daemon_pid();
+    if (pid > 0) return pid;
+
+    /* A socket nobody answers on, or a daemon we lost the pid of */
+    hapd_daemon_stop();
+
+    char cmd[MAX_CMD_LEN];
+    snprintf(cmd, sizeof(cmd),
+             "%shostapd -B -g %s -P %s -f %s >/dev/null 2>&1",
+             exec_prefix, HAPD_GLOBAL_PATH, HAPD_PID_PATH, log_path);
+    if (net_exec_silent(cmd) != 0) {
+        snprintf(err, errsize, "hostapd -g did not start");
+        return 0;
+    }
+
+    for (int i = 0; i < HAPD_START_POLLS; i++) {
+        if ((pid = hapd_daemon_pid()) > 0) return pid;
+        usleep(100000);
+    }
+    snprintf(err, errsize, "hostapd global socket %s does not answer",
+             HAPD_GLOBAL_PATH);
+    hapd_daemon_stop();
+    return 0;
+}
+
+void hapd_daemon_stop(void)
+{
+    char reply[16];
+    pid_t pid = read_pidfile();
+
+    hapd_request("TERMINATE", reply, sizeof(reply), 500);
+    if (pid > 0) {
+        for (int i = 0; i < 30 && kill(pid, 0) == 0; i++)
+            usleep(100000);
+        if (kill(pid, 0) == 0) {
+            kill(pid, SIGKILL);
+            usleep(100000);
+        }
+    }
+
+    /* hostapd removes both itself unless it was killed */
+    unlink(HAPD_GLOBAL_PATH);
+    unlink(HAPD_PID_PATH);
+}
+
+/* ── Interfaces ──────────────────────────────────────────────────────── */
+
+bool hapd_add(const char *iface, const char *conf_path,
+              char *err, size_t errsize)
+{
+    char cmd[MAX_CMD_LEN], reply[64];
+
+    snprintf(cmd, sizeof(cmd), "ADD %s config=%s", iface, conf_path);
+    if (!hapd_request(cmd, reply, sizeof(reply), HAPD_REPLY_MS)) {
+        snprintf(err, errsize, "no reply to ADD %s", iface);
+        return false;
+    }
+    if (strcmp(reply, "OK") != 0) {
+        snprintf(err, errsize, "ADD %s: %s", iface, reply);
+        return false;
+    }
+    return true;
+}
+
+bool hapd_remove(const char *iface)
+{
+    char cmd[MAX_CMD_LEN], reply[64];
+
+    snprintf(cmd, sizeof(cmd), "REMOVE %s", iface);
+    return hapd_request(cmd, reply, sizeof(reply), HAPD_REPLY_MS) &&
+           strcmp(reply, "OK") == 0;
+}
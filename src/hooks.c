@@ -0,0 +1,312 @@
+/*
+ * hooks.c - Asynchronous event hooks for Linux Hotspot Enabler
+ *
+ * hooks_emit() only formats the payload and appends it to a bounded
+ * ring under a mutex. Worker threads pop jobs, fork /bin/sh -c with the
+ * payload on stdin and reap the child with a deadline; a hook that
+ * overruns is killed together with its process group.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdarg.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <signal.h>
+#include <errno.h>
+#include <time.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+
+#include "hooks.h"
+
+#define HOOK_DRAIN_MS  2000
+
+/* ── Event Names ─────────────────────────────────────────────────────── */
+
+static const char *event_names[HOOK_EVENT_COUNT] = {
+    [HOOK_HOTSPOT_STARTED] = "hotspot_started",
+    [HOOK_HOTSPOT_STOPPED] = "hotspot_stopped",
+    [HOOK_CLIENT_JOINED]   = "client_joined",
+    [HOOK_CLIENT_LEFT]     = "client_left",
+    [HOOK_UPLINK_CHANGED]  = "uplink_changed",
+    [HOOK_DAEMON_CRASHED]  = "daemon_crashed",
+};
+
+const char *hooks_event_name(HookEvent ev)
+{
+    if (ev < 0 || ev >= HOOK_EVENT_COUNT) return "unknown";
+    return event_names[ev];
+}
+
+bool hooks_event_from_name(const char *name, HookEvent *ev)
+{
+    for (int i = 0; i < HOOK_EVENT_COUNT; i++) {
+        if (strcmp(name, event_names[i]) == 0) {
+            *ev = (HookEvent)i;
+            return true;
+        }
+    }
+    return false;
+}
+
+/* ── Registry ────────────────────────────────────────────────────────── */
+
+void hooks_registry_default(HookRegistry *reg)
+{
+    memset(reg, 0, sizeof(HookRegistry));
+    reg->default_timeout_s = 10;
+    reg->workers           = 2;
+    reg->queue_limit       = 32;
+}
+
+bool hooks_registry_add(HookRegistry *reg, HookEvent ev, const char *command)
+{
+    if (ev < 0 || ev >= HOOK_EVENT_COUNT) return false;
+    if (reg->count[ev] >= HOOK_MAX_PER_EVENT) return false;
+    if (command[0] == '\0') return false;
+
+    snprintf(reg->commands[ev][reg->count[ev]], MAX_CMD_LEN, "%s", command);
+    reg->count[ev]++;
+    return true;
+}
+
+/* ── Pool State ──────────────────────────────────────────────────────── */
+
+typedef struct {
+    const char *command;        /* points into g_hooks.reg */
+    int         timeout_s;
+    char        payload[HOOK_PAYLOAD_LEN];
+} HookJob;
+
+static struct {
+    atomic_bool     running;
+    HookRegistry    reg;
+    pthread_t       threads[HOOK_MAX_WORKERS];
+    int             nthreads;
+
+    pthread_mutex_t lock;
+    pthread_cond_t  cond;
+    HookJob         queue[HOOK_MAX_QUEUE];
+    int             head;
+    int             len;
+    int             active;             /* hooks currently running */
+    HookStats       stats;
+} g_hooks = {
+    .lock = PTHREAD_MUTEX_INITIALIZER,
+    .cond = PTHREAD_COND_INITIALIZER,
+};
+
+/* ── Running One Hook ────────────────────────────────────────────────── */
+
+typedef enum { RUN_OK, RUN_FAILED, RUN_TIMEOUT } RunResult;
+
+static RunResult run_hook(const HookJob *job)
+{
+    int pfd[2];
+    if (pipe2(pfd, O_CLOEXEC) < 0) return RUN_FAILED;
+
+    pid_t pid = fork();
+    if (pid < 0) {
+        close(pfd[0]);
+        close(pfd[1]);
+        return RUN_FAILED;
+    }
+
+    if (pid == 0) {
+        /* Child: own process group so a timeout kills the whole tree */
+        sigset_t none;
+        sigemptyset(&none);
+        sigprocmask(SIG_SETMASK, &none, NULL);
+        setsid();
+
+        dup2(pfd[0], STDIN_FILENO);
+        int devnull = open("/dev/null", O_WRONLY);
+        if (devnull >= 0) {
+            dup2(devnull, STDOUT_FILENO);
+            dup2(devnull, STDERR_FILENO);
+        }
+        execl("/bin/sh", "sh", "-c", job->command, (char *)NULL);
+        _exit(127);
+    }
+
+    close(pfd[0]);
+
+    /* Payload is far below PIPE_BUF, so this cannot block */
+    size_t len = strlen(job->payload);
+    if (write(pfd[1], job->payload, len) < 0) { /* hook ignored stdin */ }
+    close(pfd[1]);
+
+    struct timespec start, now;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+
+    for (;;) {
+        int wstatus;
+        pid_t r = waitpid(pid, &wstatus, WNOHANG);
+        if (r == pid) {
+            return (WIFEXITED(wstatus) && WEXITSTATUS(wstatus) == 0) ?
+                   RUN_OK : RUN_FAILED;
+        }
+        if (r < 0 && errno != EINTR) return RUN_FAILED;
+
+        clock_gettime(CLOCK_MONOTONIC, &now);
+        if (now.tv_sec - start.tv_sec >= job->timeout_s || !g_hooks.running) {
+            kill(-pid, SIGKILL);
+            kill(pid, SIGKILL);
+            waitpid(pid, NULL, 0);
+            return RUN_TIMEOUT;
+        }
+        usleep(20000);
+    }
+}
+
+/* ── Workers ─────────────────────────────────────────────────────────── */
+
+static void *hook_worker(void *arg)
+{
+    (void)arg;
+    HookJob job;
+
+    pthread_mutex_lock(&g_hooks.lock);
+    for (;;) {
+        while (g_hooks.running && g_hooks.len == 0)
+            pthread_cond_wait(&g_hooks.cond, &g_hooks.lock);
+        if (!g_hooks.running) break;
+
+        job = g_hooks.queue[g_hooks.head];
+        g_hooks.head = (g_hooks.head + 1) % HOOK_MAX_QUEUE;
+        g_hooks.len--;
+        g_hooks.stats.queued = g_hooks.len;
+        g_hooks.active++;
+        pthread_mutex_unlock(&g_hooks.lock);
+
+        RunResult res = run_hook(&job);
+
+        pthread_mutex_lock(&g_hooks.lock);
+        g_hooks.active--;
+        switch (res) {
+            case RUN_OK:      g_hooks.stats.completed++; break;
+            case RUN_FAILED:  g_hooks.stats.failed++;    break;
+            case RUN_TIMEOUT: g_hooks.stats.timed_out++; break;
+        }
+    }
+    pthread_mutex_unlock(&g_hooks.lock);
+
+    return NULL;
+}
+
+bool hooks_start(const HookRegistry *reg)
+{
+    if (g_hooks.running) return true;
+
+    g_hooks.reg = *reg;
+    memset(&g_hooks.stats, 0, sizeof(g_hooks.stats));
+    g_hooks.head = g_hooks.len = 0;
+
+    for (int i = 0; i < HOOK_EVENT_COUNT; i++)
+        g_hooks.stats.configured += reg->count[i];
+    if (g_hooks.stats.configured == 0) return true;
+
+    int workers = reg->workers;
+    if (workers < 1) workers = 1;
+    if (workers > HOOK_MAX_WORKERS) workers = HOOK_MAX_WORKERS;
+    if (g_hooks.reg.queue_limit < 1) g_hooks.reg.queue_limit = 1;
+    if (g_hooks.reg.queue_limit > HOOK_MAX_QUEUE)
+        g_hooks.reg.queue_limit = HOOK_MAX_QUEUE;
+
+    /* Workers must never take SIGINT/SIGWINCH meant for the main loop */
+    sigset_t all, old;
+    sigfillset(&all);
+    pthread_sigmask(SIG_SETMASK, &all, &old);
+
+    g_hooks.running = true;
+    g_hooks.nthreads = 0;
+    for (int i = 0; i < workers; i++) {
+        if (pthread_create(&g_hooks.threads[i], NULL, hook_worker, NULL) != 0)
+            break;
+        g_hooks.nthreads++;
+    }
+
+    pthread_sigmask(SIG_SETMASK, &old, NULL);
+
+    if (g_hooks.nthreads == 0) {
+        g_hooks.running = false;
+        return false;
+    }
+    return true;
+}
+
+/* ── Emit ────────────────────────────────────────────────────────────── */
+
+void hooks_emit(HookEvent ev, const char *fields_fmt, ...)
+{
+    if (!g_hooks.running || ev < 0 || ev >= HOOK_EVENT_COUNT) return;
+    if (g_hooks.reg.count[ev] == 0) return;
+
+    char fields[HOOK_PAYLOAD_LEN - 96] = {0};
+    if (fields_fmt && fields_fmt[0]) {
+        va_list args;
+        va_start(args, fields_fmt);
+        vsnprintf(fields, sizeof(fields), fields_fmt, args);
+        va_end(args);
+    }
+
+    char payload[HOOK_PAYLOAD_LEN];
+    snprintf(payload, sizeof(payload), "{\"event\":\"%s\",\"time\":%ld%s%s}\n",
+             event_names[ev], (long)time(NULL), fields[0] ? "," : "", fields);
+
+    int timeout = g_hooks.reg.timeout_s[ev] > 0 ?
+                  g_hooks.reg.timeout_s[ev] : g_hooks.reg.default_timeout_s;
+
+    pthread_mutex_lock(&g_hooks.lock);
+    for (int i = 0; i < g_hooks.reg.count[ev]; i++) {
+        if (g_hooks.len >= g_hooks.reg.queue_limit) {
+            g_hooks.stats.dropped++;
+            continue;
+        }
+        HookJob *job = &g_hooks.queue[(g_hooks.head + g_hooks.len) % HOOK_MAX_QUEUE];
+        job->command   = g_hooks.reg.commands[ev][i];
+        job->timeout_s = timeout;
+        memcpy(job->payload, payload, sizeof(payload));
+        g_hooks.len++;
+    }
+    g_hooks.stats.queued = g_hooks.len;
+    pthread_cond_broadcast(&g_hooks.cond);
+    pthread_mutex_unlock(&g_hooks.lock);
+}
+
+/* ── Stats / Shutdown ────────────────────────────────────────────────── */
+
+void hooks_get_stats(HookStats *stats)
+{
+    pthread_mutex_lock(&g_hooks.lock);
+    *stats = g_hooks.stats;
+    pthread_mutex_unlock(&g_hooks.lock);
+}
+
+void hooks_stop(void)
+{
+    if (!g_hooks.running) return;
+
+    /* Give already-queued hooks (e.g. hotspot_stopped on exit) a moment */
+    for (int waited = 0; waited < HOOK_DRAIN_MS; waited += 50) {
+        pthread_mutex_lock(&g_hooks.lock);
+        bool idle = (g_hooks.len == 0 && g_hooks.active == 0);
+        pthread_mutex_unlock(&g_hooks.lock);
+        if (idle) break;
+        usleep(50000);
+    }
+
+    pthread_mutex_lock(&g_hooks.lock);
+    g_hooks.running = false;
+    g_hooks.len = 0;
+    pthread_cond_broadcast(&g_hooks.cond);
+    pthread_mutex_unlock(&g_hooks.lock);
+
+    for (int i = 0; i < g_hooks.nthreads; i++)
+        pthread_join(g_hooks.threads[i], NULL);
+    g_hooks.nthreads = 0;
+}
@@ -6,19 +6,42 @@
  *
  * Flow: create ap0 → NM unmanage → hostapd brings it up →
  *       assign IP → dnsmasq → iptables NAT
+ *
+ * Bridge uplink: hostapd adds ap0 to the bridge; no IP, dnsmasq or NAT.
+ * Proxy-ARP uplink: ap0 borrows the uplink IP, dnsmasq only relays DHCP.
  */
 
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <strings.h>
 #include <unistd.h>
 #include <signal.h>
 #include <time.h>
 #include <errno.h>
+#include <fcntl.h>
 #include <sys/types.h>
+#include <sys/stat.h>
 #include <sys/wait.h>
 
 #include "hotspot.h"
+#include "hooks.h"
+#include "fileio.h"
+#include "state.h"
+#include "oui.h"
+#include "netns.h"
+#include "hapd.h"
+
+/* This process started (or adopted) the persistent hostapd */
+static bool g_hapd_owned = false;
+
+/* dnsmasq kept running between starts, and the config it was given */
+static struct {
+    pid_t    pid;
+    uint64_t conf_hash;
+} g_dnsmasq;
+
+static void kill_process(pid_t pid, const char *name);
 
 /* ── Initialization ──────────────────────────────────────────────────── */
 
@@ -29,6 +52,36 @@ void hotspot_default_config(HotspotConfig *config)
     config->channel     = 0;  /* auto — match client */
     config->max_clients = 10;
     config->hidden      = false;
+    config->security    = SEC_WPA2;
+    config->sae_anti_clogging = 5;   /* hostapd's default */
+    procsched_default(&config->sched);
+    steer_default(&config->steer);
+    config->ap_phy[0]   = '\0';  /* share the uplink radio */
+    config->dfs_policy  = DFS_CAC;
+    uplink_default(&config->uplink);
+    config->nat_backend = FW_BACKEND_AUTO;
+    connlimit_default(&config->connlimit);
+    config->sta_tune    = true;
+    recorder_default(&config->recorder);
+    coord_default(&config->coord);
+}
+
+static const char *const g_security_names[] = { "wpa2", "transition", "sae" };
+
+const char *hotspot_security_name(SecurityMode mode)
+{
+    return (unsigned)mode < 3 ? g_security_names[mode] : "?";
+}
+
+bool hotspot_parse_security(const char *name, SecurityMode *mode)
+{
+    for (int i = 0; i < 3; i++) {
+        if (strcasecmp(name, g_security_names[i]) == 0) {
+            *mode = (SecurityMode)i;
+            return true;
+        }
+    }
+    return false;
 }
 
 void hotspot_init(HotspotStatus *status)
@@ -37,6 +90,10 @@ void hotspot_init(HotspotStatus *status)
     status->state = HS_STATE_STOPPED;
     strncpy(status->ap_iface, AP_IFACE_NAME, MAX_IFACE_NAME - 1);
     hotspot_default_config(&status->config);
+    status->uplink_saved.bridge_nf_call = -1;
+    status->uplink_saved.sta_proxy_arp  = -1;
+    statune_init(&status->sta_saved);
+    connlimit_init(&status->connlimit_saved);
 }
 
 /* ── Generate hostapd config ─────────────────────────────────────────── */
@@ -89,18 +146,346 @@ static void get_country_code(char *cc, size_t cc_size)
     strncpy(cc, "US", cc_size - 1);
 }
 
-static bool generate_hostapd_conf(const HotspotStatus *status, bool minimal)
+/* Channel: always match the WiFi client for AP/STA concurrency */
+static int pick_channel(const HotspotStatus *status)
 {
-    FILE *fp = fopen(HOSTAPD_CONF_PATH, "w");
-    if (!fp) return false;
-
-    /* Channel: always match the WiFi client for AP/STA concurrency */
     int channel = status->config.channel;
     if (channel == 0) {
         channel = status->wifi.channel;
         if (channel <= 0) channel = 6; /* safe fallback */
     }
+    return channel;
+}
+
+/* Radio the AP interface lives on: a dedicated one, or the uplink's */
+static const char *ap_phy_name(const HotspotStatus *status)
+{
+    return status->config.ap_phy[0] ? status->config.ap_phy : status->phy;
+}
+
+/* AP and uplink STA on the same radio (STA scans take the AP off-channel) */
+static bool shares_uplink_radio(const HotspotStatus *status)
+{
+    return strcmp(ap_phy_name(status), status->phy) == 0;
+}
+
+/* Command prefix for anything that touches the AP interface */
+static const char *ap_exec(const HotspotStatus *status)
+{
+    return status->netns ? NETNS_EXEC : "";
+}
+
+/* Where AP traffic enters the host: ap0, or the veth from the namespace */
+static const char *nat_iface(const HotspotStatus *status)
+{
+    return status->netns ? NETNS_VETH_HOST : status->ap_iface;
+}
+
+/* ── DFS ─────────────────────────────────────────────────────────────── */
+
+static int chan_to_freq(int ch)
+{
+    if (ch == 14) return 2484;
+    if (ch < 14)  return 2407 + 5 * ch;
+    return 5000 + 5 * ch;
+}
+
+static int freq_to_chan(int freq)
+{
+    if (freq == 2484) return 14;
+    if (freq < 5000)  return (freq - 2407) / 5;
+    return (freq - 5000) / 5;
+}
+
+/* CAC is 10 minutes on the weather-radar channels, 60 s elsewhere */
+static int cac_seconds(int ch)
+{
+    return (ch >= 120 && ch <= 128) ? 600 : 60;
+}
+
+/* Nearest 5 GHz channel the radio may beacon on without CAC; 0 if none */
+static int pick_non_dfs_channel(const char *phy, int near)
+{
+    static const int candidates[] = { 36, 40, 44, 48, 149, 153, 157, 161, 165 };
+    int best = 0, best_dist = 1000;
+
+    for (size_t i = 0; i < sizeof(candidates) / sizeof(candidates[0]); i++) {
+        ChannelFlags f;
+        if (!net_get_channel_flags(phy, candidates[i], &f) ||
+            f.disabled || f.no_ir || f.radar) continue;
+        int dist = abs(candidates[i] - near);
+        if (dist < best_dist) {
+            best = candidates[i];
+            best_dist = dist;
+        }
+    }
+    return best;
+}
+
+/*
+ * Decide up front what to do if ap_channel needs radar detection:
+ * move to a non-DFS channel (only possible on a dedicated AP radio),
+ * or stay and let hostapd run the CAC. Reasons go to status->notice.
+ */
+static void plan_dfs(HotspotStatus *status)
+{
+    const char *phy = ap_phy_name(status);
+    int ch = status->ap_channel;
+    ChannelFlags f;
+
+    status->dfs     = false;
+    status->cac_end = 0;
+    if (!is_5ghz_channel(ch) || !net_get_channel_flags(phy, ch, &f) || !f.radar)
+        return;
+
+    if (status->config.dfs_policy == DFS_AVOID) {
+        int alt = status->config.ap_phy[0] ? pick_non_dfs_channel(phy, ch) : 0;
+        if (alt) {
+            snprintf(status->notice, sizeof(status->notice),
+                     "Channel %d needs a %d s radar check (DFS); using "
+                     "channel %d instead.", ch, cac_seconds(ch), alt);
+            status->ap_channel = alt;
+            return;
+        }
+        snprintf(status->notice, sizeof(status->notice),
+                 status->config.ap_phy[0]
+                     ? "Channel %d is DFS and no non-DFS 5 GHz channel is "
+                       "allowed; waiting for the radar check."
+                     : "Channel %d is DFS and the AP shares the uplink radio; "
+                       "waiting for the radar check (set ap_phy to avoid).",
+                 ch);
+    }
+    status->dfs = true;
+}
+
+/*
+ * Follow hostapd's DFS events in its log: CAC start/finish, radar hits
+ * (answered with an immediate switch to a non-DFS channel) and
+ * completed channel switches. Messages go to status->event.
+ */
+static void watch_hostapd_log(HotspotStatus *status)
+{
+    FILE *fp = fopen(HOSTAPD_LOG_PATH, "r");
+    if (!fp) return;
+    if (fseek(fp, status->log_pos, SEEK_SET) != 0) rewind(fp);
+
+    char line[MAX_LINE_LEN];
+    while (fgets(line, sizeof(line), fp)) {
+        char *p;
+        int val;
+
+        if ((p = strstr(line, "DFS-CAC-START")) != NULL) {
+            status->cac_end = time(NULL) + cac_seconds(status->ap_channel);
+            if ((p = strstr(p, "cac_time=")) && sscanf(p, "cac_time=%ds", &val) == 1)
+                status->cac_end = time(NULL) + val;
+        }
+        else if (strstr(line, "DFS-CAC-COMPLETED")) {
+            status->cac_end = 0;
+            snprintf(status->event, sizeof(status->event),
+                     "DFS radar check passed; AP is beaconing on channel %d.",
+                     status->ap_channel);
+        }
+        else if (strstr(line, "DFS-RADAR-DETECTED")) {
+            int alt = pick_non_dfs_channel(ap_phy_name(status), status->ap_channel);
+            if (alt) {
+                char cmd[MAX_CMD_LEN];
+                snprintf(cmd, sizeof(cmd),
+                         "hostapd_cli -p %s -i %s chan_switch 5 %d >/dev/null 2>&1",
+                         HOSTAPD_CTRL_DIR, status->ap_iface, chan_to_freq(alt));
+                bool ok = (net_exec_silent(cmd) == 0);
+                snprintf(status->event, sizeof(status->event),
+                         ok ? "Radar on channel %d: switching AP to channel %d."
+                            : "Radar on channel %d: switch to channel %d failed, "
+                              "hostapd will pick a channel.",
+                         status->ap_channel, alt);
+            } else {
+                snprintf(status->event, sizeof(status->event),
+                         "Radar on channel %d: hostapd is moving the AP.",
+                         status->ap_channel);
+            }
+        }
+        else if ((p = strstr(line, "AP-CSA-FINISHED")) &&
+                 (p = strstr(p, "freq=")) && sscanf(p, "freq=%d", &val) == 1) {
+            status->ap_channel = freq_to_chan(val);
+            status->dfs = false;
+            status->cac_end = 0;
+            ChannelFlags f;
+            if (net_get_channel_flags(ap_phy_name(status), status->ap_channel, &f))
+                status->dfs = f.radar;
+            snprintf(status->event, sizeof(status->event),
+                     "AP moved to channel %d.", status->ap_channel);
+        }
+    }
+    status->log_pos = ftell(fp);
+    fclose(fp);
+}
+
+/* ── Coordination ────────────────────────────────────────────────────── */
+
+static int g_admit_cap = -1;     /* max_num_sta set through hostapd_cli */
+
+/*
+ * Only a radio of our own may change channel for the neighbours, and
+ * only when the user left the channel to us (channel = 0)
+ */
+static bool coord_movable(const HotspotStatus *status)
+{
+    return status->config.ap_phy[0] && !shares_uplink_radio(status) &&
+           status->config.channel == 0;
+}
+
+/*
+ * Tell coordination which channels the AP radio may use. When ours may
+ * move, take the one of the planned band least used by peers (waits
+ * for them to be heard once).
+ */
+static void coord_plan_channel(HotspotStatus *status)
+{
+    static const int candidates[] = { 1, 6, 11, 36, 40, 44, 48,
+                                      149, 153, 157, 161 };
+    int allowed[16], n = 0, ranked[16];
+
+    if (!coord_running()) return;
+
+    for (size_t i = 0; i < sizeof(candidates) / sizeof(candidates[0]); i++) {
+        ChannelFlags f;
+        if (net_get_channel_flags(ap_phy_name(status), candidates[i], &f) &&
+            !f.disabled && !f.no_ir && !f.radar)
+            allowed[n++] = candidates[i];
+    }
+    if (n == 0) return;
+
+    coord_set_allowed(allowed, n);
+    if (coord_movable(status) &&
+        coord_rank_channels(is_5ghz_channel(status->ap_channel), ranked, 16) > 0)
+        status->ap_channel = ranked[0];
+}
+
+/*
+ * Announce our state, then act on the decisions: cap or release new
+ * clients (max_num_sta; probes go unanswered while full) and move off
+ * a shared channel. Failures go to status->event.
+ */
+static void coord_update(HotspotStatus *status)
+{
+    char cmd[MAX_CMD_LEN];
+
+    if (!coord_running()) return;
+    coord_set_local(status->config.ssid, status->ap_channel,
+                    status->client_count, status->config.max_clients,
+                    coord_movable(status));
+
+    int cap = coord_admit_cap();
+    if (cap != g_admit_cap) {
+        int limit = cap >= 0 && cap < status->config.max_clients
+                        ? cap : status->config.max_clients;
+        snprintf(cmd, sizeof(cmd),
+                 "hostapd_cli -p %s -i %s set max_num_sta %d >/dev/null 2>&1",
+                 HOSTAPD_CTRL_DIR, status->ap_iface, limit > 0 ? limit : 1);
+        if (net_exec_silent(cmd) == 0) g_admit_cap = cap;
+        else if (!status->event[0])
+            snprintf(status->event, sizeof(status->event),
+                     "Coordination: hostapd refused a client limit of %d.", limit);
+    }
+
+    int ch = coord_wanted_channel();
+    if (ch > 0) {
+        snprintf(cmd, sizeof(cmd),
+                 "hostapd_cli -p %s -i %s chan_switch 5 %d >/dev/null 2>&1",
+                 HOSTAPD_CTRL_DIR, status->ap_iface, chan_to_freq(ch));
+        if (net_exec_silent(cmd) == 0) {
+            status->ap_channel = ch;
+            coord_set_local(status->config.ssid, ch, status->client_count,
+                            status->config.max_clients, true);
+        } else {
+            snprintf(status->event, sizeof(status->event),
+                     "Coordination: switch to channel %d failed.", ch);
+        }
+    }
+}
+
+/* ── Config rendering ────────────────────────────────────────────────── */
+
+/*
+ * Configs are rendered in memory and only written when their FNV-1a
+ * hash changes, so a restart with the same settings does no config I/O.
+ */
+typedef struct {
+    FILE  *fp;
+    char  *text;
+    size_t len;
+} ConfBuf;
+
+static bool conf_begin(ConfBuf *cb)
+{
+    cb->text = NULL;
+    cb->len  = 0;
+    cb->fp   = open_memstream(&cb->text, &cb->len);
+    return cb->fp != NULL;
+}
+
+static bool conf_commit(ConfBuf *cb, const char *path, ConfFile *cf)
+{
+    fclose(cb->fp);
+    int ret = -1;
+    if (cb->text)
+        ret = fio_update_file(path, cb->text, cb->len, 0600, &cf->hash);
+    free(cb->text);
+    cf->changed = (ret != 0);
+    return ret >= 0;
+}
+
+/* ── hostapd config file ─────────────────────────────────────────────── */
+
+/*
+ * Key management. SAE costs an ECC exchange per join, so for join
+ * bursts: group 19 (P-256) only, the cheapest; H2E (sae_pwe) derives
+ * the password element once at startup instead of hunting-and-pecking
+ * per peer; past sae_anti_clogging_threshold open commits, peers must
+ * echo a token first, so spoofed commits cost no ECC work. hostapd
+ * caches SAE PMKSAs by default: a returning station skips SAE.
+ *
+ * The minimal (driver compatibility) config drops transition mode to
+ * WPA2, as some drivers cannot do the management frame protection SAE
+ * requires; SAE-only is kept as configured.
+ */
+static void write_security(FILE *fp, const HotspotConfig *cfg, bool minimal)
+{
+    SecurityMode mode = cfg->security;
+    if (minimal && mode == SEC_TRANSITION) mode = SEC_WPA2;
 
+    switch (mode) {
+    case SEC_WPA2:
+        fprintf(fp, "wpa_key_mgmt=WPA-PSK\n");
+        return;
+    case SEC_TRANSITION:
+        /* Older WPA3 stations may only know hunting-and-pecking */
+        fprintf(fp,
+            "wpa_key_mgmt=WPA-PSK SAE\n"
+            "ieee80211w=1\n"
+            "sae_require_mfp=1\n"
+            "sae_pwe=2\n");
+        break;
+    case SEC_SAE:
+        fprintf(fp,
+            "wpa_key_mgmt=SAE\n"
+            "ieee80211w=2\n"
+            "sae_pwe=1\n");
+        break;
+    }
+    fprintf(fp,
+        "sae_groups=19\n"
+        "sae_anti_clogging_threshold=%d\n",
+        cfg->sae_anti_clogging);
+}
+
+static bool generate_hostapd_conf(HotspotStatus *status, bool minimal)
+{
+    ConfBuf cb;
+    if (!conf_begin(&cb)) return false;
+    FILE *fp = cb.fp;
+
+    int channel = status->ap_channel;
     bool use_5ghz = is_5ghz_channel(channel);
     const char *hw_mode = use_5ghz ? "a" : "g";
 
@@ -127,7 +512,6 @@ static bool generate_hostapd_conf(const HotspotStatus *status, bool minimal)
         "ignore_broadcast_ssid=%d\n"
         "wpa=2\n"
         "wpa_passphrase=%s\n"
-        "wpa_key_mgmt=WPA-PSK\n"
         "rsn_pairwise=CCMP\n",
         status->ap_iface,
         status->config.ssid,
@@ -138,6 +522,21 @@ static bool generate_hostapd_conf(const HotspotStatus *status, bool minimal)
         status->config.hidden ? 1 : 0,
         status->config.password
     );
+    write_security(fp, &status->config, minimal);
+
+    /* Steering, radar handling and coordination drive hostapd_cli */
+    if (status->config.steer.enabled || status->dfs ||
+        status->config.coord.enabled)
+        fprintf(fp, "ctrl_interface=%s\n", HOSTAPD_CTRL_DIR);
+    fprintf(fp, "max_num_sta=%d\n", status->config.max_clients);
+    if (status->config.coord.enabled)
+        fprintf(fp, "no_probe_resp_if_max_sta=1\n");  /* full: peers answer */
+    if (status->config.steer.enabled)
+        fprintf(fp, "bss_transition=1\n");
+    if (status->dfs)
+        fprintf(fp, "ieee80211h=1\n");     /* radar detection / CAC */
+    if (status->config.uplink.mode == UPLINK_BRIDGE)
+        fprintf(fp, "bridge=%s\n", status->config.uplink.bridge);
 
     /* Only add 802.11n/ac if NOT in minimal fallback mode */
     if (!minimal) {
@@ -147,40 +546,91 @@ static bool generate_hostapd_conf(const HotspotStatus *status, bool minimal)
         }
     }
 
-    fclose(fp);
-    return true;
+    return conf_commit(&cb, HOSTAPD_CONF_PATH, &status->hostapd_conf);
 }
 
 /* ── Generate dnsmasq config ─────────────────────────────────────────── */
 
-static bool generate_dnsmasq_conf(const HotspotStatus *status)
+/* Router and DNS options, world-readable: dnsmasq rereads them as nobody */
+static bool generate_dhcp_opts(HotspotStatus *status)
 {
-    FILE *fp = fopen(DNSMASQ_CONF_PATH, "w");
-    if (!fp) return false;
+    const char *dirs[] = { DHCP_DIR, DHCP_HOSTS_DIR, DHCP_OPTS_DIR };
+    for (int i = 0; i < 3; i++)
+        if (mkdir(dirs[i], 0755) != 0 && errno != EEXIST) return false;
+
+    char text[MAX_LINE_LEN];
+    int len = snprintf(text, sizeof(text),
+                       "option:router,%s\n"
+                       "option:dns-server,8.8.8.8,8.8.4.4\n",
+                       AP_GATEWAY);
+
+    int ret = fio_update_file(DHCP_OPTS_PATH, text, (size_t)len, 0644,
+                              &status->dhcp_opts.hash);
+    status->dhcp_opts.changed = (ret != 0);
+    return ret >= 0;
+}
+
+static bool generate_dnsmasq_conf(HotspotStatus *status)
+{
+    ConfBuf cb;
+    if (!conf_begin(&cb)) return false;
+    FILE *fp = cb.fp;
+
+    /* Proxy-ARP: no local DNS or pool, forward DHCP to the upstream LAN */
+    if (status->config.uplink.mode == UPLINK_PROXYARP) {
+        char server[MAX_IP_LEN];
+        uplink_dhcp_server(&status->config.uplink, status->wifi.name,
+                           server, sizeof(server));
+        fprintf(fp,
+            "interface=%s\n"
+            "bind-interfaces\n"
+            "port=0\n"
+            "dhcp-relay=%s,%s\n"
+            "log-facility=" DNSMASQ_LOG_PATH "\n",
+            status->ap_iface, status->wifi.ip, server);
+        return conf_commit(&cb, DNSMASQ_CONF_PATH, &status->dnsmasq_conf) && server[0] != '\0';
+    }
 
+    /*
+     * bind-dynamic follows ap0 going away and coming back, so one
+     * dnsmasq serves every start. Options and static hosts live in
+     * watched directories: changing them is a SIGHUP, not a restart.
+     */
     fprintf(fp,
         "interface=%s\n"
-        "bind-interfaces\n"
-        "dhcp-range=%s,%s,12h\n"
-        "dhcp-option=option:router,%s\n"
-        "dhcp-option=option:dns-server,8.8.8.8,8.8.4.4\n"
+        "bind-dynamic\n"
+        "dhcp-range=%s,%s,%d\n"
         "dhcp-leasefile=%s\n"
-        "log-facility=/tmp/hotspot_enabler_dnsmasq.log\n",
+        "dhcp-hostsdir=%s\n"
+        "dhcp-optsdir=%s\n"
+        "log-facility=" DNSMASQ_LOG_PATH "\n",
         status->ap_iface,
         AP_DHCP_START,
         AP_DHCP_END,
-        AP_GATEWAY,
-        DNSMASQ_LEASE_FILE
+        AP_LEASE_SECS,
+        DNSMASQ_LEASE_FILE,
+        DHCP_HOSTS_DIR,
+        DHCP_OPTS_DIR
     );
 
-    fclose(fp);
-    return true;
+    return conf_commit(&cb, DNSMASQ_CONF_PATH, &status->dnsmasq_conf) &&
+           generate_dhcp_opts(status);
 }
 
 /* ── NetworkManager Management ───────────────────────────────────────── */
 
 #define NM_UNMANAGED_CONF "/etc/NetworkManager/conf.d/hotspot-enabler-unmanaged.conf"
 
+static bool nm_write_unmanaged(const char *iface)
+{
+    char text[MAX_LINE_LEN];
+    int len = snprintf(text, sizeof(text),
+                       "[keyfile]\n"
+                       "unmanaged-devices=interface-name:%s\n",
+                       iface);
+    return fio_write_file(NM_UNMANAGED_CONF, text, (size_t)len, 0644);
+}
+
 /*
  * Cross-distro network manager handling:
  *   - NetworkManager (Ubuntu, Fedora, Zorin, Mint, Arch GUI)
@@ -195,14 +645,7 @@ static void nm_unmanage_interface(const char *ap_iface)
     char cmd[MAX_CMD_LEN];
 
     /* -- NetworkManager (most desktop Linux distros) -- */
-    FILE *fp = fopen(NM_UNMANAGED_CONF, "w");
-    if (fp) {
-        fprintf(fp,
-            "[keyfile]\n"
-            "unmanaged-devices=interface-name:%s\n",
-            ap_iface);
-        fclose(fp);
-    }
+    nm_write_unmanaged(ap_iface);
     net_exec_silent("nmcli general reload conf 2>/dev/null");
     usleep(500000);
     snprintf(cmd, sizeof(cmd),
@@ -282,6 +725,28 @@ static bool force_remove_interface(const char *iface)
     return true;
 }
 
+/*
+ * Kill hostapd / dnsmasq instances that could hold the radio or the
+ * DHCP port, except the ones kept from an earlier start in this process.
+ * ("[d]" keeps the pattern from matching the shell running it.)
+ */
+static void kill_strays(const char *pgrep_args, pid_t keep)
+{
+    char cmd[MAX_CMD_LEN];
+    if (keep <= 0)
+        snprintf(cmd, sizeof(cmd), "pkill %s 2>/dev/null", pgrep_args);
+    else
+        snprintf(cmd, sizeof(cmd),
+                 "for p in $(pgrep %s); do [ $p = %d ] || kill $p; done 2>/dev/null",
+                 pgrep_args, (int)keep);
+    net_exec_silent(cmd);
+}
+
+static pid_t dnsmasq_alive(void)
+{
+    return g_dnsmasq.pid > 0 && kill(g_dnsmasq.pid, 0) == 0 ? g_dnsmasq.pid : 0;
+}
+
 /*
  * Creates the virtual AP interface and tells NM to ignore it.
  * Does NOT bring it up or assign IP — hostapd handles that.
@@ -290,9 +755,9 @@ static bool create_ap_interface(HotspotStatus *status)
 {
     char cmd[MAX_CMD_LEN];
 
-    /* Stop conflicting services */
-    net_exec_silent("pkill hostapd 2>/dev/null");
-    net_exec_silent("pkill -f 'dnsmasq.*hotspot_enabler' 2>/dev/null");
+    /* Stop conflicting services (our idle hostapd and dnsmasq stay) */
+    kill_strays("hostapd", g_hapd_owned ? hapd_daemon_pid() : 0);
+    kill_strays("-f '[d]nsmasq.*hotspot_enabler'", dnsmasq_alive());
     net_exec_silent("rfkill unblock wifi 2>/dev/null");
     usleep(300000);
 
@@ -308,24 +773,24 @@ static bool create_ap_interface(HotspotStatus *status)
         const char *try_name = ap_names[i];
 
         /* Try to remove any stale interface with this name */
+        if (g_hapd_owned) hapd_remove(try_name);
         force_remove_interface(try_name);
 
         /* Pre-configure NM to ignore this interface BEFORE creating it */
-        FILE *fp = fopen(NM_UNMANAGED_CONF, "w");
-        if (fp) {
-            fprintf(fp,
-                "[keyfile]\n"
-                "unmanaged-devices=interface-name:%s\n",
-                try_name);
-            fclose(fp);
+        if (nm_write_unmanaged(try_name)) {
             net_exec_silent("nmcli general reload conf 2>/dev/null");
             usleep(300000);
         }
 
-        /* Create virtual interface */
-        snprintf(cmd, sizeof(cmd),
-                 "iw dev %s interface add %s type __ap",
-                 status->wifi.name, try_name);
+        /* Create virtual interface (on the dedicated radio if set) */
+        if (status->config.ap_phy[0])
+            snprintf(cmd, sizeof(cmd),
+                     "iw phy %s interface add %s type __ap",
+                     status->config.ap_phy, try_name);
+        else
+            snprintf(cmd, sizeof(cmd),
+                     "iw dev %s interface add %s type __ap",
+                     status->wifi.name, try_name);
 
         if (net_exec_silent(cmd) == 0) {
             /* Success! Update the interface name in status */
@@ -350,6 +815,37 @@ static bool create_ap_interface(HotspotStatus *status)
     return true;
 }
 
+/*
+ * Isolation: move the AP radio into its own namespace and create ap0
+ * there. Nothing on the host sees ap0, so no manager hand-off or waits.
+ */
+static bool create_ap_in_netns(HotspotStatus *status)
+{
+    char cmd[MAX_CMD_LEN], err[MAX_LINE_LEN];
+
+    /* Stop conflicting services (our idle hostapd and dnsmasq stay) */
+    kill_strays("hostapd", g_hapd_owned ? hapd_daemon_pid() : 0);
+    kill_strays("-f '[d]nsmasq.*hotspot_enabler'", dnsmasq_alive());
+    net_exec_silent("rfkill unblock wifi 2>/dev/null");
+
+    if (!netns_setup(status->config.ap_phy, AP_SUBNET ".0/24", err, sizeof(err))) {
+        snprintf(status->error_msg, sizeof(status->error_msg),
+                 "Namespace isolation: %s", err);
+        return false;
+    }
+    status->netns = true;
+
+    snprintf(cmd, sizeof(cmd), NETNS_EXEC "iw phy %s interface add %s type __ap",
+             status->config.ap_phy, status->ap_iface);
+    if (net_exec_silent(cmd) != 0) {
+        snprintf(status->error_msg, sizeof(status->error_msg),
+                 "Failed to create %s on %s inside the namespace.",
+                 status->ap_iface, status->config.ap_phy);
+        return false;
+    }
+    return true;
+}
+
 /* ── Assign IP to AP interface (called AFTER hostapd starts) ─────────── */
 
 static bool assign_ap_ip(HotspotStatus *status)
@@ -357,24 +853,26 @@ static bool assign_ap_ip(HotspotStatus *status)
     char cmd[MAX_CMD_LEN];
 
     /* Bring up if not already (hostapd should have done this) */
-    snprintf(cmd, sizeof(cmd), "ip link set %s up 2>/dev/null", status->ap_iface);
+    snprintf(cmd, sizeof(cmd), "%sip link set %s up 2>/dev/null",
+             ap_exec(status), status->ap_iface);
     net_exec_silent(cmd);
 
     /* Flush existing addresses */
-    snprintf(cmd, sizeof(cmd), "ip addr flush dev %s 2>/dev/null", status->ap_iface);
+    snprintf(cmd, sizeof(cmd), "%sip addr flush dev %s 2>/dev/null",
+             ap_exec(status), status->ap_iface);
     net_exec_silent(cmd);
 
     /* Assign gateway IP */
-    snprintf(cmd, sizeof(cmd), "ip addr add %s/24 dev %s",
-             AP_GATEWAY, status->ap_iface);
+    snprintf(cmd, sizeof(cmd), "%sip addr add %s/24 dev %s",
+             ap_exec(status), AP_GATEWAY, status->ap_iface);
     int ret = net_exec_silent(cmd);
 
     if (ret != 0) {
         /* Retry — might already be assigned (RTNETLINK: File exists) */
         usleep(200000);
         snprintf(cmd, sizeof(cmd),
-                 "ip addr replace %s/24 dev %s 2>/dev/null",
-                 AP_GATEWAY, status->ap_iface);
+                 "%sip addr replace %s/24 dev %s 2>/dev/null",
+                 ap_exec(status), AP_GATEWAY, status->ap_iface);
         net_exec_silent(cmd);
     }
 
@@ -383,61 +881,36 @@ static bool assign_ap_ip(HotspotStatus *status)
 
 /* ── Setup iptables NAT ──────────────────────────────────────────────── */
 
-static bool setup_nat(HotspotStatus *status)
+static void enable_forwarding(HotspotStatus *status)
 {
-    char cmd[MAX_CMD_LEN];
-
     /* Save current IP forwarding state */
     char output[16] = {0};
-    net_exec_cmd("cat /proc/sys/net/ipv4/ip_forward", output, sizeof(output));
+    fio_read_file("/proc/sys/net/ipv4/ip_forward", output, sizeof(output));
     status->ip_forward_was_enabled = (atoi(output) == 1);
 
     /* Enable IP forwarding via sysctl (more reliable than echo) */
     net_exec_silent("sysctl -w net.ipv4.ip_forward=1 >/dev/null 2>&1");
     net_exec_silent("echo 1 > /proc/sys/net/ipv4/ip_forward 2>/dev/null");
+}
 
-    /* NAT masquerade */
-    snprintf(cmd, sizeof(cmd),
-             "iptables -t nat -A POSTROUTING -o %s -j MASQUERADE",
-             status->wifi.name);
-    net_exec_silent(cmd);
-
-    /* Allow forwarding */
-    snprintf(cmd, sizeof(cmd),
-             "iptables -A FORWARD -i %s -o %s -m state "
-             "--state RELATED,ESTABLISHED -j ACCEPT",
-             status->wifi.name, status->ap_iface);
-    net_exec_silent(cmd);
-
-    snprintf(cmd, sizeof(cmd),
-             "iptables -A FORWARD -i %s -o %s -j ACCEPT",
-             status->ap_iface, status->wifi.name);
-    net_exec_silent(cmd);
+static bool setup_nat(HotspotStatus *status, char *err, size_t errsize)
+{
+    enable_forwarding(status);
 
-    return true;
+    /* MASQUERADE + FORWARD rules, per rule or as one restore batch */
+    status->fw_backend = fw_resolve(status->config.nat_backend);
+    return fw_nat_setup(status->fw_backend, nat_iface(status), status->wifi.name,
+                        err, errsize);
 }
 
 /* ── Remove iptables NAT ────────────────────────────────────────────── */
 
 static void remove_nat(HotspotStatus *status)
 {
-    char cmd[MAX_CMD_LEN];
-
-    snprintf(cmd, sizeof(cmd),
-             "iptables -t nat -D POSTROUTING -o %s -j MASQUERADE 2>/dev/null",
-             status->wifi.name);
-    net_exec_silent(cmd);
-
-    snprintf(cmd, sizeof(cmd),
-             "iptables -D FORWARD -i %s -o %s -m state "
-             "--state RELATED,ESTABLISHED -j ACCEPT 2>/dev/null",
-             status->wifi.name, status->ap_iface);
-    net_exec_silent(cmd);
-
-    snprintf(cmd, sizeof(cmd),
-             "iptables -D FORWARD -i %s -o %s -j ACCEPT 2>/dev/null",
-             status->ap_iface, status->wifi.name);
-    net_exec_silent(cmd);
+    FwBackend backend = status->fw_backend != FW_BACKEND_AUTO
+                        ? status->fw_backend : status->config.nat_backend;
+    fw_nat_teardown(backend, nat_iface(status), status->wifi.name);
+    status->fw_backend = FW_BACKEND_AUTO;
 
     if (!status->ip_forward_was_enabled) {
         net_exec_silent("sysctl -w net.ipv4.ip_forward=0 >/dev/null 2>&1");
@@ -456,10 +929,19 @@ static void remove_nat(HotspotStatus *status)
  * interfaces. Killing it would drop the WiFi client connection.
  * Instead, we use wpa_cli to detach only the ap0 interface.
  */
-static void prepare_for_hostapd(const char *ap_iface)
+static void prepare_for_hostapd(const HotspotStatus *status)
 {
+    const char *ap_iface = status->ap_iface;
     char cmd[MAX_CMD_LEN];
 
+    /* Alone in its namespace: nothing else can hold the interface */
+    if (status->netns) {
+        snprintf(cmd, sizeof(cmd), NETNS_EXEC "ip link set %s down 2>/dev/null",
+                 ap_iface);
+        net_exec_silent(cmd);
+        return;
+    }
+
     /* Safely detach wpa_supplicant from ap0 only (not kill it) */
     snprintf(cmd, sizeof(cmd),
              "wpa_cli -i %s disconnect 2>/dev/null", ap_iface);
@@ -491,18 +973,50 @@ static void prepare_for_hostapd(const char *ap_iface)
 
 /* ── Start hostapd ───────────────────────────────────────────────────── */
 
+/* The last error lines hostapd logged */
+static void hostapd_log_errors(char *log_out, size_t log_sz)
+{
+    char cmd[MAX_CMD_LEN];
+
+    log_out[0] = '\0';
+    snprintf(cmd, sizeof(cmd),
+             "grep -iE 'Could not|FAIL|Error|refused' %s 2>/dev/null | tail -2",
+             HOSTAPD_LOG_PATH);
+    net_exec_cmd(cmd, log_out, log_sz);
+
+    if (strlen(log_out) == 0) {
+        snprintf(cmd, sizeof(cmd), "tail -2 %s 2>/dev/null", HOSTAPD_LOG_PATH);
+        net_exec_cmd(cmd, log_out, log_sz);
+    }
+}
+
 /*
  * Attempt a single hostapd start. Returns true if hostapd is running.
+ * With a persistent daemon this is an ADD of the interface with the
+ * current config; a failed attempt is REMOVEd, never restarted.
  */
-static bool try_hostapd_once(HotspotStatus *status, char *log_out, size_t log_sz)
+static bool try_hostapd_once(HotspotStatus *status, bool persistent,
+                             char *log_out, size_t log_sz)
 {
     char cmd[MAX_CMD_LEN];
 
-    prepare_for_hostapd(status->ap_iface);
+    if (persistent) {
+        char err[MAX_LINE_LEN];
+        hapd_remove(status->ap_iface);
+        prepare_for_hostapd(status);
+        if (hapd_add(status->ap_iface, HOSTAPD_CONF_PATH, err, sizeof(err)))
+            return true;
+        hostapd_log_errors(log_out, log_sz);
+        if (!log_out[0]) snprintf(log_out, log_sz, "%s", err);
+        hapd_remove(status->ap_iface);
+        return false;
+    }
+
+    prepare_for_hostapd(status);
 
     snprintf(cmd, sizeof(cmd),
-             "hostapd -B %s -f %s >/dev/null 2>&1",
-             HOSTAPD_CONF_PATH, HOSTAPD_LOG_PATH);
+             "%shostapd -B %s -f %s >/dev/null 2>&1",
+             ap_exec(status), HOSTAPD_CONF_PATH, HOSTAPD_LOG_PATH);
 
     if (net_exec_silent(cmd) == 0) {
         usleep(1000000); /* 1 second for init */
@@ -515,29 +1029,27 @@ static bool try_hostapd_once(HotspotStatus *status, char *log_out, size_t log_sz
             return true;
     }
 
-    /* Failed — capture error lines from log */
-    log_out[0] = '\0';
-    snprintf(cmd, sizeof(cmd),
-             "grep -iE 'Could not|FAIL|Error|refused' %s 2>/dev/null | tail -2",
-             HOSTAPD_LOG_PATH);
-    net_exec_cmd(cmd, log_out, log_sz);
-
-    if (strlen(log_out) == 0) {
-        snprintf(cmd, sizeof(cmd), "tail -2 %s 2>/dev/null", HOSTAPD_LOG_PATH);
-        net_exec_cmd(cmd, log_out, log_sz);
-    }
-
-    net_exec_silent("pkill hostapd 2>/dev/null");
+    hostapd_log_errors(log_out, log_sz);
+    kill_strays("hostapd", g_hapd_owned ? hapd_daemon_pid() : 0);
     usleep(500000);
     return false;
 }
 
+/* The minimal config carries no WPA3 in transition mode: say so */
+static bool started_minimal(HotspotStatus *status)
+{
+    if (status->config.security == SEC_TRANSITION && !status->notice[0])
+        snprintf(status->notice, sizeof(status->notice),
+                 "Driver rejected the full config; running WPA2 only.");
+    return true;
+}
+
 static bool start_hostapd(HotspotStatus *status)
 {
     char cmd[MAX_CMD_LEN];
     char log_output[MAX_CMD_LEN] = {0};
-    int client_channel = status->wifi.channel;
-    bool is_5ghz = is_5ghz_channel(client_channel);
+    int ap_channel = status->ap_channel;    /* planned; phase 3 overrides */
+    bool is_5ghz = is_5ghz_channel(ap_channel);
 
     /* Set regulatory domain before starting hostapd */
     char country[4] = {0};
@@ -546,32 +1058,49 @@ static bool start_hostapd(HotspotStatus *status)
     net_exec_silent(cmd);
     usleep(200000);
 
+    /*
+     * One long-lived hostapd (global control socket); every attempt
+     * below is then a cheap ADD/REMOVE rather than a process start.
+     * If it cannot be had, hostapd is started per attempt as before.
+     */
+    char why[MAX_LINE_LEN];
+    pid_t daemon = hapd_daemon_start(ap_exec(status), HOSTAPD_LOG_PATH,
+                                     why, sizeof(why));
+    bool persistent = daemon > 0;
+    if (persistent) {
+        status->hostapd_pid = daemon;
+        g_hapd_owned = true;
+    } else if (!status->notice[0]) {
+        snprintf(status->notice, sizeof(status->notice),
+                 "Persistent hostapd unavailable (%s); starting it per run.", why);
+    }
+
     /*
      * Three-phase startup strategy:
      *
-     *   Phase 1: Full config (802.11n/ac) on client's channel
-     *   Phase 2: Minimal config (basic) on client's channel
+     *   Phase 1: Full config (802.11n/ac) on the planned AP channel
+     *   Phase 2: Minimal config (basic) on the planned AP channel
      *   Phase 3: Fallback to 2.4 GHz channel 6
-     *            (only if client is on 5GHz and driver blocks AP on 5GHz)
+     *            (only if the AP channel is 5GHz and the driver blocks it)
      *
      * The "Could not select hw_mode and channel" error (-3) means
      * the driver/regulatory domain blocks AP on the requested channel.
      * When detected, we skip directly to Phase 3.
      */
 
-    /* ── Phase 1: Full config on client's channel ──────────────────── */
+    /* ── Phase 1: Full config on the AP channel ────────────────────── */
     generate_hostapd_conf(status, false);
-    if (try_hostapd_once(status, log_output, sizeof(log_output)))
+    if (try_hostapd_once(status, persistent, log_output, sizeof(log_output)))
         return true;
 
     /* Check if it's a channel/hw_mode rejection — skip to 2.4GHz */
     bool channel_rejected = (strstr(log_output, "Could not select") != NULL);
 
     if (!channel_rejected) {
-        /* ── Phase 2: Minimal config on client's channel ───────────── */
+        /* ── Phase 2: Minimal config on the AP channel ─────────────── */
         generate_hostapd_conf(status, true);
-        if (try_hostapd_once(status, log_output, sizeof(log_output)))
-            return true;
+        if (try_hostapd_once(status, persistent, log_output, sizeof(log_output)))
+            return started_minimal(status);
 
         channel_rejected = (strstr(log_output, "Could not select") != NULL);
     }
@@ -579,24 +1108,20 @@ static bool start_hostapd(HotspotStatus *status)
     /* ── Phase 3: 2.4GHz fallback (only if 5GHz was rejected) ──────── */
     if (channel_rejected && is_5ghz) {
         /* Override channel to 2.4GHz channel 6 */
-        int saved_channel = status->config.channel;
-        status->config.channel = 6;
+        status->ap_channel = 6;
+        status->dfs = false;
 
         /* Try full config on 2.4GHz */
         generate_hostapd_conf(status, false);
-        if (try_hostapd_once(status, log_output, sizeof(log_output))) {
-            status->config.channel = saved_channel;
+        if (try_hostapd_once(status, persistent, log_output, sizeof(log_output)))
             return true;
-        }
 
         /* Try minimal config on 2.4GHz */
         generate_hostapd_conf(status, true);
-        if (try_hostapd_once(status, log_output, sizeof(log_output))) {
-            status->config.channel = saved_channel;
-            return true;
-        }
+        if (try_hostapd_once(status, persistent, log_output, sizeof(log_output)))
+            return started_minimal(status);
 
-        status->config.channel = saved_channel;
+        status->ap_channel = ap_channel;
     }
 
     /* All attempts failed — set detailed error message */
@@ -607,8 +1132,8 @@ static bool start_hostapd(HotspotStatus *status)
     if (channel_rejected && is_5ghz) {
         snprintf(status->error_msg, sizeof(status->error_msg),
                  "AP not supported on 5GHz (ch %d) or 2.4GHz by this driver. "
-                 "Try connecting to a 2.4GHz WiFi network first.",
-                 client_channel);
+                 "Try a 2.4GHz channel (or a 2.4GHz uplink network).",
+                 ap_channel);
     } else {
         snprintf(status->error_msg, sizeof(status->error_msg),
                  "hostapd failed: %.400s", log_output);
@@ -622,16 +1147,31 @@ static bool start_dnsmasq(HotspotStatus *status)
 {
     char cmd[MAX_CMD_LEN];
 
+    /* The instance kept from the last stop, if its config still holds */
+    if (dnsmasq_alive() && !status->netns &&
+        g_dnsmasq.conf_hash == status->dnsmasq_conf.hash) {
+        status->dnsmasq_pid = g_dnsmasq.pid;
+        if (status->dhcp_opts.changed) kill(g_dnsmasq.pid, SIGHUP);
+        return true;
+    }
+    kill_process(dnsmasq_alive(), "");
+    g_dnsmasq.pid = 0;
+
     /* Kill any conflicting dnsmasq */
     snprintf(cmd, sizeof(cmd),
              "pkill -f 'dnsmasq.*%s' 2>/dev/null", status->ap_iface);
     net_exec_silent(cmd);
-    net_exec_silent("systemctl stop dnsmasq 2>/dev/null");
-    usleep(300000);
 
+    /* Ports 53/67 in the namespace are ours alone */
+    if (!status->netns) {
+        net_exec_silent("systemctl stop dnsmasq 2>/dev/null");
+        usleep(300000);
+    }
+
+    unlink(DNSMASQ_PID_PATH);
     snprintf(cmd, sizeof(cmd),
-             "dnsmasq -C %s --pid-file=/tmp/hotspot_enabler_dnsmasq.pid",
-             DNSMASQ_CONF_PATH);
+             "%sdnsmasq -C %s --pid-file=" DNSMASQ_PID_PATH,
+             ap_exec(status), DNSMASQ_CONF_PATH);
 
     if (net_exec_silent(cmd) != 0) {
         snprintf(status->error_msg, sizeof(status->error_msg),
@@ -639,15 +1179,85 @@ static bool start_dnsmasq(HotspotStatus *status)
         return false;
     }
 
+    /* The pid file appears as dnsmasq detaches */
     char output[64] = {0};
-    usleep(300000);
-    net_exec_cmd("cat /tmp/hotspot_enabler_dnsmasq.pid 2>/dev/null",
-                 output, sizeof(output));
-    status->dnsmasq_pid = atoi(output);
+    status->dnsmasq_pid = 0;
+    for (int i = 0; i < 40 && status->dnsmasq_pid <= 0; i++) {
+        if (fio_read_file(DNSMASQ_PID_PATH, output, sizeof(output)))
+            status->dnsmasq_pid = atoi(output);
+        else
+            usleep(25000);
+    }
 
+    g_dnsmasq.pid = status->dnsmasq_pid;
+    g_dnsmasq.conf_hash = status->dnsmasq_conf.hash;
     return (status->dnsmasq_pid > 0);
 }
 
+/* ── Scheduling Boost ────────────────────────────────────────────────── */
+
+/*
+ * Apply the configured scheduling policy and CPU placement to hostapd,
+ * dnsmasq and the calling (main loop) thread, keeping what each had
+ * before for restore_sched(). Failures are not fatal; they are reported
+ * through status->notice.
+ */
+static void apply_sched_boost(HotspotStatus *status)
+{
+    const ProcSchedConfig *cfg = &status->config.sched;
+    char err[MAX_LINE_LEN];
+
+    if (cfg->mode == PROCSCHED_OFF && cfg->cpus[0] == '\0') return;
+
+    /* A daemon boosted before (reattach) keeps its first saved settings */
+    ProcSchedSaved *hsave = status->hostapd_sched.saved ? NULL : &status->hostapd_sched;
+    ProcSchedSaved *dsave = status->dnsmasq_sched.saved ? NULL : &status->dnsmasq_sched;
+
+    if (!procsched_apply(status->hostapd_pid, cfg, hsave, err, sizeof(err))) {
+        snprintf(status->notice, sizeof(status->notice),
+                 "Scheduling boost for hostapd failed: %s", err);
+    }
+    if (!procsched_apply(status->dnsmasq_pid, cfg, dsave, err, sizeof(err)) &&
+        !status->notice[0]) {
+        snprintf(status->notice, sizeof(status->notice),
+                 "Scheduling boost for dnsmasq failed: %s", err);
+    }
+    if (!procsched_apply(0, cfg, &status->self_sched, err, sizeof(err)) &&
+        !status->notice[0]) {
+        snprintf(status->notice, sizeof(status->notice),
+                 "Scheduling boost for main loop failed: %s", err);
+    }
+}
+
+/* Daemons kept for the next start go back to their own settings */
+static void restore_sched(HotspotStatus *status)
+{
+    if (status->hostapd_pid > 0)
+        procsched_restore(status->hostapd_pid, &status->hostapd_sched);
+    if (status->dnsmasq_pid > 0)
+        procsched_restore(status->dnsmasq_pid, &status->dnsmasq_sched);
+    status->hostapd_sched.saved = false;
+    status->dnsmasq_sched.saved = false;
+    procsched_restore(0, &status->self_sched);
+}
+
+/* ── Flight Recorder ─────────────────────────────────────────────────── */
+
+static void start_recorder(HotspotStatus *status)
+{
+    if (!status->config.recorder.enabled) return;
+
+    char err[MAX_LINE_LEN];
+    if (!recorder_start(&status->config.recorder, status->ap_iface,
+                        status->wifi.name, ap_phy_name(status),
+                        status->hostapd_pid, status->dnsmasq_pid,
+                        err, sizeof(err)) &&
+        !status->notice[0]) {
+        snprintf(status->notice, sizeof(status->notice),
+                 "Flight recorder: %s", err);
+    }
+}
+
 /* ── Kill Process Safely ─────────────────────────────────────────────── */
 
 static void kill_process(pid_t pid, const char *name)
@@ -678,8 +1288,13 @@ static void kill_process(pid_t pid, const char *name)
 
 bool hotspot_start(HotspotStatus *status)
 {
+    time_t begun = time(NULL);   /* leases from here on are this run's */
+
     status->state = HS_STATE_STARTING;
     status->error_msg[0] = '\0';
+    status->notice[0] = '\0';
+    status->event[0] = '\0';
+    status->log_pos = 0;
 
     /* 1. Detect WiFi interface */
     if (!net_detect_wifi_interface(&status->wifi)) {
@@ -697,13 +1312,56 @@ bool hotspot_start(HotspotStatus *status)
         return false;
     }
 
-    /* 3. Create virtual AP interface (does NOT bring it up) */
-    if (!create_ap_interface(status)) {
+    /* 3. Create virtual AP interface (does NOT bring it up); isolated
+     *    runs create it in the namespace once the channel is planned */
+    status->netns = false;
+    if (status->config.netns) {
+        const char *why = NULL;
+        if (!status->config.ap_phy[0] || shares_uplink_radio(status))
+            why = "needs a dedicated AP radio (ap_phy)";
+        else if (status->config.uplink.mode != UPLINK_NAT)
+            why = "needs uplink_mode = nat";
+        if (why) {
+            snprintf(status->error_msg, sizeof(status->error_msg),
+                     "Namespace isolation %s.", why);
+            status->state = HS_STATE_ERROR;
+            return false;
+        }
+        snprintf(status->ap_iface, sizeof(status->ap_iface), "%s", AP_IFACE_NAME);
+    } else if (!create_ap_interface(status)) {
         status->state = HS_STATE_ERROR;
         return false;
     }
 
-    /* 4. Generate configs */
+    /* 4. Generate configs (into the private run directory) */
+    const UplinkConfig *uplink = &status->config.uplink;
+    if (!fio_private_dir(HOTSPOT_RUN_DIR)) {
+        snprintf(status->error_msg, sizeof(status->error_msg),
+                 "Cannot create private directory " HOTSPOT_RUN_DIR ".");
+        status->state = HS_STATE_ERROR;
+        hotspot_cleanup(status);
+        return false;
+    }
+    status->ap_channel = pick_channel(status);
+    coord_plan_channel(status);
+    plan_dfs(status);
+    if (uplink->mode == UPLINK_BRIDGE) {
+        char err[MAX_LINE_LEN];
+        if (!uplink_prepare_bridge(uplink, &status->uplink_saved,
+                                   err, sizeof(err))) {
+            snprintf(status->error_msg, sizeof(status->error_msg),
+                     "Bridge uplink: %s", err);
+            status->state = HS_STATE_ERROR;
+            hotspot_cleanup(status);
+            return false;
+        }
+    } else if (uplink->mode == UPLINK_PROXYARP && !status->wifi.ip[0]) {
+        snprintf(status->error_msg, sizeof(status->error_msg),
+                 "Proxy-ARP uplink: %s has no IPv4 address.", status->wifi.name);
+        status->state = HS_STATE_ERROR;
+        hotspot_cleanup(status);
+        return false;
+    }
     if (!generate_hostapd_conf(status, false)) {
         snprintf(status->error_msg, sizeof(status->error_msg),
                  "Failed to generate hostapd configuration.");
@@ -712,9 +1370,18 @@ bool hotspot_start(HotspotStatus *status)
         return false;
     }
 
-    if (!generate_dnsmasq_conf(status)) {
+    if (uplink->mode != UPLINK_BRIDGE && !generate_dnsmasq_conf(status)) {
         snprintf(status->error_msg, sizeof(status->error_msg),
-                 "Failed to generate dnsmasq configuration.");
+                 uplink->mode == UPLINK_PROXYARP
+                     ? "No DHCP server to relay to (set dhcp_server)."
+                     : "Failed to generate dnsmasq configuration.");
+        status->state = HS_STATE_ERROR;
+        hotspot_cleanup(status);
+        return false;
+    }
+
+    /* 4b. Isolation: radio into the namespace (channel flags are read) */
+    if (status->config.netns && !create_ap_in_netns(status)) {
         status->state = HS_STATE_ERROR;
         hotspot_cleanup(status);
         return false;
@@ -726,33 +1393,177 @@ bool hotspot_start(HotspotStatus *status)
         hotspot_cleanup(status);
         return false;
     }
+    if (status->dfs) watch_hostapd_log(status);   /* picks up DFS-CAC-START */
 
     /* 6. Assign IP to AP interface (after hostapd brought it up) */
-    assign_ap_ip(status);
+    if (uplink->mode == UPLINK_PROXYARP) {
+        char err[MAX_LINE_LEN];
+        enable_forwarding(status);
+        if (!uplink_start_proxyarp(status->ap_iface, status->wifi.name,
+                                   status->wifi.ip, &status->uplink_saved,
+                                   err, sizeof(err))) {
+            snprintf(status->error_msg, sizeof(status->error_msg),
+                     "Proxy-ARP uplink: %s", err);
+            status->state = HS_STATE_ERROR;
+            hotspot_cleanup(status);
+            return false;
+        }
+    } else if (uplink->mode == UPLINK_NAT) {
+        assign_ap_ip(status);
+    }
 
-    /* 7. Start dnsmasq */
-    if (!start_dnsmasq(status)) {
+    /* 7. Start dnsmasq (DHCP relay only in proxy-ARP mode) */
+    if (uplink->mode != UPLINK_BRIDGE && !start_dnsmasq(status)) {
         status->state = HS_STATE_ERROR;
         hotspot_cleanup(status);
         return false;
     }
+    if (uplink->mode == UPLINK_BRIDGE) {   /* one kept from a NAT run */
+        kill_process(dnsmasq_alive(), "");
+        g_dnsmasq.pid = 0;
+    }
 
     /* 8. Setup NAT */
-    if (!setup_nat(status)) {
+    char nat_err[MAX_LINE_LEN];
+    if (uplink->mode == UPLINK_NAT && !setup_nat(status, nat_err, sizeof(nat_err))) {
         snprintf(status->error_msg, sizeof(status->error_msg),
-                 "Failed to configure NAT forwarding.");
+                 "Failed to configure NAT forwarding: %s", nat_err);
         status->state = HS_STATE_ERROR;
         hotspot_cleanup(status);
         return false;
     }
 
+    /* 8b. Optional per-client connection caps, conntrack sized to match */
+    if (connlimit_enabled(&status->config.connlimit)) {
+        char err[MAX_LINE_LEN];
+        if (uplink->mode != UPLINK_NAT) {
+            snprintf(status->notice, sizeof(status->notice),
+                     "Connection caps need uplink_mode = nat; not applied.");
+        } else if (!connlimit_start(&status->config.connlimit, nat_iface(status),
+                                    status->config.max_clients,
+                                    &status->connlimit_saved, err, sizeof(err))) {
+            snprintf(status->notice, sizeof(status->notice),
+                     "Connection caps not applied: %s", err);
+        }
+    }
+
+    /* 9. Optional real-time / nice boost and CPU placement */
+    apply_sched_boost(status);
+
+    /* 10. Keep the uplink STA from scanning / dozing while clients are on */
+    if (status->config.sta_tune && status->wifi.name[0]) {
+        char err[MAX_LINE_LEN];
+        if (!statune_apply(status->wifi.name, shares_uplink_radio(status),
+                           &status->sta_saved, err, sizeof(err)) &&
+            !status->notice[0]) {
+            snprintf(status->notice, sizeof(status->notice),
+                     "Uplink radio tuning incomplete: %s", err);
+        }
+    }
+
+    /* 11. Optional AQL limits: less airtime queued below mac80211 */
+    if (status->config.aql.low > 0) {
+        char err[MAX_LINE_LEN];
+        if (!txq_aql_apply(ap_phy_name(status), &status->config.aql,
+                           &status->aql_saved, err, sizeof(err)) &&
+            !status->notice[0]) {
+            snprintf(status->notice, sizeof(status->notice),
+                     "AQL tuning skipped: %s", err);
+        }
+    }
+
+    /* 12. Optional band steering to a 5 GHz peer */
+    if (status->config.steer.enabled) {
+        char err[MAX_LINE_LEN];
+        if (!steer_start(&status->config.steer, status->ap_iface,
+                         status->ap_channel, err, sizeof(err)) &&
+            !status->notice[0]) {
+            snprintf(status->notice, sizeof(status->notice),
+                     "Band steering disabled: %s", err);
+        }
+    }
+
+    /* 13. Flight recorder */
+    start_recorder(status);
+
     status->state = HS_STATE_RUNNING;
-    status->start_time = time(NULL);
+    status->start_time = begun;
     status->client_count = 0;
+    g_admit_cap = -1;            /* the config carries max_clients */
+    coord_update(status);
+    status->detached = false;
+    state_save(status, true);
+
+    hooks_emit(HOOK_HOTSPOT_STARTED,
+               "\"ap_iface\":\"%s\",\"uplink\":\"%s\",\"channel\":%d",
+               status->ap_iface, status->wifi.name, status->ap_channel);
 
     return true;
 }
 
+/* ── Detach / Reattach ───────────────────────────────────────────────── */
+
+/* Keep the adopted dnsmasq across stops; its config is what is on disk */
+static void adopt_dnsmasq(const HotspotStatus *status)
+{
+    char text[4096];
+    g_dnsmasq.pid = status->dnsmasq_pid;
+    g_dnsmasq.conf_hash = fio_read_file(DNSMASQ_CONF_PATH, text, sizeof(text))
+                              ? fio_hash(text, strlen(text)) : 0;
+}
+
+bool hotspot_reattach(HotspotStatus *status, char *err, size_t errsize)
+{
+    if (!state_load(status, err, errsize)) return false;
+
+    status->state        = HS_STATE_RUNNING;
+    status->detached     = false;
+    status->client_count = 0;
+    status->error_msg[0] = '\0';
+    status->notice[0]    = '\0';
+    status->event[0]     = '\0';
+
+    /* Only hostapd log lines written from now on are news */
+    struct stat st;
+    status->log_pos = stat(HOSTAPD_LOG_PATH, &st) == 0 ? (long)st.st_size : 0;
+    g_hapd_owned = status->hostapd_pid == hapd_daemon_pid();
+    adopt_dnsmasq(status);
+
+    net_refresh_wifi_status(&status->wifi);
+
+    /* Whatever the daemons had before the boost went with the old process */
+    if (status->config.sched.mode != PROCSCHED_OFF || status->config.sched.cpus[0]) {
+        procsched_saved_default(&status->hostapd_sched);
+        procsched_saved_default(&status->dnsmasq_sched);
+    }
+    apply_sched_boost(status);
+    g_admit_cap = -1;
+    coord_update(status);
+
+    if (status->config.steer.enabled) {
+        char why[MAX_LINE_LEN];
+        if (!steer_start(&status->config.steer, status->ap_iface,
+                         status->ap_channel, why, sizeof(why))) {
+            snprintf(status->notice, sizeof(status->notice),
+                     "Band steering disabled: %s", why);
+        }
+    }
+    start_recorder(status);
+
+    state_save(status, true);
+    return true;
+}
+
+void hotspot_detach(HotspotStatus *status)
+{
+    /* Our own threads and settings go; daemons and netfilter stay */
+    steer_stop();
+    recorder_stop();
+    procsched_restore(0, &status->self_sched);
+    state_save(status, false);
+    status->detached = true;
+}
+
 /* ── Stop Hotspot ────────────────────────────────────────────────────── */
 
 bool hotspot_stop(HotspotStatus *status)
@@ -760,6 +1571,8 @@ bool hotspot_stop(HotspotStatus *status)
     status->state = HS_STATE_STOPPING;
     hotspot_cleanup(status);
     status->state = HS_STATE_STOPPED;
+
+    hooks_emit(HOOK_HOTSPOT_STOPPED, "\"ap_iface\":\"%s\"", status->ap_iface);
     return true;
 }
 
@@ -767,43 +1580,195 @@ bool hotspot_stop(HotspotStatus *status)
 
 void hotspot_cleanup(HotspotStatus *status)
 {
-    /* Kill hostapd */
-    kill_process(status->hostapd_pid, "hostapd");
-    status->hostapd_pid = 0;
+    /* Stop steering and recording before their daemons go away */
+    steer_stop();
+    recorder_stop();
+    state_remove();
+    coord_set_local(status->config.ssid, 0, 0, status->config.max_clients,
+                    false);
 
-    /* Kill dnsmasq (ours) */
-    kill_process(status->dnsmasq_pid, "");
+    /* Daemons (which may be kept) and the main loop lose the boost */
+    restore_sched(status);
+
+    /*
+     * Stop hostapd. A persistent one only drops the AP and stays for
+     * the next start, unless it lives in the namespace going away.
+     */
+    bool hapd_kept = false;
+    if (status->hostapd_pid > 0 && status->hostapd_pid == hapd_daemon_pid()) {
+        hapd_remove(status->ap_iface);
+        if (status->netns) hapd_daemon_stop();
+        else hapd_kept = true;
+    } else {
+        kill_process(status->hostapd_pid, "hostapd");
+    }
+    status->hostapd_pid = 0;
 
+    /*
+     * dnsmasq (ours) stays with its leases for the next start, unless
+     * it is in the namespace or a bridge start must not find it.
+     */
     char cmd[MAX_CMD_LEN];
-    snprintf(cmd, sizeof(cmd),
-             "pkill -f '%s' 2>/dev/null", DNSMASQ_CONF_PATH);
-    net_exec_silent(cmd);
+    bool dnsmasq_kept = dnsmasq_alive() && !status->netns &&
+                        status->config.uplink.mode != UPLINK_BRIDGE;
+    if (!dnsmasq_kept) {
+        kill_process(status->dnsmasq_pid, "");
+        kill_process(dnsmasq_alive(), "");
+        g_dnsmasq.pid = 0;
+
+        snprintf(cmd, sizeof(cmd),
+                 "pkill -f '%s' 2>/dev/null", DNSMASQ_CONF_PATH);
+        net_exec_silent(cmd);
+    }
     status->dnsmasq_pid = 0;
 
-    /* Remove NAT rules */
-    remove_nat(status);
+    /* Undo bridge / proxy-ARP changes; hostapd has left the bridge */
+    uplink_stop(&status->config.uplink, status->ap_iface, status->wifi.name,
+                &status->uplink_saved);
+
+    /* Caps table and conntrack sizing go before the NAT they protect */
+    connlimit_stop(&status->connlimit_saved);
+
+    /* Remove NAT rules (a bridge never touched forwarding) */
+    if (status->config.uplink.mode != UPLINK_BRIDGE)
+        remove_nat(status);
+
+    /* Background scans and power save back on the uplink STA */
+    statune_restore(status->wifi.name, &status->sta_saved);
+    txq_aql_restore(ap_phy_name(status), &status->aql_saved);
 
     /* Remove AP interface */
-    snprintf(cmd, sizeof(cmd), "iw dev %s del 2>/dev/null", status->ap_iface);
+    snprintf(cmd, sizeof(cmd), "%siw dev %s del 2>/dev/null",
+             ap_exec(status), status->ap_iface);
     net_exec_silent(cmd);
 
-    /* Restore NetworkManager config */
-    nm_cleanup_unmanaged();
+    /* Radio back to the host, or NetworkManager config restored */
+    if (status->netns) {
+        netns_teardown(status->config.ap_phy);
+        status->netns = false;
+    } else {
+        nm_cleanup_unmanaged();
+    }
+
+    /*
+     * Clean up temp files (one batch). Configs stay in the private run
+     * directory so an unchanged restart can skip rewriting them; copies
+     * an older version left in /tmp (configs, hostapd log) are removed.
+     * Leases stay, so a returning client gets its address back.
+     */
+    FioBatch batch;
+    fio_batch_init(&batch);
+    fio_add_unlink(&batch, LEGACY_HOSTAPD_CONF);
+    fio_add_unlink(&batch, LEGACY_DNSMASQ_CONF);
+    fio_add_unlink(&batch, LEGACY_HOSTAPD_LOG);
+    if (!hapd_kept) fio_add_unlink(&batch, HOSTAPD_LOG_PATH);
+    if (!dnsmasq_kept) {
+        fio_add_unlink(&batch, DNSMASQ_PID_PATH);
+        fio_add_unlink(&batch, DNSMASQ_LOG_PATH);
+    }
+    fio_submit(&batch);
 
-    /* Clean up temp files */
-    unlink(HOSTAPD_CONF_PATH);
-    unlink(DNSMASQ_CONF_PATH);
-    unlink(DNSMASQ_LEASE_FILE);
-    unlink(HOSTAPD_LOG_PATH);
-    unlink("/tmp/hotspot_enabler_dnsmasq.pid");
-    unlink("/tmp/hotspot_enabler_dnsmasq.log");
+    /* A kept hostapd appends to its log; start the next run empty */
+    if (hapd_kept) {
+        int fd = open(HOSTAPD_LOG_PATH, O_WRONLY | O_TRUNC | O_NOFOLLOW | O_CLOEXEC);
+        if (fd >= 0) close(fd);
+    }
 
     status->client_count = 0;
     status->start_time = 0;
+    status->cac_end = 0;
+}
+
+void hotspot_shutdown(void)
+{
+    if (g_hapd_owned) hapd_daemon_stop();
+    g_hapd_owned = false;
+
+    if (dnsmasq_alive()) {
+        kill_process(g_dnsmasq.pid, "");
+        unlink(DNSMASQ_PID_PATH);
+        unlink(DNSMASQ_LOG_PATH);
+    }
+    g_dnsmasq.pid = 0;
 }
 
 /* ── Refresh Status ──────────────────────────────────────────────────── */
 
+static bool client_in_list(const ConnectedClient *list, int count,
+                           const char *mac)
+{
+    for (int i = 0; i < count; i++) {
+        if (strcmp(list[i].mac, mac) == 0) return true;
+    }
+    return false;
+}
+
+static void emit_client_event(HookEvent ev, const ConnectedClient *c)
+{
+    char host[MAX_SSID_LEN * 2], vendor[MAX_SSID_LEN * 2];
+    net_json_escape(host, sizeof(host), c->hostname);
+    net_json_escape(vendor, sizeof(vendor), oui_vendor(c->mac));
+    hooks_emit(ev, "\"mac\":\"%s\",\"ip\":\"%s\",\"hostname\":\"%s\","
+               "\"vendor\":\"%s\"", c->mac, c->ip, host, vendor);
+}
+
+/*
+ * Compare the previous and current client lists and the uplink, and
+ * queue hooks for whatever changed.
+ */
+static void emit_refresh_events(const HotspotStatus *status,
+                                const ConnectedClient *old_clients,
+                                int old_count,
+                                const WifiInterface *old_wifi)
+{
+    for (int i = 0; i < status->client_count; i++) {
+        if (!client_in_list(old_clients, old_count, status->clients[i].mac))
+            emit_client_event(HOOK_CLIENT_JOINED, &status->clients[i]);
+    }
+    for (int i = 0; i < old_count; i++) {
+        if (!client_in_list(status->clients, status->client_count,
+                            old_clients[i].mac))
+            emit_client_event(HOOK_CLIENT_LEFT, &old_clients[i]);
+    }
+
+    if (old_wifi->connected != status->wifi.connected ||
+        strcmp(old_wifi->ssid, status->wifi.ssid) != 0) {
+        char ssid[MAX_SSID_LEN * 2], prev[MAX_SSID_LEN * 2];
+        net_json_escape(ssid, sizeof(ssid), status->wifi.ssid);
+        net_json_escape(prev, sizeof(prev), old_wifi->ssid);
+        hooks_emit(HOOK_UPLINK_CHANGED,
+                   "\"iface\":\"%s\",\"connected\":%s,\"ssid\":\"%s\","
+                   "\"previous_ssid\":\"%s\"",
+                   status->wifi.name,
+                   status->wifi.connected ? "true" : "false", ssid, prev);
+    }
+}
+
+/* Mark clients in the caps' offender set; log the ones new to it */
+static void flag_limited_clients(HotspotStatus *status,
+                                 const ConnectedClient *old_clients, int old_count)
+{
+    char ips[MAX_CLIENTS][MAX_IP_LEN];
+    int n = status->connlimit_saved.table
+            ? connlimit_offenders(ips, MAX_CLIENTS) : 0;
+
+    for (int i = 0; i < status->client_count; i++) {
+        ConnectedClient *c = &status->clients[i];
+        c->limited = false;
+        for (int j = 0; j < n && !c->limited; j++)
+            c->limited = strcmp(c->ip, ips[j]) == 0;
+        if (!c->limited) continue;
+
+        bool was = false;
+        for (int j = 0; j < old_count; j++)
+            if (strcmp(old_clients[j].mac, c->mac) == 0) was = old_clients[j].limited;
+        if (!was && !status->event[0])
+            snprintf(status->event, sizeof(status->event),
+                     "Client %s (%s) hit the connection cap; new connections dropped.",
+                     c->ip, c->hostname[0] ? c->hostname : c->mac);
+    }
+}
+
 void hotspot_refresh_status(HotspotStatus *status)
 {
     if (status->state != HS_STATE_RUNNING) return;
@@ -812,6 +1777,8 @@ void hotspot_refresh_status(HotspotStatus *status)
         snprintf(status->error_msg, sizeof(status->error_msg),
                  "hostapd process died unexpectedly.");
         status->state = HS_STATE_ERROR;
+        hooks_emit(HOOK_DAEMON_CRASHED, "\"daemon\":\"hostapd\",\"pid\":%d",
+                   (int)status->hostapd_pid);
         return;
     }
 
@@ -819,13 +1786,35 @@ void hotspot_refresh_status(HotspotStatus *status)
         snprintf(status->error_msg, sizeof(status->error_msg),
                  "dnsmasq process died unexpectedly.");
         status->state = HS_STATE_ERROR;
+        hooks_emit(HOOK_DAEMON_CRASHED, "\"daemon\":\"dnsmasq\",\"pid\":%d",
+                   (int)status->dnsmasq_pid);
         return;
     }
 
+    if (status->dfs || status->cac_end) watch_hostapd_log(status);
+
+    ConnectedClient old_clients[MAX_CLIENTS];
+    int old_count = status->client_count;
+    WifiInterface old_wifi = status->wifi;
+    memcpy(old_clients, status->clients, sizeof(old_clients));
+
     net_refresh_wifi_status(&status->wifi);
 
-    status->client_count = net_get_connected_clients(
-        status->clients, MAX_CLIENTS);
+    if (status->config.uplink.mode == UPLINK_NAT)
+        status->client_count = net_get_connected_clients(
+            status->clients, MAX_CLIENTS, status->start_time);
+    else
+        status->client_count = uplink_get_clients(
+            &status->config.uplink, status->ap_iface, &status->uplink_saved,
+            status->clients, MAX_CLIENTS);
+
+    flag_limited_clients(status, old_clients, old_count);
+    recorder_note_clients(status->client_count);
+    coord_update(status);
+    emit_refresh_events(status, old_clients, old_count, &old_wifi);
+
+    /* Channel, CAC and /32 routes can change; no write if nothing did */
+    state_save(status, true);
 }
 
 /* ── Uptime String ───────────────────────────────────────────────────── */
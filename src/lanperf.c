@@ -0,0 +1,509 @@
+/*
+ * lanperf.c - Built-in LAN throughput test server for Linux Hotspot Enabler
+ *
+ * One listener thread accepts TCP connections from the AP subnet; each
+ * test then runs on its own thread, up to a configured limit.
+ *
+ * TCP download uses sendfile() from a sparse memfd, so the payload is
+ * never copied through user space and one core can drive line rate.
+ * TCP upload discards data in the kernel with recv(MSG_TRUNC). UDP
+ * pacing batches datagrams with sendmmsg() on a 1 ms tick.
+ *
+ * A UDP test is asked for over TCP and only streams to the address the
+ * connection came from, so a spoofed request cannot point the stream at
+ * someone else.
+ *
+ * Usage from a client (no special tool needed):
+ *   nc 192.168.12.1 5201 > /dev/null                      # download
+ *   (echo up 10; cat /dev/zero) | nc 192.168.12.1 5201     # upload
+ *   nc -u -l 5301 > /dev/null & echo "udp 100 10 5301" | nc 192.168.12.1 5201
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <errno.h>
+#include <stdint.h>
+#include <stddef.h>
+#include <signal.h>
+#include <poll.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include <sys/mman.h>
+#include <sys/sendfile.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+#include <linux/tcp.h>
+
+#include "lanperf.h"
+
+#define LANPERF_CHUNK        (1 << 20)   /* memfd size / sendfile chunk */
+#define LANPERF_DGRAM        1400
+#define LANPERF_BATCH        64
+#define LANPERF_DEFAULT_SECS 10
+#define LANPERF_MAX_MBPS     1000        /* above any client's Wi-Fi link */
+
+/* ── State ───────────────────────────────────────────────────────────── */
+
+static struct {
+    atomic_bool     running;
+    pthread_t       thread;
+    int             tcp_fd;
+    int             udp_fd;
+    int             zero_fd;        /* sparse memfd, source for sendfile */
+    int             max_tests;
+    in_addr_t       subnet;         /* AP /24 (network order); peers from it only */
+
+    pthread_mutex_t lock;
+    pthread_cond_t  idle;
+    int             active;
+    LanPerfResult   results[MAX_CLIENTS];
+} g_perf = {
+    .tcp_fd  = -1,
+    .udp_fd  = -1,
+    .zero_fd = -1,
+    .lock    = PTHREAD_MUTEX_INITIALIZER,
+    .idle    = PTHREAD_COND_INITIALIZER,
+};
+
+typedef struct {
+    int                fd;
+    struct sockaddr_in peer;
+    int                secs;
+    int                mbps;            /* > 0: UDP test */
+    int                udp_port;        /* client port the datagrams go to */
+    bool               upload;
+} PerfTest;
+
+/* ── Helpers ─────────────────────────────────────────────────────────── */
+
+static double mono_now(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+static void record_result(const struct sockaddr_in *peer, LanPerfMode mode,
+                          unsigned long long bytes, double secs)
+{
+    LanPerfResult r;
+    memset(&r, 0, sizeof(r));
+    inet_ntop(AF_INET, &peer->sin_addr, r.ip, sizeof(r.ip));
+    r.mode  = mode;
+    r.bytes = bytes;
+    r.secs  = secs;
+    r.mbps  = secs > 0 ? (bytes * 8.0) / (secs * 1e6) : 0;
+    r.when  = time(NULL);
+
+    pthread_mutex_lock(&g_perf.lock);
+    int slot = 0;
+    for (int i = 0; i < MAX_CLIENTS; i++) {
+        if (strcmp(g_perf.results[i].ip, r.ip) == 0) { slot = i; break; }
+        if (g_perf.results[i].when < g_perf.results[slot].when) slot = i;
+    }
+    g_perf.results[slot] = r;
+    pthread_mutex_unlock(&g_perf.lock);
+}
+
+static int clamp_secs(int secs)
+{
+    if (secs <= 0) return LANPERF_DEFAULT_SECS;
+    return secs > LANPERF_MAX_SECS ? LANPERF_MAX_SECS : secs;
+}
+
+/* ── TCP ─────────────────────────────────────────────────────────────── */
+
+static unsigned long long tcp_down(int fd, int secs, double *elapsed)
+{
+    unsigned long long sent = 0;
+    double start = mono_now(), deadline = start + secs;
+    off_t off = 0;
+
+    while (g_perf.running && mono_now() < deadline) {
+        if (off >= LANPERF_CHUNK) off = 0;
+        ssize_t n = sendfile(fd, g_perf.zero_fd, &off, LANPERF_CHUNK - off);
+        if (n > 0) {
+            sent += (unsigned long long)n;
+        } else if (n < 0 && errno != EAGAIN && errno != EINTR) {
+            break;      /* client went away */
+        }
+    }
+    *elapsed = mono_now() - start;
+
+    /* Count what the client actually acknowledged, not what we queued */
+    struct tcp_info ti;
+    socklen_t len = sizeof(ti);
+    if (getsockopt(fd, IPPROTO_TCP, TCP_INFO, &ti, &len) == 0 &&
+        len >= offsetof(struct tcp_info, tcpi_bytes_acked) +
+               sizeof(ti.tcpi_bytes_acked) &&
+        ti.tcpi_bytes_acked > 0) {
+        return ti.tcpi_bytes_acked;
+    }
+    return sent;
+}
+
+static unsigned long long tcp_up(int fd, int secs, double *elapsed)
+{
+    static char sink[64 * 1024];
+    unsigned long long received = 0;
+    double start = 0, deadline = mono_now() + secs + 1;
+
+    while (g_perf.running && mono_now() < deadline) {
+        /* MSG_TRUNC on TCP discards in the kernel without copying */
+        ssize_t n = recv(fd, sink, sizeof(sink), MSG_TRUNC);
+        if (n > 0) {
+            if (start == 0) start = mono_now();
+            received += (unsigned long long)n;
+        } else if (n == 0 || (errno != EAGAIN && errno != EINTR)) {
+            break;
+        }
+    }
+    *elapsed = start > 0 ? mono_now() - start : 0;
+    return received;
+}
+
+static void parse_tcp_command(int fd, PerfTest *t)
+{
+    char cmd[64] = {0};
+
+    t->upload = false;
+    t->secs   = LANPERF_DEFAULT_SECS;
+
+    /* Give the client a second to say what it wants; silence = download */
+    struct pollfd pfd = { .fd = fd, .events = POLLIN };
+    if (poll(&pfd, 1, 1000) <= 0) return;
+
+    ssize_t n = recv(fd, cmd, sizeof(cmd) - 1, MSG_PEEK);
+    if (n <= 0) return;
+    char *nl = memchr(cmd, '\n', (size_t)n);
+    if (!nl) return;
+
+    /* Consume only the command line; upload data may follow it */
+    if (recv(fd, cmd, (size_t)(nl - cmd + 1), 0) <= 0) return;
+    *nl = '\0';
+
+    int secs = 0, mbps = 0, port = 0;
+    if (sscanf(cmd, "udp %d %d %d", &mbps, &secs, &port) == 3) {
+        if (mbps <= 0 || port <= 0 || port > 65535) return;
+        t->mbps     = mbps > LANPERF_MAX_MBPS ? LANPERF_MAX_MBPS : mbps;
+        t->secs     = clamp_secs(secs);
+        t->udp_port = port;
+    } else if (sscanf(cmd, "up %d", &secs) >= 1 || strcmp(cmd, "up") == 0) {
+        t->upload = true;
+        t->secs   = clamp_secs(secs);
+    } else if (sscanf(cmd, "down %d", &secs) >= 1) {
+        t->secs   = clamp_secs(secs);
+    }
+}
+
+/* ── UDP ─────────────────────────────────────────────────────────────── */
+
+/*
+ * Pace t->mbps of numbered datagrams to the peer's t->udp_port for
+ * t->secs, or until the control connection is reset. Returns the
+ * number sent.
+ */
+static unsigned long long udp_stream(const PerfTest *t, double *elapsed)
+{
+    char dgrams[LANPERF_BATCH][LANPERF_DGRAM];
+    struct iovec iov[LANPERF_BATCH];
+    struct mmsghdr msgs[LANPERF_BATCH];
+    struct sockaddr_in dest = t->peer;
+
+    dest.sin_port = htons((uint16_t)t->udp_port);
+    memset(dgrams, 0, sizeof(dgrams));
+    memset(msgs, 0, sizeof(msgs));
+    for (int i = 0; i < LANPERF_BATCH; i++) {
+        iov[i].iov_base = dgrams[i];
+        iov[i].iov_len  = LANPERF_DGRAM;
+        msgs[i].msg_hdr.msg_iov     = &iov[i];
+        msgs[i].msg_hdr.msg_iovlen  = 1;
+        msgs[i].msg_hdr.msg_name    = &dest;
+        msgs[i].msg_hdr.msg_namelen = sizeof(dest);
+    }
+
+    double rate = t->mbps * 1e6 / 8.0 / LANPERF_DGRAM;    /* datagrams/s */
+    double start = mono_now(), deadline = start + t->secs;
+    unsigned long long seq = 0;
+    struct pollfd ctl = { .fd = t->fd, .events = 0 };  /* a half-close is fine */
+
+    while (g_perf.running) {
+        double now = mono_now();
+        if (now >= deadline ||
+            (poll(&ctl, 1, 0) > 0 && (ctl.revents & (POLLERR | POLLHUP))))
+            break;
+
+        unsigned long long due = (unsigned long long)((now - start) * rate);
+        while (seq < due) {
+            int batch = (due - seq) > LANPERF_BATCH ? LANPERF_BATCH :
+                        (int)(due - seq);
+            for (int i = 0; i < batch; i++) {
+                uint64_t s = seq + (uint64_t)i;
+                uint64_t ns = (uint64_t)(now * 1e9);
+                memcpy(dgrams[i], &s, sizeof(s));
+                memcpy(dgrams[i] + sizeof(s), &ns, sizeof(ns));
+            }
+            int n = sendmmsg(g_perf.udp_fd, msgs, (unsigned)batch, 0);
+            if (n <= 0) break;
+            seq += (unsigned long long)n;
+        }
+        usleep(1000);
+    }
+
+    *elapsed = mono_now() - start;
+    return seq;
+}
+
+/* ── Test thread ─────────────────────────────────────────────────────── */
+
+static void *tcp_test(void *arg)
+{
+    PerfTest *t = arg;
+    double elapsed = 0;
+
+    parse_tcp_command(t->fd, t);
+
+    struct timeval tv = { .tv_sec = 0, .tv_usec = 200000 };
+    setsockopt(t->fd, SOL_SOCKET, SO_SNDTIMEO, &tv, sizeof(tv));
+    setsockopt(t->fd, SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof(tv));
+
+    if (t->mbps > 0) {
+        unsigned long long n = udp_stream(t, &elapsed);
+        char done[64];
+        int len = snprintf(done, sizeof(done), "done %llu\n", n);
+        send(t->fd, done, (size_t)len, MSG_NOSIGNAL);
+        record_result(&t->peer, LANPERF_UDP_DOWN, n * LANPERF_DGRAM, elapsed);
+    } else if (t->upload) {
+        unsigned long long b = tcp_up(t->fd, t->secs, &elapsed);
+        record_result(&t->peer, LANPERF_TCP_UP, b, elapsed);
+    } else {
+        unsigned long long b = tcp_down(t->fd, t->secs, &elapsed);
+        record_result(&t->peer, LANPERF_TCP_DOWN, b, elapsed);
+    }
+
+    close(t->fd);
+    free(t);
+
+    pthread_mutex_lock(&g_perf.lock);
+    if (--g_perf.active == 0) pthread_cond_broadcast(&g_perf.idle);
+    pthread_mutex_unlock(&g_perf.lock);
+    return NULL;
+}
+
+/* ── Listener ────────────────────────────────────────────────────────── */
+
+static bool spawn_test(void *(*fn)(void *), PerfTest *t)
+{
+    pthread_mutex_lock(&g_perf.lock);
+    if (g_perf.active >= g_perf.max_tests) {
+        pthread_mutex_unlock(&g_perf.lock);
+        return false;
+    }
+    g_perf.active++;
+    pthread_mutex_unlock(&g_perf.lock);
+
+    pthread_t th;
+    pthread_attr_t attr;
+    pthread_attr_init(&attr);
+    pthread_attr_setdetachstate(&attr, PTHREAD_CREATE_DETACHED);
+    bool ok = (pthread_create(&th, &attr, fn, t) == 0);
+    pthread_attr_destroy(&attr);
+
+    if (!ok) {
+        pthread_mutex_lock(&g_perf.lock);
+        g_perf.active--;
+        pthread_mutex_unlock(&g_perf.lock);
+    }
+    return ok;
+}
+
+static void accept_tcp(void)
+{
+    PerfTest *t = calloc(1, sizeof(PerfTest));
+    if (!t) return;
+
+    socklen_t len = sizeof(t->peer);
+    t->fd = accept4(g_perf.tcp_fd, (struct sockaddr *)&t->peer, &len,
+                    SOCK_CLOEXEC);
+    if (t->fd < 0) {
+        free(t);
+        return;
+    }
+    if ((t->peer.sin_addr.s_addr & htonl(0xffffff00)) != g_perf.subnet ||
+        !spawn_test(tcp_test, t)) {
+        close(t->fd);
+        free(t);
+    }
+}
+
+static void *listener_thread(void *arg)
+{
+    (void)arg;
+    struct pollfd pfd = { .fd = g_perf.tcp_fd, .events = POLLIN };
+
+    while (g_perf.running) {
+        if (poll(&pfd, 1, 500) > 0 && (pfd.revents & POLLIN)) accept_tcp();
+    }
+    return NULL;
+}
+
+/* ── Public API ──────────────────────────────────────────────────────── */
+
+static int bind_socket(int type, const struct sockaddr_in *sa)
+{
+    int fd = socket(AF_INET, type | SOCK_CLOEXEC, 0);
+    if (fd < 0) return -1;
+
+    int one = 1;
+    setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+    setsockopt(fd, IPPROTO_IP, IP_FREEBIND, &one, sizeof(one));
+
+    if (bind(fd, (const struct sockaddr *)sa, sizeof(*sa)) < 0 ||
+        (type == SOCK_STREAM && listen(fd, 8) < 0)) {
+        close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+bool lanperf_start(const char *bind_ip, int port, int max_tests,
+                   char *err, size_t errsize)
+{
+    if (g_perf.running) return true;
+
+    struct sockaddr_in sa;
+    memset(&sa, 0, sizeof(sa));
+    sa.sin_family = AF_INET;
+    sa.sin_port   = htons((uint16_t)port);
+    if (inet_pton(AF_INET, bind_ip, &sa.sin_addr) != 1) {
+        snprintf(err, errsize, "invalid address %s", bind_ip);
+        return false;
+    }
+
+    g_perf.zero_fd = memfd_create("lanperf-zero", MFD_CLOEXEC);
+    if (g_perf.zero_fd < 0 || ftruncate(g_perf.zero_fd, LANPERF_CHUNK) < 0) {
+        snprintf(err, errsize, "memfd: %s", strerror(errno));
+        lanperf_stop();
+        return false;
+    }
+
+    /* UDP tests only send: any source port, nothing listens for requests */
+    struct sockaddr_in usa = sa;
+    usa.sin_port  = 0;
+    g_perf.subnet = sa.sin_addr.s_addr & htonl(0xffffff00);   /* AP_NETMASK */
+    g_perf.tcp_fd = bind_socket(SOCK_STREAM, &sa);
+    g_perf.udp_fd = bind_socket(SOCK_DGRAM, &usa);
+    if (g_perf.tcp_fd < 0 || g_perf.udp_fd < 0) {
+        snprintf(err, errsize, "bind %s:%d: %s", bind_ip, port, strerror(errno));
+        lanperf_stop();
+        return false;
+    }
+
+    g_perf.max_tests = max_tests < 1 ? 1 :
+                       max_tests > LANPERF_MAX_TESTS ? LANPERF_MAX_TESTS :
+                       max_tests;
+
+    /* Test threads inherit this mask: signals stay with the main loop */
+    sigset_t all, old;
+    sigfillset(&all);
+    pthread_sigmask(SIG_SETMASK, &all, &old);
+    g_perf.running = true;
+    bool ok = (pthread_create(&g_perf.thread, NULL, listener_thread, NULL) == 0);
+    pthread_sigmask(SIG_SETMASK, &old, NULL);
+
+    if (!ok) {
+        g_perf.running = false;
+        snprintf(err, errsize, "cannot start listener thread");
+        lanperf_stop();
+        return false;
+    }
+    return true;
+}
+
+bool lanperf_get_result(const char *ip, LanPerfResult *out)
+{
+    bool found = false;
+
+    pthread_mutex_lock(&g_perf.lock);
+    for (int i = 0; i < MAX_CLIENTS; i++) {
+        if (g_perf.results[i].when && strcmp(g_perf.results[i].ip, ip) == 0) {
+            *out = g_perf.results[i];
+            found = true;
+            break;
+        }
+    }
+    pthread_mutex_unlock(&g_perf.lock);
+    return found;
+}
+
+const char *lanperf_mode_name(LanPerfMode mode)
+{
+    switch (mode) {
+        case LANPERF_TCP_DOWN: return "down";
+        case LANPERF_TCP_UP:   return "up";
+        case LANPERF_UDP_DOWN: return "udp";
+        default:               return "?";
+    }
+}
+
+void lanperf_stop(void)
+{
+    if (g_perf.running) {
+        g_perf.running = false;
+        pthread_join(g_perf.thread, NULL);
+
+        pthread_mutex_lock(&g_perf.lock);
+        while (g_perf.active > 0)
+            pthread_cond_wait(&g_perf.idle, &g_perf.lock);
+        pthread_mutex_unlock(&g_perf.lock);
+    }
+
+    if (g_perf.tcp_fd >= 0)  close(g_perf.tcp_fd);
+    if (g_perf.udp_fd >= 0)  close(g_perf.udp_fd);
+    if (g_perf.zero_fd >= 0) close(g_perf.zero_fd);
+    g_perf.tcp_fd = g_perf.udp_fd = g_perf.zero_fd = -1;
+}
+
+/* ── Standalone server ───────────────────────────────────────────────── */
+
+int lanperf_serve(int argc, char **argv)
+{
+    if (argc < 1) {
+        fprintf(stderr, "usage: lanperf-serve IP [PORT] [SECONDS]\n");
+        return 2;
+    }
+    int port = argc > 1 ? atoi(argv[1]) : LANPERF_DEFAULT_PORT;
+    int seconds = argc > 2 ? atoi(argv[2]) : 0;
+
+    char err[MAX_LINE_LEN];
+    if (!lanperf_start(argv[0], port, LANPERF_MAX_TESTS, err, sizeof(err))) {
+        fprintf(stderr, "lanperf-serve: %s\n", err);
+        return 1;
+    }
+    printf("# serving %s:%d\n", argv[0], port);
+    fflush(stdout);
+
+    time_t seen[MAX_CLIENTS] = {0};
+    double start = mono_now();
+    while (seconds <= 0 || mono_now() - start < seconds) {
+        usleep(100000);
+        pthread_mutex_lock(&g_perf.lock);
+        for (int i = 0; i < MAX_CLIENTS; i++) {
+            const LanPerfResult *r = &g_perf.results[i];
+            if (!r->when || r->when == seen[i]) continue;
+            seen[i] = r->when;
+            printf("result ip=%s mode=%s bytes=%llu secs=%.2f mbps=%.1f\n",
+                   r->ip, lanperf_mode_name(r->mode), r->bytes, r->secs,
+                   r->mbps);
+        }
+        pthread_mutex_unlock(&g_perf.lock);
+        fflush(stdout);
+    }
+
+    lanperf_stop();
+    return 0;
+}
@@ -2,31 +2,135 @@
  * main.c - Entry point for Linux Hotspot Enabler
  *
  * Checks root privileges, verifies dependencies, detects WiFi interface,
- * and launches the ncurses TUI.
+ * and launches the ncurses TUI. Headless builds (HOTSPOT_NO_TUI) start
+ * the hotspot straight away and log to stdout until SIGINT/SIGTERM.
  */
 
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <stdarg.h>
 #include <signal.h>
+#include <errno.h>
+#include <time.h>
 #include <unistd.h>
 #include <sys/types.h>
 
 #include "net_utils.h"
 #include "hotspot.h"
+#include "bench.h"
+#include "config.h"
+#include "doctor.h"
+#include "fileio.h"
+#include "hooks.h"
+#include "lanperf.h"
+#include "web.h"
+#ifndef HOTSPOT_NO_TUI
 #include "tui.h"
+#endif
+
+#define HOTSPOT_VERSION "1.0"
+
+#ifdef HOTSPOT_NO_TUI
+/* Same levels as the TUI log, which is not built in */
+typedef enum { LOG_INFO, LOG_WARN, LOG_ERROR, LOG_SUCCESS } LogLevel;
+#endif
 
 /* ── Globals for signal handling ─────────────────────────────────────── */
 
 static HotspotStatus g_hs_status;
+static AppConfig     g_app;
+#ifndef HOTSPOT_NO_TUI
 static TuiState      g_tui;
+#endif
 static volatile sig_atomic_t g_shutdown = 0;
+static volatile sig_atomic_t g_upgrade  = 0;   /* SIGUSR2: detach + re-exec */
 
 static void signal_handler(int sig)
 {
-    (void)sig;
+    if (sig == SIGUSR2) g_upgrade = 1;
     g_shutdown = 1;
+#ifndef HOTSPOT_NO_TUI
     g_tui.running = false;
+#endif
+}
+
+/* SIGUSR1: dump the flight recorder; the write happens on its thread */
+static void dump_handler(int sig)
+{
+    (void)sig;
+    recorder_request_dump();
+}
+
+/*
+ * Path of our binary, for re-exec on upgrade. After "make install"
+ * replaces the file, /proc/self/exe reads "<path> (deleted)"; the path
+ * itself then holds the new binary.
+ */
+static bool exe_path(char *buf, size_t size)
+{
+    ssize_t n = readlink("/proc/self/exe", buf, size - 1);
+    if (n <= 0) return false;
+    buf[n] = '\0';
+
+    const char *suffix = " (deleted)";
+    size_t len = strlen(buf), slen = strlen(suffix);
+    if (len > slen && strcmp(buf + len - slen, suffix) == 0) buf[len - slen] = '\0';
+    return true;
+}
+
+/* ── Logging (TUI log pane, or stdout when headless) ─────────────────── */
+
+static void app_log(LogLevel level, const char *fmt, ...)
+    __attribute__((format(printf, 2, 3)));
+
+static void app_log(LogLevel level, const char *fmt, ...)
+{
+    char msg[MAX_CMD_LEN];
+    va_list args;
+    va_start(args, fmt);
+    vsnprintf(msg, sizeof(msg), fmt, args);
+    va_end(args);
+
+#ifdef HOTSPOT_NO_TUI
+    static const char *tags[] = { "info", "warn", "error", "ok" };
+    char ts[16];
+    time_t now = time(NULL);
+    strftime(ts, sizeof(ts), "%H:%M:%S", localtime(&now));
+    printf("[%s] %-5s %s\n", ts, tags[level], msg);
+    fflush(stdout);
+#else
+    tui_log(&g_tui, level, "%s", msg);
+#endif
+}
+
+/* ── Version / compiled-in features ──────────────────────────────────── */
+
+static void print_version(void)
+{
+    printf("hotspot-enabler %s\n", HOTSPOT_VERSION);
+    printf("features:");
+#ifdef HOTSPOT_NO_TUI
+    printf(" -tui");
+#else
+    printf(" +tui");
+#endif
+#ifdef HOTSPOT_NO_WEB
+    printf(" -web");
+#else
+    printf(" +web");
+#endif
+#ifdef HOTSPOT_NO_HOOKS
+    printf(" -hooks");
+#else
+    printf(" +hooks");
+#endif
+#ifdef HOTSPOT_NO_LANPERF
+    printf(" -lanperf");
+#else
+    printf(" +lanperf");
+#endif
+    printf("\n");
 }
 
 /* ── Print banner (non-TUI mode) ─────────────────────────────────────── */
@@ -63,12 +167,183 @@ static int check_and_report_deps(void)
     return 1;
 }
 
+/* ── Optional services ───────────────────────────────────────────────── */
+
+/* Sockets bound here live in the host namespace, where an isolated run
+ * (isolation = netns) has no AP gateway address: refuse those listeners */
+static bool on_ap_gateway(const char *listen)
+{
+    size_t n = strlen(AP_GATEWAY);
+    return strncmp(listen, AP_GATEWAY, n) == 0 &&
+           (listen[n] == ':' || listen[n] == '\0');
+}
+
+static void start_services(void)
+{
+    char err[MAX_CMD_LEN] = {0};
+    bool isolated = g_hs_status.config.netns;
+
+    if (g_app.http_listen[0] && isolated && on_ap_gateway(g_app.http_listen)) {
+        app_log(LOG_WARN, "Status dashboard disabled: %s is inside the "
+                "hotspot namespace (isolation = netns).", AP_GATEWAY);
+    } else if (g_app.http_listen[0]) {
+        if (web_start(g_app.http_listen, g_app.http_max_viewers,
+                      err, sizeof(err))) {
+            app_log(LOG_INFO, "Status dashboard: http://%s/", g_app.http_listen);
+        } else {
+            app_log(LOG_WARN, "Status dashboard disabled: %s", err);
+        }
+    }
+
+    if (g_app.lanperf && isolated) {
+        app_log(LOG_WARN, "Throughput test server disabled: %s is inside "
+                "the hotspot namespace (isolation = netns).", AP_GATEWAY);
+    } else if (g_app.lanperf) {
+        if (lanperf_start(AP_GATEWAY, g_app.lanperf_port,
+                          g_app.lanperf_max_tests, err, sizeof(err))) {
+            app_log(LOG_INFO, "Throughput test server on %s:%d",
+                    AP_GATEWAY, g_app.lanperf_port);
+        } else {
+            app_log(LOG_WARN, "Throughput test server disabled: %s", err);
+        }
+    }
+
+    /* Before the hotspot starts: the first channel pick listens to peers */
+    if (g_hs_status.config.coord.enabled) {
+        if (coord_start(&g_hs_status.config.coord, err, sizeof(err))) {
+            app_log(LOG_INFO, "Coordinating with other hotspots on %s:%d",
+                    g_hs_status.config.coord.group,
+                    g_hs_status.config.coord.port);
+        } else {
+            app_log(LOG_WARN, "Multi-node coordination disabled: %s", err);
+        }
+    }
+
+    if (!hooks_start(&g_app.hooks)) {
+        app_log(LOG_WARN, "Event hooks disabled: cannot start workers.");
+    }
+}
+
+/* ── Headless Daemon Loop ────────────────────────────────────────────── */
+
+#ifdef HOTSPOT_NO_TUI
+static long peak_rss_kb(void)
+{
+    FILE *fp = fopen("/proc/self/status", "r");
+    if (!fp) return -1;
+
+    char line[MAX_LINE_LEN];
+    long kb = -1;
+    while (fgets(line, sizeof(line), fp)) {
+        if (sscanf(line, "VmHWM: %ld kB", &kb) == 1) break;
+    }
+    fclose(fp);
+    return kb;
+}
+
+/* Start immediately and keep the hotspot up until signalled; same
+ * refresh cadence as the TUI. Returns the process exit code. */
+static int run_headless(void)
+{
+    if (g_hs_status.state == HS_STATE_RUNNING) {
+        app_log(LOG_SUCCESS, "Reattached to running hotspot (hostapd pid %d)",
+                (int)g_hs_status.hostapd_pid);
+    } else {
+        app_log(LOG_INFO, "Starting hotspot...");
+        if (!hotspot_start(&g_hs_status)) {
+            app_log(LOG_ERROR, "Failed: %s", g_hs_status.error_msg);
+            return 1;
+        }
+        app_log(LOG_SUCCESS, "Hotspot started! SSID: %s", g_hs_status.config.ssid);
+    }
+    if (g_hs_status.notice[0]) app_log(LOG_WARN, "%s", g_hs_status.notice);
+    app_log(LOG_INFO, "Peak RSS after start: %ld kB", peak_rss_kb());
+
+    int    last_clients = 0;
+    time_t last_refresh = time(NULL);
+
+    while (!g_shutdown) {
+        time_t now = time(NULL);
+        if (now - last_refresh >= 2) {
+            hotspot_refresh_status(&g_hs_status);
+            last_refresh = now;
+            if (g_hs_status.event[0]) {
+                app_log(LOG_WARN, "%s", g_hs_status.event);
+                g_hs_status.event[0] = '\0';
+            }
+
+            if (g_hs_status.state != HS_STATE_RUNNING) {
+                app_log(LOG_ERROR, "Hotspot failed: %s", g_hs_status.error_msg);
+                return 1;
+            }
+            if (g_hs_status.client_count != last_clients) {
+                last_clients = g_hs_status.client_count;
+                app_log(LOG_INFO, "%d client(s) connected", last_clients);
+            }
+        }
+
+        web_publish(&g_hs_status);
+
+        char steer_msg[MAX_LINE_LEN];
+        while (steer_next_event(steer_msg, sizeof(steer_msg)))
+            app_log(LOG_INFO, "%s", steer_msg);
+        while (recorder_next_event(steer_msg, sizeof(steer_msg)))
+            app_log(LOG_WARN, "%s", steer_msg);
+        while (coord_next_event(steer_msg, sizeof(steer_msg)))
+            app_log(LOG_INFO, "%s", steer_msg);
+
+        usleep(500000);
+    }
+
+    app_log(LOG_INFO, "Shutting down...");
+    return 0;
+}
+#endif
+
 /* ── Main ────────────────────────────────────────────────────────────── */
 
 int main(int argc, char *argv[])
 {
-    (void)argc;
-    (void)argv;
+    const char *config_path = CONFIG_DEFAULT_PATH;
+
+    if (argc == 2 && strcmp(argv[1], "doctor") == 0) {
+        print_banner();
+        return doctor_run();
+    }
+    if (argc >= 2 && argc <= 3 && strcmp(argv[1], "bench") == 0) {
+        return bench_run(argc == 3 ? atoi(argv[2]) : BENCH_DEFAULT_ITERATIONS);
+    }
+    if (argc == 3 && strcmp(argv[1], "decode") == 0) {
+        return recorder_decode(argv[2]);
+    }
+    if (argc >= 3 && argc <= 5 && strcmp(argv[1], "lanperf-serve") == 0) {
+        return lanperf_serve(argc - 2, argv + 2);
+    }
+    if (argc >= 5 && argc <= 6 && strcmp(argv[1], "steer-sim") == 0) {
+        return steer_simulate(argc - 2, argv + 2);
+    }
+    if (argc >= 6 && argc <= 8 && strcmp(argv[1], "coord-sim") == 0) {
+        return coord_simulate(argc - 2, argv + 2);
+    }
+    if (argc == 2 && strcmp(argv[1], "--version") == 0) {
+        print_version();
+        return 0;
+    }
+
+    for (int i = 1; i < argc; i++) {
+        if ((strcmp(argv[i], "-c") == 0 || strcmp(argv[i], "--config") == 0) &&
+            i + 1 < argc) {
+            config_path = argv[++i];
+        } else {
+            printf("Usage: %s [-c|--config FILE]\n"
+                   "       %s doctor | bench [N] | decode DUMP | --version\n"
+                   "       %s coord-sim IFACE CHANNEL CLIENTS MAX [SECONDS] [KEY]\n"
+                   "       %s lanperf-serve IP [PORT] [SECONDS]\n"
+                   "       %s steer-sim IFACE PEER_BSSID PEER_CHANNEL [SECONDS]\n",
+                   argv[0], argv[0], argv[0], argv[0], argv[0]);
+            return 1;
+        }
+    }
 
     print_banner();
 
@@ -85,8 +360,16 @@ int main(int argc, char *argv[])
     }
     printf("  ✓ All dependencies found.\n");
 
-    /* 3. Init hotspot status */
+    /* 3. Init hotspot status and apply the config file */
     hotspot_init(&g_hs_status);
+    config_default(&g_app);
+
+    char err[MAX_CMD_LEN] = {0};
+    if (!config_load(config_path, &g_hs_status.config, &g_app,
+                     err, sizeof(err))) {
+        printf("  ✗ Config error: %s\n\n", err);
+        return 1;
+    }
 
     /* 4. Detect WiFi interface */
     if (!net_detect_wifi_interface(&g_hs_status.wifi)) {
@@ -108,10 +391,25 @@ int main(int argc, char *argv[])
     net_get_phy_name(g_hs_status.wifi.name,
                      g_hs_status.phy, sizeof(g_hs_status.phy));
 
+    /* Adopt a hotspot an earlier process (or our pre-upgrade self) left up */
+    bool reattached = hotspot_reattach(&g_hs_status, err, sizeof(err));
+    if (reattached) {
+        printf("  ✓ Reattached to running hotspot \"%s\" (hostapd pid %d).\n",
+               g_hs_status.config.ssid, (int)g_hs_status.hostapd_pid);
+    } else if (err[0]) {
+        printf("  ⚠ Not reattaching: %s\n", err);
+    }
+
     if (g_hs_status.wifi.supports_ap) {
         printf("  ✓ AP/STA concurrency supported.\n");
+    } else if (reattached) {
+        /* Already running; a SIGUSR2 re-exec has no one at the tty to ask */
+        printf("  ⚠ AP/STA concurrency may not be supported by your adapter.\n");
     } else {
         printf("  ⚠ AP/STA concurrency may not be supported by your adapter.\n");
+#ifdef HOTSPOT_NO_TUI
+        printf("    The hotspot might not work; trying anyway.\n");
+#else
         printf("    The hotspot might not work. Try anyway? [Y/n] ");
         fflush(stdout);
         int c = getchar();
@@ -119,10 +417,15 @@ int main(int argc, char *argv[])
             printf("\n  Exiting.\n\n");
             return 1;
         }
+#endif
     }
 
+#ifndef HOTSPOT_NO_TUI
     printf("\n  Launching TUI...\n");
     usleep(500000);
+#else
+    printf("\n");
+#endif
 
     /* 5. Setup signal handlers */
     struct sigaction sa;
@@ -131,11 +434,48 @@ int main(int argc, char *argv[])
     sigemptyset(&sa.sa_mask);
     sigaction(SIGINT,  &sa, NULL);
     sigaction(SIGTERM, &sa, NULL);
+    sigaction(SIGUSR2, &sa, NULL);
+    sa.sa_handler = dump_handler;
+    sigaction(SIGUSR1, &sa, NULL);
 
-    /* 6. Init and run TUI */
+    /* 6. Run the TUI or the headless loop, with the optional services */
+    int rc = 0;
+#ifdef HOTSPOT_NO_TUI
+    start_services();
+    rc = run_headless();
+#else
     tui_init(&g_tui, &g_hs_status);
+    if (g_hs_status.state == HS_STATE_RUNNING)
+        app_log(LOG_SUCCESS, "Reattached to running hotspot (hostapd pid %d)",
+                (int)g_hs_status.hostapd_pid);
+    start_services();
     tui_run(&g_tui);
     tui_cleanup(&g_tui);
+#endif
+    web_stop();
+    lanperf_stop();
+    coord_stop();
+
+    /* Upgrade: hand the running hotspot to a fresh copy of the binary */
+    if (g_upgrade && g_hs_status.state == HS_STATE_RUNNING)
+        hotspot_detach(&g_hs_status);
+
+    if (g_hs_status.detached) {
+        hooks_stop();
+        fio_shutdown();
+
+        char exe[MAX_PATH_LEN];
+        if (g_upgrade && exe_path(exe, sizeof(exe))) {
+            printf("\n  Re-executing %s...\n", exe);
+            fflush(stdout);
+            execv(exe, argv);
+            printf("  ✗ exec failed: %s\n", strerror(errno));
+        }
+        printf("\n  ✓ Hotspot left running (hostapd pid %d).\n"
+               "    Run %s again to reattach.\n\n",
+               (int)g_hs_status.hostapd_pid, argv[0]);
+        return rc;
+    }
 
     /* 7. Cleanup on exit */
     printf("\n");
@@ -149,7 +489,10 @@ int main(int argc, char *argv[])
 
     /* Final cleanup - make sure everything is clean */
     hotspot_cleanup(&g_hs_status);
+    hotspot_shutdown();
+    hooks_stop();
+    fio_shutdown();
     printf("  ✓ Cleanup complete. Goodbye!\n\n");
 
-    return 0;
+    return rc;
 }
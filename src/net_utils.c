@@ -16,9 +16,11 @@
 #include <arpa/inet.h>
 #include <sys/ioctl.h>
 #include <net/if.h>
+#include <pthread.h>
 
 #include "net_utils.h"
 #include "hotspot.h"
+#include "fileio.h"
 
 /* ── Helper: Execute command and capture output ──────────────────────── */
 
@@ -48,6 +50,26 @@ int net_exec_silent(const char *cmd)
     return system(cmd);
 }
 
+/* ── Helper: JSON string escaping ────────────────────────────────────── */
+
+void net_json_escape(char *dst, size_t dstsize, const char *src)
+{
+    size_t o = 0;
+
+    for (; *src && o + 7 < dstsize; src++) {
+        unsigned char c = (unsigned char)*src;
+        if (c == '"' || c == '\\') {
+            dst[o++] = '\\';
+            dst[o++] = (char)c;
+        } else if (c < 0x20) {
+            o += snprintf(dst + o, dstsize - o, "\\u%04x", c);
+        } else {
+            dst[o++] = (char)c;
+        }
+    }
+    dst[o] = '\0';
+}
+
 /* ── Dependency Checking ─────────────────────────────────────────────── */
 
 static bool check_tool(const char *name)
@@ -220,6 +242,37 @@ bool net_detect_wifi_interface(WifiInterface *iface)
 
 /* ── Refresh WiFi Status ─────────────────────────────────────────────── */
 
+/* The uplink's sysfs address file stays registered across refreshes */
+static struct {
+    pthread_mutex_t lock;
+    char            iface[MAX_IFACE_NAME];
+    int             slot;
+} g_mac_file = { PTHREAD_MUTEX_INITIALIZER, "", -1 };
+
+static bool read_mac_address(const char *iface, char *buf, size_t size)
+{
+    pthread_mutex_lock(&g_mac_file.lock);
+    if (g_mac_file.slot < 0 || strcmp(g_mac_file.iface, iface) != 0) {
+        char path[MAX_PATH_LEN];
+        fio_unregister(g_mac_file.slot);
+        snprintf(path, sizeof(path), "/sys/class/net/%s/address", iface);
+        g_mac_file.slot = fio_register(path);
+        snprintf(g_mac_file.iface, sizeof(g_mac_file.iface), "%s", iface);
+    }
+
+    FioBatch batch;
+    fio_batch_init(&batch);
+    fio_add_read_slot(&batch, g_mac_file.slot, buf, size);
+    bool ok = g_mac_file.slot >= 0 && fio_submit(&batch);
+    if (!ok) {
+        /* Interface gone or re-created: open it again next time */
+        fio_unregister(g_mac_file.slot);
+        g_mac_file.slot = -1;
+    }
+    pthread_mutex_unlock(&g_mac_file.lock);
+    return ok;
+}
+
 bool net_refresh_wifi_status(WifiInterface *iface)
 {
     char cmd[MAX_CMD_LEN];
@@ -261,9 +314,7 @@ bool net_refresh_wifi_status(WifiInterface *iface)
     }
 
     /* Get MAC address */
-    snprintf(cmd, sizeof(cmd),
-             "cat /sys/class/net/%s/address 2>/dev/null", iface->name);
-    if (net_exec_cmd(cmd, output, sizeof(output))) {
+    if (read_mac_address(iface->name, output, sizeof(output))) {
         char *nl = strchr(output, '\n');
         if (nl) *nl = '\0';
         strncpy(iface->mac, output, MAX_MAC_LEN - 1);
@@ -282,16 +333,9 @@ bool net_get_phy_name(const char *iface, char *phy, size_t physize)
     char path[MAX_PATH_LEN];
     snprintf(path, sizeof(path), "/sys/class/net/%s/phy80211/name", iface);
 
-    FILE *fp = fopen(path, "r");
-    if (!fp) return false;
-
-    if (fgets(phy, physize, fp)) {
-        phy[strcspn(phy, "\n")] = '\0';
-        fclose(fp);
-        return true;
-    }
-    fclose(fp);
-    return false;
+    if (!fio_read_file(path, phy, physize) || !phy[0]) return false;
+    phy[strcspn(phy, "\n")] = '\0';
+    return true;
 }
 
 /* ── AP/STA Concurrency Check ────────────────────────────────────────── */
@@ -337,6 +381,44 @@ bool net_check_ap_support(const char *phy)
     return false;
 }
 
+/* ── Channel Flags ───────────────────────────────────────────────────── */
+
+/*
+ * Frequency lines in "iw phy <phy> info" look like:
+ *     * 5260 MHz [52] (20.0 dBm) (no IR, radar detection)
+ *     * 2484 MHz [14] (disabled)
+ * Older iw prints "passive scanning" instead of "no IR".
+ */
+bool net_get_channel_flags(const char *phy, int channel, ChannelFlags *flags)
+{
+    char cmd[MAX_CMD_LEN];
+    char tag[16];
+
+    memset(flags, 0, sizeof(ChannelFlags));
+    snprintf(tag, sizeof(tag), "[%d]", channel);
+    snprintf(cmd, sizeof(cmd), "iw phy %s info 2>/dev/null", phy);
+
+    FILE *fp = popen(cmd, "r");
+    if (!fp) return false;
+
+    char line[MAX_LINE_LEN];
+    while (fgets(line, sizeof(line), fp)) {
+        if (!strstr(line, " MHz ") || !strstr(line, tag)) continue;
+
+        const char *star = strchr(line, '*');
+        flags->found    = true;
+        flags->freq_mhz = star ? atoi(star + 1) : 0;
+        flags->disabled = (strstr(line, "disabled") != NULL);
+        flags->no_ir    = (strstr(line, "no IR") != NULL ||
+                           strstr(line, "passive scanning") != NULL);
+        flags->radar    = (strstr(line, "radar detection") != NULL);
+        break;
+    }
+    pclose(fp);
+
+    return flags->found;
+}
+
 /* ── Get Current Channel ─────────────────────────────────────────────── */
 
 int net_get_current_channel(const char *iface)
@@ -356,21 +438,65 @@ int net_get_current_channel(const char *iface)
 
 /* ── Connected Clients ───────────────────────────────────────────────── */
 
-int net_get_connected_clients(ConnectedClient *clients, int max_clients)
+static int parse_leases(const char *path, ConnectedClient *clients,
+                        int max_clients, time_t since);
+
+int net_get_connected_clients(ConnectedClient *clients, int max_clients,
+                              time_t since)
+{
+    return parse_leases(DNSMASQ_LEASE_FILE, clients, max_clients, since);
+}
+
+int net_parse_lease_file(const char *path, ConnectedClient *clients,
+                         int max_clients)
+{
+    return parse_leases(path, clients, max_clients, 0);
+}
+
+static int parse_leases(const char *path, ConnectedClient *clients,
+                        int max_clients, time_t since)
 {
     int count = 0;
 
-    /* Read dnsmasq lease file */
-    FILE *fp = fopen(DNSMASQ_LEASE_FILE, "r");
-    if (!fp) return 0;
+    /*
+     * Read dnsmasq lease file in one go. Expired leases stay in it until
+     * dnsmasq rewrites it, so it can outgrow the stack buffer: size a
+     * heap one from the file then, and drop a last line cut short by a
+     * write that landed after the stat.
+     */
+    char stack_text[MAX_CLIENTS * MAX_LINE_LEN];
+    char *text = stack_text;
+    size_t size = sizeof(stack_text);
+    struct stat st;
+    if (stat(path, &st) == 0 && (size_t)st.st_size >= size) {
+        size = (size_t)st.st_size + MAX_LINE_LEN;
+        text = malloc(size);
+        if (!text) return 0;
+    }
+    if (!fio_read_file(path, text, size)) {
+        if (text != stack_text) free(text);
+        return 0;
+    }
+    size_t len = strlen(text);
+    if (len == size - 1 && text[len - 1] != '\n') {
+        char *last = strrchr(text, '\n');
+        if (last) last[1] = '\0';
+        else text[0] = '\0';
+    }
 
-    char line[MAX_LINE_LEN];
-    while (fgets(line, sizeof(line), fp) && count < max_clients) {
+    char *save = NULL;
+    for (char *line = strtok_r(text, "\n", &save);
+         line && count < max_clients; line = strtok_r(NULL, "\n", &save)) {
         /* Format: timestamp mac ip hostname clientid */
         char ts[32], mac[MAX_MAC_LEN], ip[MAX_IP_LEN], hostname[MAX_SSID_LEN];
         if (sscanf(line, "%31s %17s %45s %63s", ts, mac, ip, hostname) >= 3) {
+            /* Expiry 0 = infinite; otherwise granted AP_LEASE_SECS before */
+            long expires = atol(ts);
+            if (since && expires && expires - AP_LEASE_SECS < (long)since)
+                continue;
             strncpy(clients[count].mac, mac, MAX_MAC_LEN - 1);
             strncpy(clients[count].ip, ip, MAX_IP_LEN - 1);
+            clients[count].limited = false;
             if (hostname[0] == '*') {
                 strncpy(clients[count].hostname, "(unknown)", MAX_SSID_LEN - 1);
             } else {
@@ -379,7 +505,7 @@ int net_get_connected_clients(ConnectedClient *clients, int max_clients)
             count++;
         }
     }
-    fclose(fp);
 
+    if (text != stack_text) free(text);
     return count;
 }
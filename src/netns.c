@@ -0,0 +1,99 @@
+/*
+ * netns.c - Network namespace isolation for Linux Hotspot Enabler
+ *
+ * A wireless interface cannot change namespace on its own; the whole
+ * wiphy moves ("iw phy X set netns"), which is why isolation needs a
+ * radio the uplink does not use. cfg80211 hands wiphys back to the
+ * initial namespace when a namespace dies, so a crash leaves no radio
+ * stranded; teardown still moves it back first so its name is usable
+ * right away. NetworkManager leaves veth devices it did not create
+ * unmanaged.
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "netns.h"
+#include "net_utils.h"
+
+#define NETNS_PATH  "/run/netns/" NETNS_NAME
+
+static bool run(char *err, size_t errsize, const char *what, const char *cmd)
+{
+    if (net_exec_silent(cmd) == 0) return true;
+    snprintf(err, errsize, "%s failed", what);
+    return false;
+}
+
+bool netns_setup(const char *phy, const char *ap_subnet,
+                 char *err, size_t errsize)
+{
+    char cmd[MAX_CMD_LEN];
+
+    netns_teardown(phy);
+
+    if (!run(err, errsize, "ip netns add " NETNS_NAME,
+             "ip netns add " NETNS_NAME " 2>/dev/null"))
+        return false;
+
+    snprintf(cmd, sizeof(cmd), "iw phy %s set netns name " NETNS_NAME " 2>/dev/null", phy);
+    if (net_exec_silent(cmd) != 0) {
+        snprintf(err, errsize, "cannot move %s into the namespace "
+                 "(driver without netns support?)", phy);
+        netns_teardown(NULL);
+        return false;
+    }
+
+    /* One transaction per side: link, addresses, up, routes */
+    snprintf(cmd, sizeof(cmd),
+             "ip link add " NETNS_VETH_HOST " type veth peer name " NETNS_VETH_NS
+             " netns " NETNS_NAME " 2>/dev/null && "
+             "ip addr add " NETNS_HOST_ADDR "/30 dev " NETNS_VETH_HOST " && "
+             "ip link set " NETNS_VETH_HOST " up && "
+             "ip route replace %s via " NETNS_NS_ADDR " dev " NETNS_VETH_HOST,
+             ap_subnet);
+    bool ok = run(err, errsize, "veth setup on the host", cmd);
+
+    if (ok)
+        ok = run(err, errsize, "veth setup in the namespace",
+                 NETNS_EXEC "sh -c '"
+                 "ip link set lo up && "
+                 "ip addr add " NETNS_NS_ADDR "/30 dev " NETNS_VETH_NS " && "
+                 "ip link set " NETNS_VETH_NS " up && "
+                 "ip route add default via " NETNS_HOST_ADDR " && "
+                 "echo 1 > /proc/sys/net/ipv4/ip_forward' 2>/dev/null");
+
+    if (!ok) netns_teardown(phy);
+    return ok;
+}
+
+void netns_teardown(const char *phy)
+{
+    char cmd[MAX_CMD_LEN];
+
+    if (access(NETNS_PATH, F_OK) == 0) {
+        if (phy && phy[0]) {
+            snprintf(cmd, sizeof(cmd),
+                     NETNS_EXEC "iw phy %s set netns 1 2>/dev/null", phy);
+            net_exec_silent(cmd);
+        }
+        net_exec_silent("ip netns del " NETNS_NAME " 2>/dev/null");
+    }
+
+    /* Deleting either end removes the pair and the subnet route */
+    net_exec_silent("ip link del " NETNS_VETH_HOST " 2>/dev/null");
+}
+
+bool netns_present(void)
+{
+    return access(NETNS_PATH, F_OK) == 0 &&
+           access("/sys/class/net/" NETNS_VETH_HOST, F_OK) == 0;
+}
+
+bool netns_has_iface(const char *iface)
+{
+    char cmd[MAX_CMD_LEN];
+    snprintf(cmd, sizeof(cmd), NETNS_EXEC "test -e /sys/class/net/%s", iface);
+    return net_exec_silent(cmd) == 0;
+}
@@ -0,0 +1,53 @@
+/*
+ * oui.c - Embedded MAC vendor lookup for Linux Hotspot Enabler
+ */
+
+#include <ctype.h>
+
+#include "oui.h"
+
+static int hex_value(int c)
+{
+    if (c >= '0' && c <= '9') return c - '0';
+    c = tolower(c);
+    if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+    return -1;
+}
+
+/* First three octets as a 24-bit prefix, or -1 */
+static long parse_prefix(const char *mac)
+{
+    long prefix = 0;
+    int digits = 0;
+
+    for (const char *p = mac; *p && digits < 6; p++) {
+        int v = hex_value((unsigned char)*p);
+        if (v < 0) {
+            if (*p == ':' || *p == '-' || *p == '.') continue;
+            return -1;
+        }
+        prefix = prefix << 4 | v;
+        digits++;
+    }
+    return digits == 6 ? prefix : -1;
+}
+
+const char *oui_vendor(const char *mac)
+{
+    long prefix = parse_prefix(mac);
+    if (prefix < 0) return "";
+
+    /* U/L bit of the first octet */
+    if (prefix & 0x020000) return OUI_RANDOMIZED;
+
+    uint32_t lo = 0, hi = oui_entries;
+    while (lo < hi) {
+        uint32_t mid = lo + (hi - lo) / 2;
+        if (oui_prefix[mid] < (uint32_t)prefix)
+            lo = mid + 1;
+        else
+            hi = mid;
+    }
+    if (lo == oui_entries || oui_prefix[lo] != (uint32_t)prefix) return "";
+    return oui_names + oui_name_offset[oui_name_index[lo]];
+}
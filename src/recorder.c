@@ -0,0 +1,728 @@
+/*
+ * recorder.c - Flight recorder for Linux Hotspot Enabler
+ *
+ * Each tick costs a handful of syscalls: one pread of /proc/net/dev on
+ * a descriptor kept open, four wireless-extension ioctls on the uplink
+ * STA, kill(pid, 0) per daemon, one getdents on the debugfs stations
+ * directory, and a non-blocking drain of ICMP echo replies (one echo
+ * goes out per second, not per tick). Nothing is formatted until a dump
+ * is written; the ring is a flat array of fixed-size records, so a dump
+ * is a header and two memcpy()s.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdarg.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <signal.h>
+#include <errno.h>
+#include <time.h>
+#include <dirent.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include <sys/ioctl.h>
+#include <sys/stat.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <netinet/ip.h>
+#include <netinet/ip_icmp.h>
+#include <arpa/inet.h>
+#include <linux/wireless.h>
+
+#include "recorder.h"
+#include "fileio.h"
+#include "txq.h"
+
+#define REC_MAX_EVENTS    8
+#define PROBE_SLOTS       16        /* outstanding echoes, by sequence */
+#define PROBE_TIMEOUT_MS  1000
+#define GATEWAY_RECHECK   (10 * REC_HZ)
+#define NETDEV_BUF_LEN    8192
+
+/* ── State ───────────────────────────────────────────────────────────── */
+
+static struct {
+    atomic_bool     running;
+    atomic_bool     dump_requested;
+    atomic_int      clients_hint;
+    pthread_t       thread;
+    RecConfig       cfg;
+    char            ap_iface[16];
+    char            sta_iface[16];
+    char            stations_dir[MAX_CMD_LEN];
+    pid_t           hostapd_pid;
+    pid_t           dnsmasq_pid;
+
+    /* Thread-only */
+    int             netdev_fd;
+    int             ap_netdev_fd;   /* AP in another namespace, else -1 */
+    int             ioctl_fd;
+    int             icmp_fd;
+    bool            wext;           /* uplink answers wireless ioctls */
+    bool            have_stations;  /* debugfs stations dir readable */
+    in_addr_t       gateway;
+    uint16_t        probe_id;
+    uint16_t        probe_seq;
+    uint64_t        probe_sent[PROBE_SLOTS];  /* wall clock us, 0 = free */
+    int             lost_run;
+    uint16_t        prev_flags;
+    char            trigger[64];    /* pending automatic dump */
+    int             post_left;      /* samples still to record */
+    time_t          last_auto_dump;
+
+    pthread_mutex_t lock;
+    RecSample       ring[REC_SAMPLES];
+    int             head;           /* next slot to write */
+    int             count;
+    char            events[REC_MAX_EVENTS][MAX_LINE_LEN];
+    int             ev_head;
+    int             ev_count;
+} g_rec = {
+    .netdev_fd = -1,
+    .ap_netdev_fd = -1,
+    .ioctl_fd  = -1,
+    .icmp_fd   = -1,
+    .lock      = PTHREAD_MUTEX_INITIALIZER,
+};
+
+/* ── Config ──────────────────────────────────────────────────────────── */
+
+void recorder_default(RecConfig *cfg)
+{
+    cfg->enabled  = true;
+    cfg->spike_ms = 250;
+}
+
+/* ── Helpers ─────────────────────────────────────────────────────────── */
+
+static uint64_t ts_us(const struct timespec *ts)
+{
+    return (uint64_t)ts->tv_sec * 1000000 + (uint64_t)ts->tv_nsec / 1000;
+}
+
+/* Wall clock: sample times and probe stamps (kernel rx stamps use it) */
+static uint64_t real_us(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_REALTIME, &ts);
+    return ts_us(&ts);
+}
+
+static uint64_t mono_us(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts_us(&ts);
+}
+
+static void push_event(const char *fmt, ...)
+    __attribute__((format(printf, 1, 2)));
+
+static void push_event(const char *fmt, ...)
+{
+    pthread_mutex_lock(&g_rec.lock);
+    int slot = (g_rec.ev_head + g_rec.ev_count) % REC_MAX_EVENTS;
+    if (g_rec.ev_count == REC_MAX_EVENTS)
+        g_rec.ev_head = (g_rec.ev_head + 1) % REC_MAX_EVENTS;
+    else
+        g_rec.ev_count++;
+
+    va_list args;
+    va_start(args, fmt);
+    vsnprintf(g_rec.events[slot], MAX_LINE_LEN, fmt, args);
+    va_end(args);
+    pthread_mutex_unlock(&g_rec.lock);
+}
+
+static bool alive(pid_t pid)
+{
+    return pid <= 0 || kill(pid, 0) == 0 || errno == EPERM;
+}
+
+static int freq_to_chan(int mhz)
+{
+    if (mhz == 2484) return 14;
+    if (mhz < 5000)  return (mhz - 2407) / 5;
+    return (mhz - 5000) / 5;
+}
+
+/* ── /proc/net/dev ───────────────────────────────────────────────────── */
+
+/*
+ * "  wlan0: rx_bytes rx_packets rx_errs rx_drop ... (8 rx fields)
+ *           tx_bytes tx_packets tx_errs tx_drop ..."
+ */
+static void parse_netdev(const char *buf, const char *iface,
+                         uint64_t *rx_bytes, uint64_t *tx_bytes,
+                         uint32_t *rx_packets, uint32_t *tx_packets,
+                         uint32_t *drops)
+{
+    size_t len = strlen(iface);
+    if (!len) return;
+
+    for (const char *line = buf; line && *line; ) {
+        const char *p = line;
+        while (*p == ' ') p++;
+        if (strncmp(p, iface, len) == 0 && p[len] == ':') {
+            unsigned long long v[16] = {0};
+            sscanf(p + len + 1,
+                   "%llu %llu %llu %llu %llu %llu %llu %llu "
+                   "%llu %llu %llu %llu %llu %llu %llu %llu",
+                   &v[0], &v[1], &v[2], &v[3], &v[4], &v[5], &v[6], &v[7],
+                   &v[8], &v[9], &v[10], &v[11], &v[12], &v[13], &v[14], &v[15]);
+            *rx_bytes = v[0];
+            *tx_bytes = v[8];
+            if (rx_packets) *rx_packets = (uint32_t)v[1];
+            if (tx_packets) *tx_packets = (uint32_t)v[9];
+            *drops = (uint32_t)(v[3] + v[11]);
+            return;
+        }
+        line = strchr(line, '\n');
+        if (line) line++;
+    }
+}
+
+static bool read_netdev(int fd, char *buf, size_t size)
+{
+    if (fd < 0) return false;
+    ssize_t n = pread(fd, buf, size - 1, 0);
+    if (n <= 0) return false;
+    buf[n] = '\0';
+    return true;
+}
+
+static void sample_netdev(RecSample *s)
+{
+    static char buf[NETDEV_BUF_LEN];
+    if (!read_netdev(g_rec.netdev_fd, buf, sizeof(buf))) return;
+
+    parse_netdev(buf, g_rec.sta_iface, &s->sta_rx_bytes, &s->sta_tx_bytes,
+                 NULL, NULL, &s->sta_drops);
+    if (g_rec.ap_netdev_fd >= 0 &&
+        !read_netdev(g_rec.ap_netdev_fd, buf, sizeof(buf))) return;
+    parse_netdev(buf, g_rec.ap_iface, &s->ap_rx_bytes, &s->ap_tx_bytes,
+                 &s->ap_rx_packets, &s->ap_tx_packets, &s->ap_drops);
+}
+
+/* hostapd's /proc/<pid>/net/dev when it runs in another namespace */
+static int open_ap_netdev(pid_t hostapd_pid)
+{
+    char path[64];
+    struct stat self, other;
+
+    if (hostapd_pid <= 0) return -1;
+    snprintf(path, sizeof(path), "/proc/%d/ns/net", (int)hostapd_pid);
+    if (stat("/proc/self/ns/net", &self) != 0 || stat(path, &other) != 0 ||
+        self.st_ino == other.st_ino)
+        return -1;
+
+    snprintf(path, sizeof(path), "/proc/%d/net/dev", (int)hostapd_pid);
+    return open(path, O_RDONLY | O_CLOEXEC);
+}
+
+/* ── Uplink STA (wireless extensions) ────────────────────────────────── */
+
+static bool wext_get(int request, struct iwreq *wrq)
+{
+    memset(wrq, 0, sizeof(*wrq));
+    snprintf(wrq->ifr_name, sizeof(wrq->ifr_name), "%s", g_rec.sta_iface);
+    return ioctl(g_rec.ioctl_fd, request, wrq) == 0;
+}
+
+static bool link_up(void)
+{
+    struct ifreq ifr;
+    memset(&ifr, 0, sizeof(ifr));
+    snprintf(ifr.ifr_name, sizeof(ifr.ifr_name), "%s", g_rec.sta_iface);
+    return ioctl(g_rec.ioctl_fd, SIOCGIFFLAGS, &ifr) == 0 &&
+           (ifr.ifr_flags & IFF_RUNNING);
+}
+
+static void sample_sta(RecSample *s)
+{
+    struct iwreq wrq;
+
+    if (g_rec.ioctl_fd < 0 || !g_rec.sta_iface[0]) return;
+
+    /* Wired uplink: carrier is all there is */
+    if (!g_rec.wext) {
+        if (link_up()) s->flags |= REC_F_LINK;
+        return;
+    }
+
+    /* A zero BSSID means not associated */
+    if (wext_get(SIOCGIWAP, &wrq)) {
+        static const char zero[6];
+        if (memcmp(wrq.u.ap_addr.sa_data, zero, 6) != 0)
+            s->flags |= REC_F_LINK;
+    }
+
+    if (wext_get(SIOCGIWRATE, &wrq) && wrq.u.bitrate.value > 0)
+        s->sta_bitrate_kbps = (uint32_t)(wrq.u.bitrate.value / 1000);
+
+    if (wext_get(SIOCGIWFREQ, &wrq)) {
+        double f = wrq.u.freq.m;
+        for (int e = wrq.u.freq.e; e > 0; e--) f *= 10;
+        /* Small values are already channel numbers */
+        s->sta_channel = (uint16_t)(f < 1000 ? f : freq_to_chan((int)(f / 1e6)));
+    }
+
+    /* cfg80211 reports the level as a signed dBm byte */
+    struct iw_statistics stats;
+    memset(&wrq, 0, sizeof(wrq));
+    snprintf(wrq.ifr_name, sizeof(wrq.ifr_name), "%s", g_rec.sta_iface);
+    wrq.u.data.pointer = &stats;
+    wrq.u.data.length  = sizeof(stats);
+    wrq.u.data.flags   = 1;     /* clear the "updated" bits */
+    if (ioctl(g_rec.ioctl_fd, SIOCGIWSTATS, &wrq) == 0 &&
+        (stats.qual.updated & IW_QUAL_DBM) &&
+        !(stats.qual.updated & IW_QUAL_LEVEL_INVALID))
+        s->sta_signal_dbm = (int8_t)stats.qual.level;
+}
+
+/* ── AP stations ─────────────────────────────────────────────────────── */
+
+static uint16_t count_stations(void)
+{
+    if (g_rec.have_stations) {
+        DIR *d = opendir(g_rec.stations_dir);
+        if (d) {
+            uint16_t n = 0;
+            struct dirent *de;
+            while ((de = readdir(d)) != NULL)
+                if (de->d_name[0] != '.') n++;
+            closedir(d);
+            return n;
+        }
+    }
+    int hint = atomic_load(&g_rec.clients_hint);
+    return (uint16_t)(hint > 0 ? hint : 0);
+}
+
+/* ── Latency probe ───────────────────────────────────────────────────── */
+
+/* Default route's gateway from /proc/net/route (hex, network order) */
+static in_addr_t default_gateway(void)
+{
+    char buf[4096];
+    if (!fio_read_file("/proc/net/route", buf, sizeof(buf))) return 0;
+
+    for (char *line = strchr(buf, '\n'); line && *++line; line = strchr(line, '\n')) {
+        char iface[32];
+        unsigned int dest, gw, flags;
+        if (sscanf(line, "%31s %x %x %x", iface, &dest, &gw, &flags) == 4 &&
+            dest == 0 && gw != 0 && (flags & 0x2))
+            return (in_addr_t)gw;
+    }
+    return 0;
+}
+
+static uint16_t icmp_checksum(const void *data, size_t len)
+{
+    const uint16_t *p = data;
+    uint32_t sum = 0;
+    for (; len > 1; len -= 2) sum += *p++;
+    if (len) sum += *(const uint8_t *)p;
+    while (sum >> 16) sum = (sum & 0xffff) + (sum >> 16);
+    return (uint16_t)~sum;
+}
+
+static void probe_send(void)
+{
+    if (g_rec.icmp_fd < 0 || !g_rec.gateway) return;
+
+    uint16_t seq = g_rec.probe_seq++;
+    struct icmphdr h;
+    memset(&h, 0, sizeof(h));
+    h.type             = ICMP_ECHO;
+    h.un.echo.id       = htons(g_rec.probe_id);
+    h.un.echo.sequence = htons(seq);
+    h.checksum         = icmp_checksum(&h, sizeof(h));
+
+    struct sockaddr_in to = { .sin_family = AF_INET };
+    to.sin_addr.s_addr = g_rec.gateway;
+    uint64_t t = real_us();
+    if (sendto(g_rec.icmp_fd, &h, sizeof(h), 0,
+               (struct sockaddr *)&to, sizeof(to)) == (ssize_t)sizeof(h))
+        g_rec.probe_sent[seq % PROBE_SLOTS] = t;
+}
+
+/*
+ * Drain replies; returns the worst RTT seen (us) or -1, marks timeouts.
+ * Replies wait up to a tick in the socket, so the RTT is taken from the
+ * kernel's receive stamp rather than from when we read them.
+ */
+static int32_t probe_collect(bool *lost)
+{
+    int32_t worst = -1;
+    uint8_t buf[256];
+    char ctrl[CMSG_SPACE(sizeof(struct timespec))];
+
+    if (g_rec.icmp_fd < 0) return -1;
+
+    for (;;) {
+        struct iovec iov = { .iov_base = buf, .iov_len = sizeof(buf) };
+        struct msghdr msg = {
+            .msg_iov = &iov, .msg_iovlen = 1,
+            .msg_control = ctrl, .msg_controllen = sizeof(ctrl),
+        };
+        ssize_t n = recvmsg(g_rec.icmp_fd, &msg, MSG_DONTWAIT);
+        if (n < 0) break;
+
+        uint64_t rx = 0;
+        for (struct cmsghdr *c = CMSG_FIRSTHDR(&msg); c; c = CMSG_NXTHDR(&msg, c)) {
+            if (c->cmsg_level == SOL_SOCKET && c->cmsg_type == SCM_TIMESTAMPNS) {
+                struct timespec ts;
+                memcpy(&ts, CMSG_DATA(c), sizeof(ts));
+                rx = ts_us(&ts);
+            }
+        }
+        if (!rx) rx = real_us();
+
+        /* Raw sockets hand over the IP header too */
+        size_t ihl = (size_t)(buf[0] & 0x0f) * 4;
+        if ((size_t)n < ihl + sizeof(struct icmphdr)) continue;
+        const struct icmphdr *h = (const struct icmphdr *)(buf + ihl);
+        if (h->type != ICMP_ECHOREPLY || ntohs(h->un.echo.id) != g_rec.probe_id)
+            continue;
+
+        uint64_t *sent = &g_rec.probe_sent[ntohs(h->un.echo.sequence) % PROBE_SLOTS];
+        if (!*sent) continue;
+        int32_t rtt = rx > *sent ? (int32_t)(rx - *sent) : 0;
+        *sent = 0;
+        if (rtt > worst) worst = rtt;
+    }
+
+    uint64_t t = real_us();
+    for (int i = 0; i < PROBE_SLOTS; i++) {
+        if (g_rec.probe_sent[i] &&
+            t - g_rec.probe_sent[i] > (uint64_t)PROBE_TIMEOUT_MS * 1000) {
+            g_rec.probe_sent[i] = 0;
+            *lost = true;
+        }
+    }
+    return worst;
+}
+
+/* ── Dumps ───────────────────────────────────────────────────────────── */
+
+static void write_dump(const char *reason)
+{
+    static RecSample copy[REC_SAMPLES];
+    static char file[sizeof(RecHeader) + sizeof(copy)];
+
+    pthread_mutex_lock(&g_rec.lock);
+    int count = g_rec.count;
+    int first = (g_rec.head - count + REC_SAMPLES) % REC_SAMPLES;
+    int tail  = count < REC_SAMPLES - first ? count : REC_SAMPLES - first;
+    memcpy(copy, &g_rec.ring[first], (size_t)tail * sizeof(RecSample));
+    memcpy(copy + tail, g_rec.ring, (size_t)(count - tail) * sizeof(RecSample));
+    pthread_mutex_unlock(&g_rec.lock);
+
+    if (count == 0) return;
+
+    RecHeader hdr;
+    memset(&hdr, 0, sizeof(hdr));
+    memcpy(hdr.magic, REC_MAGIC, sizeof(hdr.magic));
+    hdr.version     = REC_VERSION;
+    hdr.sample_size = sizeof(RecSample);
+    hdr.count       = (uint32_t)count;
+    hdr.hz          = REC_HZ;
+    snprintf(hdr.reason, sizeof(hdr.reason), "%s", reason);
+    snprintf(hdr.ap_iface, sizeof(hdr.ap_iface), "%s", g_rec.ap_iface);
+    snprintf(hdr.sta_iface, sizeof(hdr.sta_iface), "%s", g_rec.sta_iface);
+
+    size_t len = sizeof(hdr) + (size_t)count * sizeof(RecSample);
+    memcpy(file, &hdr, sizeof(hdr));
+    memcpy(file + sizeof(hdr), copy, (size_t)count * sizeof(RecSample));
+
+    /* Milliseconds in the name: two dumps in one second stay apart */
+    char path[MAX_CMD_LEN], stamp[32];
+    struct timespec ts;
+    clock_gettime(CLOCK_REALTIME, &ts);
+    strftime(stamp, sizeof(stamp), "%Y%m%d-%H%M%S", localtime(&ts.tv_sec));
+    snprintf(path, sizeof(path), REC_DUMP_DIR "/flight-%s-%03ld.bin",
+             stamp, ts.tv_nsec / 1000000);
+
+    if (!fio_private_dir(REC_DUMP_DIR) || !fio_write_file(path, file, len, 0600))
+        push_event("Flight recorder: cannot write %s", path);
+    else
+        push_event("Flight recorder (%s): %d s saved to %s",
+                   reason, count / REC_HZ, path);
+}
+
+/* Compare this tick with the last; arm a dump on the first anomaly */
+static void check_triggers(RecSample *s)
+{
+    const char *why = NULL;
+    char spike[64];
+    uint16_t fell = g_rec.prev_flags & ~s->flags;
+
+    if (fell & REC_F_HOSTAPD)      why = "hostapd exited";
+    else if (fell & REC_F_DNSMASQ) why = "dnsmasq exited";
+    else if (fell & REC_F_LINK)    why = "uplink lost";
+    else if (g_rec.lost_run == REC_LOST_TRIGGER) why = "probes lost";
+    else if (s->rtt_us > g_rec.cfg.spike_ms * 1000) {
+        snprintf(spike, sizeof(spike), "latency spike %d ms", s->rtt_us / 1000);
+        why = spike;
+    }
+    g_rec.prev_flags = s->flags;
+
+    if (!why || g_rec.trigger[0]) return;
+    if (time(NULL) - g_rec.last_auto_dump < REC_COOLDOWN_SECS) return;
+
+    s->flags |= REC_F_TRIGGER;
+    snprintf(g_rec.trigger, sizeof(g_rec.trigger), "%s", why);
+    g_rec.post_left = REC_POST_SAMPLES;
+}
+
+/* ── Thread ──────────────────────────────────────────────────────────── */
+
+static void take_sample(int tick)
+{
+    RecSample s;
+    memset(&s, 0, sizeof(s));
+    s.t_ms = real_us() / 1000;
+
+    if (tick % GATEWAY_RECHECK == 0) g_rec.gateway = default_gateway();
+
+    bool lost = false;
+    s.rtt_us = probe_collect(&lost);
+    if (lost) {
+        s.flags |= REC_F_PROBE_LOST;
+        g_rec.lost_run++;
+    } else if (s.rtt_us >= 0) {
+        g_rec.lost_run = 0;
+    }
+    if (tick % REC_PROBE_EVERY == 0) probe_send();
+
+    sample_netdev(&s);
+    sample_sta(&s);
+    s.ap_stations = count_stations();
+    if (alive(g_rec.hostapd_pid)) s.flags |= REC_F_HOSTAPD;
+    if (alive(g_rec.dnsmasq_pid)) s.flags |= REC_F_DNSMASQ;
+
+    /* The first tick only sets the baseline */
+    if (tick == 0) g_rec.prev_flags = s.flags;
+    check_triggers(&s);
+
+    pthread_mutex_lock(&g_rec.lock);
+    g_rec.ring[g_rec.head] = s;
+    g_rec.head = (g_rec.head + 1) % REC_SAMPLES;
+    if (g_rec.count < REC_SAMPLES) g_rec.count++;
+    pthread_mutex_unlock(&g_rec.lock);
+}
+
+static void flush_trigger(void)
+{
+    write_dump(g_rec.trigger);
+    g_rec.trigger[0] = '\0';
+    g_rec.last_auto_dump = time(NULL);
+}
+
+static void *recorder_thread(void *arg)
+{
+    (void)arg;
+    const uint64_t period = 1000000 / REC_HZ;
+    uint64_t next = mono_us();
+
+    for (int tick = 0; atomic_load(&g_rec.running); tick++) {
+        take_sample(tick);
+
+        if (g_rec.trigger[0] && --g_rec.post_left <= 0)
+            flush_trigger();
+        if (atomic_exchange(&g_rec.dump_requested, false))
+            write_dump("requested");
+
+        /* Fixed rate: sleep to the next slot, skip any that were missed */
+        next += period;
+        uint64_t now = mono_us();
+        if (next <= now)
+            next = now + period - (now - next) % period;
+        usleep((useconds_t)(next - now));
+    }
+
+    /* Stopping right after an anomaly: keep what led up to it */
+    if (g_rec.trigger[0]) flush_trigger();
+    return NULL;
+}
+
+/* ── Public API ──────────────────────────────────────────────────────── */
+
+bool recorder_start(const RecConfig *cfg, const char *ap_iface,
+                    const char *sta_iface, const char *phy,
+                    pid_t hostapd_pid, pid_t dnsmasq_pid,
+                    char *err, size_t errsize)
+{
+    if (atomic_load(&g_rec.running)) return true;
+
+    g_rec.cfg         = *cfg;
+    g_rec.hostapd_pid = hostapd_pid;
+    g_rec.dnsmasq_pid = dnsmasq_pid;
+    snprintf(g_rec.ap_iface, sizeof(g_rec.ap_iface), "%s", ap_iface);
+    snprintf(g_rec.sta_iface, sizeof(g_rec.sta_iface), "%s", sta_iface);
+    snprintf(g_rec.stations_dir, sizeof(g_rec.stations_dir),
+             TXQ_DEBUGFS_ROOT "/%s/netdev:%s/stations", phy, ap_iface);
+    g_rec.have_stations = access(g_rec.stations_dir, R_OK) == 0;
+    atomic_store(&g_rec.dump_requested, false);
+
+    g_rec.netdev_fd = open("/proc/net/dev", O_RDONLY | O_CLOEXEC);
+    g_rec.ap_netdev_fd = open_ap_netdev(hostapd_pid);
+    g_rec.ioctl_fd  = socket(AF_INET, SOCK_DGRAM | SOCK_CLOEXEC, 0);
+    if (g_rec.netdev_fd < 0 || g_rec.ioctl_fd < 0) {
+        snprintf(err, errsize, "cannot open /proc/net/dev or a socket: %s",
+                 strerror(errno));
+        recorder_stop();
+        return false;
+    }
+    struct iwreq wrq;
+    g_rec.wext = sta_iface[0] && wext_get(SIOCGIWNAME, &wrq);
+
+    g_rec.icmp_fd = socket(AF_INET, SOCK_RAW | SOCK_CLOEXEC, IPPROTO_ICMP);
+    int icmp_errno = errno;
+    if (g_rec.icmp_fd >= 0) {
+        int on = 1;
+        setsockopt(g_rec.icmp_fd, SOL_SOCKET, SO_TIMESTAMPNS, &on, sizeof(on));
+    }
+    g_rec.probe_id  = (uint16_t)(getpid() ^ 0x4846);
+    g_rec.probe_seq = 0;
+    g_rec.lost_run  = 0;
+    g_rec.trigger[0] = '\0';
+    g_rec.last_auto_dump = 0;
+    memset(g_rec.probe_sent, 0, sizeof(g_rec.probe_sent));
+
+    pthread_mutex_lock(&g_rec.lock);
+    g_rec.head = g_rec.count = 0;
+    g_rec.ev_head = g_rec.ev_count = 0;
+    pthread_mutex_unlock(&g_rec.lock);
+
+    /* Not fatal: everything but the RTT column is still recorded */
+    if (g_rec.icmp_fd < 0)
+        push_event("Flight recorder: no raw ICMP socket (%s); recording "
+                   "without latency probes", strerror(icmp_errno));
+
+    /* Keep SIGINT/SIGWINCH on the main thread */
+    sigset_t all, old;
+    sigfillset(&all);
+    pthread_sigmask(SIG_SETMASK, &all, &old);
+    atomic_store(&g_rec.running, true);
+    bool ok = (pthread_create(&g_rec.thread, NULL, recorder_thread, NULL) == 0);
+    pthread_sigmask(SIG_SETMASK, &old, NULL);
+
+    if (!ok) {
+        atomic_store(&g_rec.running, false);
+        snprintf(err, errsize, "cannot start recorder thread");
+        recorder_stop();
+        return false;
+    }
+    return true;
+}
+
+void recorder_stop(void)
+{
+    if (atomic_load(&g_rec.running)) {
+        atomic_store(&g_rec.running, false);
+        pthread_join(g_rec.thread, NULL);
+    }
+
+    if (g_rec.netdev_fd >= 0) close(g_rec.netdev_fd);
+    if (g_rec.ap_netdev_fd >= 0) close(g_rec.ap_netdev_fd);
+    if (g_rec.ioctl_fd >= 0)  close(g_rec.ioctl_fd);
+    if (g_rec.icmp_fd >= 0)   close(g_rec.icmp_fd);
+    g_rec.netdev_fd = g_rec.ap_netdev_fd = g_rec.ioctl_fd = g_rec.icmp_fd = -1;
+}
+
+void recorder_note_clients(int count)
+{
+    atomic_store(&g_rec.clients_hint, count);
+}
+
+void recorder_request_dump(void)
+{
+    atomic_store(&g_rec.dump_requested, true);
+}
+
+bool recorder_next_event(char *msg, size_t msgsize)
+{
+    bool found = false;
+
+    pthread_mutex_lock(&g_rec.lock);
+    if (g_rec.ev_count > 0) {
+        snprintf(msg, msgsize, "%s", g_rec.events[g_rec.ev_head]);
+        g_rec.ev_head = (g_rec.ev_head + 1) % REC_MAX_EVENTS;
+        g_rec.ev_count--;
+        found = true;
+    }
+    pthread_mutex_unlock(&g_rec.lock);
+    return found;
+}
+
+/* ── Decoder ─────────────────────────────────────────────────────────── */
+
+int recorder_decode(const char *path)
+{
+    FILE *fp = fopen(path, "rb");
+    if (!fp) {
+        fprintf(stderr, "%s: %s\n", path, strerror(errno));
+        return 1;
+    }
+
+    RecHeader hdr;
+    if (fread(&hdr, sizeof(hdr), 1, fp) != 1 ||
+        memcmp(hdr.magic, REC_MAGIC, sizeof(hdr.magic)) != 0) {
+        fprintf(stderr, "%s: not a flight recorder dump\n", path);
+        fclose(fp);
+        return 1;
+    }
+    if (hdr.version != REC_VERSION || hdr.sample_size != sizeof(RecSample)) {
+        fprintf(stderr, "%s: dump version %u (record %u bytes); this build "
+                "reads version %d (%zu bytes)\n", path, hdr.version,
+                hdr.sample_size, REC_VERSION, sizeof(RecSample));
+        fclose(fp);
+        return 1;
+    }
+    hdr.reason[sizeof(hdr.reason) - 1]       = '\0';
+    hdr.ap_iface[sizeof(hdr.ap_iface) - 1]   = '\0';
+    hdr.sta_iface[sizeof(hdr.sta_iface) - 1] = '\0';
+
+    printf("# reason=%s ap=%s sta=%s hz=%u samples=%u\n",
+           hdr.reason, hdr.ap_iface, hdr.sta_iface, hdr.hz, hdr.count);
+    printf("time,t_ms,sta_signal_dbm,sta_channel,sta_bitrate_kbps,link,"
+           "ap_stations,hostapd,dnsmasq,rtt_ms,probe_lost,"
+           "ap_rx_bytes,ap_tx_bytes,ap_rx_packets,ap_tx_packets,ap_drops,"
+           "sta_rx_bytes,sta_tx_bytes,sta_drops,trigger\n");
+
+    RecSample s;
+    uint32_t n = 0;
+    while (n < hdr.count && fread(&s, sizeof(s), 1, fp) == 1) {
+        char stamp[32];
+        time_t secs = (time_t)(s.t_ms / 1000);
+        strftime(stamp, sizeof(stamp), "%H:%M:%S", localtime(&secs));
+
+        char rtt[16] = "";
+        if (s.rtt_us >= 0) snprintf(rtt, sizeof(rtt), "%.1f", s.rtt_us / 1000.0);
+
+        printf("%s.%03u,%llu,%d,%u,%u,%d,%u,%d,%d,%s,%d,"
+               "%llu,%llu,%u,%u,%u,%llu,%llu,%u,%d\n",
+               stamp, (unsigned)(s.t_ms % 1000), (unsigned long long)s.t_ms,
+               s.sta_signal_dbm, s.sta_channel, s.sta_bitrate_kbps,
+               !!(s.flags & REC_F_LINK), s.ap_stations,
+               !!(s.flags & REC_F_HOSTAPD), !!(s.flags & REC_F_DNSMASQ),
+               rtt, !!(s.flags & REC_F_PROBE_LOST),
+               (unsigned long long)s.ap_rx_bytes, (unsigned long long)s.ap_tx_bytes,
+               s.ap_rx_packets, s.ap_tx_packets, s.ap_drops,
+               (unsigned long long)s.sta_rx_bytes, (unsigned long long)s.sta_tx_bytes,
+               s.sta_drops, !!(s.flags & REC_F_TRIGGER));
+        n++;
+    }
+    fclose(fp);
+
+    if (n < hdr.count) {
+        fprintf(stderr, "%s: truncated after %u of %u samples\n",
+                path, n, hdr.count);
+        return 1;
+    }
+    return 0;
+}
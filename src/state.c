@@ -0,0 +1,286 @@
+/*
+ * state.c - Persisted runtime state for Linux Hotspot Enabler
+ *
+ * Format: one "key=value" per line, written by state_save only. Keys
+ * that repeat (moved_addr, route) are lists. Unknown keys are ignored
+ * so an older binary can still read a newer file of the same version.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <signal.h>
+#include <unistd.h>
+
+#include "state.h"
+#include "hapd.h"
+#include "fileio.h"
+#include "netns.h"
+
+#define BOOT_ID_PATH  "/proc/sys/kernel/random/boot_id"
+
+static uint64_t g_state_hash;   /* of HOTSPOT_STATE_PATH as last written */
+
+/* ── Helpers ─────────────────────────────────────────────────────────── */
+
+static void read_boot_id(char *buf, size_t size)
+{
+    if (!fio_read_file(BOOT_ID_PATH, buf, size)) buf[0] = '\0';
+    buf[strcspn(buf, "\n")] = '\0';
+}
+
+/* Does /proc/<pid>/cmdline mention both name and arg? */
+static bool proc_matches(pid_t pid, const char *name, const char *arg)
+{
+    if (pid <= 0 || kill(pid, 0) != 0) return false;
+
+    char path[MAX_PATH_LEN], cmdline[MAX_CMD_LEN];
+    snprintf(path, sizeof(path), "/proc/%d/cmdline", (int)pid);
+
+    FioBatch b;
+    fio_batch_init(&b);
+    FioOp *op = fio_add_read(&b, path, cmdline, sizeof(cmdline));
+    if (!fio_submit(&b) || op->result <= 0) return false;
+    for (long i = 0; i < op->result; i++)
+        if (cmdline[i] == '\0') cmdline[i] = ' ';
+
+    return strstr(cmdline, name) && (!arg || strstr(cmdline, arg));
+}
+
+/* ── Save ────────────────────────────────────────────────────────────── */
+
+bool state_save(const HotspotStatus *status, bool owned)
+{
+    char *text = NULL;
+    size_t len = 0;
+    FILE *fp = open_memstream(&text, &len);
+    if (!fp) return false;
+
+    char boot_id[64];
+    read_boot_id(boot_id, sizeof(boot_id));
+
+    const UplinkConfig *up = &status->config.uplink;
+    const UplinkSaved  *us = &status->uplink_saved;
+
+    fprintf(fp,
+        "version=%d\n"
+        "boot_id=%s\n"
+        "owner=%d\n"
+        "ssid=%s\n"
+        "ap_iface=%s\n"
+        "wifi=%s\n"
+        "phy=%s\n"
+        "ap_channel=%d\n"
+        "dfs=%d\n"
+        "cac_end=%ld\n"
+        "start_time=%ld\n"
+        "hostapd_pid=%d\n"
+        "dnsmasq_pid=%d\n"
+        "ip_forward_was_enabled=%d\n"
+        "steer=%d\n"
+        "fw_backend=%s\n"
+        "uplink_mode=%s\n"
+        "bridge=%s\n"
+        "bridge_port=%s\n"
+        "created_bridge=%d\n"
+        "moved_gateway=%s\n"
+        "bridge_nf_call=%d\n"
+        "sta_proxy_arp=%d\n"
+        "ap_addr=%s\n"
+        "sta_network_id=%d\n"
+        "sta_bgscan=%s\n"
+        "sta_power_save=%d\n"
+        "netns=%d\n",
+        STATE_VERSION, boot_id, owned ? (int)getpid() : 0,
+        status->config.ssid, status->ap_iface, status->wifi.name, status->phy,
+        status->ap_channel, status->dfs ? 1 : 0, (long)status->cac_end,
+        (long)status->start_time, (int)status->hostapd_pid,
+        (int)status->dnsmasq_pid, status->ip_forward_was_enabled ? 1 : 0,
+        status->config.steer.enabled ? 1 : 0, fw_backend_name(status->fw_backend),
+        uplink_mode_name(up->mode), up->bridge, up->bridge_port,
+        us->created_bridge ? 1 : 0, us->moved_gateway, us->bridge_nf_call,
+        us->sta_proxy_arp, us->ap_addr, status->sta_saved.network_id,
+        status->sta_saved.bgscan, status->sta_saved.power_save,
+        status->netns ? 1 : 0);
+    const ConnLimitSaved *cl = &status->connlimit_saved;
+    fprintf(fp, "connlimit=%d,%ld,%ld,%ld,%ld,%ld\n", cl->table ? 1 : 0,
+            cl->ct_max, cl->ct_buckets, cl->tcp_established, cl->udp,
+            cl->udp_stream);
+    if (status->aql_saved.saved) {
+        const TxqAqlSaved *aq = &status->aql_saved;
+        fprintf(fp, "aql_saved=%d,%d,%d,%d,%d,%d,%d,%d\n",
+                aq->low[0], aq->high[0], aq->low[1], aq->high[1],
+                aq->low[2], aq->high[2], aq->low[3], aq->high[3]);
+    }
+    for (int i = 0; i < us->moved_count; i++)
+        fprintf(fp, "moved_addr=%s\n", us->moved_addrs[i]);
+    for (int i = 0; i < us->route_count; i++)
+        fprintf(fp, "route=%s\n", us->routes[i]);
+
+    fclose(fp);
+    bool ok = text && fio_private_dir(HOTSPOT_RUN_DIR) &&
+              fio_update_file(HOTSPOT_STATE_PATH, text, len, 0600,
+                              &g_state_hash) >= 0;
+    free(text);
+    return ok;
+}
+
+void state_remove(void)
+{
+    FioBatch b;
+    fio_batch_init(&b);
+    fio_add_unlink(&b, HOTSPOT_STATE_PATH);
+    fio_submit(&b);
+    g_state_hash = 0;
+}
+
+/* ── Load ────────────────────────────────────────────────────────────── */
+
+static void apply_key(HotspotStatus *st, const char *key, const char *value,
+                      int *version, char *boot_id, size_t boot_size,
+                      pid_t *owner)
+{
+    UplinkConfig *up = &st->config.uplink;
+    UplinkSaved  *us = &st->uplink_saved;
+
+#define STR(field) snprintf(field, sizeof(field), "%s", value)
+    if      (strcmp(key, "version") == 0)     *version = atoi(value);
+    else if (strcmp(key, "boot_id") == 0)     snprintf(boot_id, boot_size, "%s", value);
+    else if (strcmp(key, "owner") == 0)       *owner = (pid_t)atoi(value);
+    else if (strcmp(key, "ssid") == 0)        STR(st->config.ssid);
+    else if (strcmp(key, "ap_iface") == 0)    STR(st->ap_iface);
+    else if (strcmp(key, "wifi") == 0)        STR(st->wifi.name);
+    else if (strcmp(key, "phy") == 0)         STR(st->phy);
+    else if (strcmp(key, "ap_channel") == 0)  st->ap_channel = atoi(value);
+    else if (strcmp(key, "dfs") == 0)         st->dfs = atoi(value) != 0;
+    else if (strcmp(key, "cac_end") == 0)     st->cac_end = (time_t)atol(value);
+    else if (strcmp(key, "start_time") == 0)  st->start_time = (time_t)atol(value);
+    else if (strcmp(key, "hostapd_pid") == 0) st->hostapd_pid = (pid_t)atoi(value);
+    else if (strcmp(key, "dnsmasq_pid") == 0) st->dnsmasq_pid = (pid_t)atoi(value);
+    else if (strcmp(key, "ip_forward_was_enabled") == 0)
+        st->ip_forward_was_enabled = atoi(value) != 0;
+    else if (strcmp(key, "steer") == 0)
+        st->config.steer.enabled = st->config.steer.enabled && atoi(value) != 0;
+    else if (strcmp(key, "fw_backend") == 0)  fw_parse_backend(value, &st->fw_backend);
+    else if (strcmp(key, "uplink_mode") == 0) uplink_parse_mode(value, &up->mode);
+    else if (strcmp(key, "bridge") == 0)      STR(up->bridge);
+    else if (strcmp(key, "bridge_port") == 0) STR(up->bridge_port);
+    else if (strcmp(key, "created_bridge") == 0) us->created_bridge = atoi(value) != 0;
+    else if (strcmp(key, "moved_gateway") == 0)  STR(us->moved_gateway);
+    else if (strcmp(key, "bridge_nf_call") == 0) us->bridge_nf_call = atoi(value);
+    else if (strcmp(key, "sta_proxy_arp") == 0)  us->sta_proxy_arp = atoi(value);
+    else if (strcmp(key, "ap_addr") == 0)        STR(us->ap_addr);
+    else if (strcmp(key, "sta_network_id") == 0) st->sta_saved.network_id = atoi(value);
+    else if (strcmp(key, "sta_bgscan") == 0)     STR(st->sta_saved.bgscan);
+    else if (strcmp(key, "sta_power_save") == 0) st->sta_saved.power_save = atoi(value);
+    else if (strcmp(key, "netns") == 0)          st->netns = atoi(value) != 0;
+    else if (strcmp(key, "connlimit") == 0) {
+        ConnLimitSaved *cl = &st->connlimit_saved;
+        int table = 0;
+        if (sscanf(value, "%d,%ld,%ld,%ld,%ld,%ld", &table, &cl->ct_max,
+                   &cl->ct_buckets, &cl->tcp_established, &cl->udp,
+                   &cl->udp_stream) == 6)
+            cl->table = table != 0;
+    }
+    else if (strcmp(key, "aql_saved") == 0) {
+        TxqAqlSaved *aq = &st->aql_saved;
+        aq->saved = sscanf(value, "%d,%d,%d,%d,%d,%d,%d,%d",
+                           &aq->low[0], &aq->high[0], &aq->low[1], &aq->high[1],
+                           &aq->low[2], &aq->high[2], &aq->low[3], &aq->high[3]) == 8;
+    }
+    else if (strcmp(key, "moved_addr") == 0 && us->moved_count < UPLINK_MAX_ADDRS)
+        STR(us->moved_addrs[us->moved_count++]);
+    else if (strcmp(key, "route") == 0 && us->route_count < MAX_CLIENTS)
+        STR(us->routes[us->route_count++]);
+#undef STR
+}
+
+/* Is the forwarding setup of this uplink mode still in place? */
+static bool verify_uplink(const HotspotStatus *st)
+{
+    char cmd[MAX_CMD_LEN], out[1024] = {0};
+
+    switch (st->config.uplink.mode) {
+    case UPLINK_NAT:
+        return fw_nat_present(st->fw_backend, st->wifi.name);
+
+    case UPLINK_PROXYARP: {
+        char want[MAX_IP_LEN + 8];
+        snprintf(want, sizeof(want), "inet %s/32", st->uplink_saved.ap_addr);
+        snprintf(cmd, sizeof(cmd), "ip -4 addr show dev %s 2>/dev/null", st->ap_iface);
+        net_exec_cmd(cmd, out, sizeof(out));
+        return st->uplink_saved.ap_addr[0] && strstr(out, want);
+    }
+
+    case UPLINK_BRIDGE: {
+        char path[MAX_PATH_LEN], link[MAX_PATH_LEN];
+        snprintf(path, sizeof(path), "/sys/class/net/%s/master", st->ap_iface);
+        ssize_t n = readlink(path, link, sizeof(link) - 1);
+        if (n <= 0) return false;
+        link[n] = '\0';
+        const char *base = strrchr(link, '/');
+        return strcmp(base ? base + 1 : link, st->config.uplink.bridge) == 0;
+    }
+    }
+    return false;
+}
+
+bool state_load(HotspotStatus *status, char *err, size_t errsize)
+{
+    char text[8192];
+    err[0] = '\0';
+    if (!fio_read_file(HOTSPOT_STATE_PATH, text, sizeof(text))) return false;
+
+    static HotspotStatus st;
+    st = *status;
+    st.uplink_saved.moved_count = 0;
+    st.uplink_saved.route_count = 0;
+    st.aql_saved.saved = false;
+    st.netns = false;
+    connlimit_init(&st.connlimit_saved);
+
+    int   version = 0;
+    char  boot_id[64] = {0}, now_boot[64];
+    pid_t owner = 0;
+
+    char *save = NULL;
+    for (char *line = strtok_r(text, "\n", &save); line;
+         line = strtok_r(NULL, "\n", &save)) {
+        char *eq = strchr(line, '=');
+        if (!eq) continue;
+        *eq = '\0';
+        apply_key(&st, line, eq + 1, &version, boot_id, sizeof(boot_id), &owner);
+    }
+
+    read_boot_id(now_boot, sizeof(now_boot));
+    char path[MAX_PATH_LEN];
+    snprintf(path, sizeof(path), "/sys/class/net/%s", st.ap_iface);
+
+    if (version != STATE_VERSION)
+        snprintf(err, errsize, "state file version %d, expected %d",
+                 version, STATE_VERSION);
+    else if (strcmp(boot_id, now_boot) != 0)
+        snprintf(err, errsize, "state is from a previous boot");
+    else if (owner > 0 && owner != getpid() &&
+             proc_matches(owner, "hotspot-enabler", NULL))
+        snprintf(err, errsize, "hotspot is managed by running process %d",
+                 (int)owner);
+    else if (!proc_matches(st.hostapd_pid, "hostapd", HOSTAPD_CONF_PATH) &&
+             !proc_matches(st.hostapd_pid, "hostapd", HAPD_GLOBAL_PATH))
+        snprintf(err, errsize, "hostapd (pid %d) is gone", (int)st.hostapd_pid);
+    else if (st.config.uplink.mode != UPLINK_BRIDGE &&
+             !proc_matches(st.dnsmasq_pid, "dnsmasq", DNSMASQ_CONF_PATH))
+        snprintf(err, errsize, "dnsmasq (pid %d) is gone", (int)st.dnsmasq_pid);
+    else if (st.netns && !netns_present())
+        snprintf(err, errsize, "namespace " NETNS_NAME " or " NETNS_VETH_HOST " is gone");
+    else if (st.netns ? !netns_has_iface(st.ap_iface) : access(path, F_OK) != 0)
+        snprintf(err, errsize, "interface %s is gone", st.ap_iface);
+    else if (!verify_uplink(&st))
+        snprintf(err, errsize, "%s forwarding setup is incomplete",
+                 uplink_mode_name(st.config.uplink.mode));
+
+    if (err[0]) return false;
+
+    *status = st;
+    return true;
+}
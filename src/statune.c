@@ -0,0 +1,156 @@
+/*
+ * statune.c - Uplink STA radio tuning for Linux Hotspot Enabler
+ *
+ * bgscan is a per-network wpa_supplicant setting; an empty value
+ * disables it, and wpa_supplicant re-initialises bgscan at once when
+ * the current network's value changes. A network without a bgscan of
+ * its own follows the global one, so that is what gets written back.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "statune.h"
+#include "net_utils.h"
+
+/* ── Helpers ─────────────────────────────────────────────────────────── */
+
+static void trim_nl(char *s)
+{
+    s[strcspn(s, "\r\n")] = '\0';
+}
+
+/* Network id of the connected supplicant network, or -1 */
+static int current_network(const char *iface)
+{
+    char cmd[MAX_CMD_LEN], out[2048];
+    snprintf(cmd, sizeof(cmd), "wpa_cli -i %s status 2>/dev/null", iface);
+    if (!net_exec_cmd(cmd, out, sizeof(out))) return -1;
+
+    char *save = NULL;
+    for (char *line = strtok_r(out, "\n", &save); line;
+         line = strtok_r(NULL, "\n", &save)) {
+        if (strncmp(line, "id=", 3) == 0) return atoi(line + 3);
+    }
+    return -1;
+}
+
+/* wpa_cli answer, "" on FAIL or no control socket */
+static bool wpa_query(const char *iface, const char *request,
+                      char *out, size_t size)
+{
+    char cmd[MAX_CMD_LEN];
+    snprintf(cmd, sizeof(cmd), "wpa_cli -i %s %s 2>/dev/null", iface, request);
+    bool ok = net_exec_cmd(cmd, out, size);
+    trim_nl(out);
+    if (!ok || strncmp(out, "FAIL", 4) == 0) {
+        out[0] = '\0';
+        return false;
+    }
+    return true;
+}
+
+static bool set_bgscan(const char *iface, int id, const char *quoted)
+{
+    char req[MAX_CMD_LEN], out[64];
+    snprintf(req, sizeof(req), "set_network %d bgscan '%s'", id, quoted);
+    return wpa_query(iface, req, out, sizeof(out)) && strcmp(out, "OK") == 0;
+}
+
+/* 1 on, 0 off, -1 unknown */
+static int get_power_save(const char *iface)
+{
+    char cmd[MAX_CMD_LEN], out[128];
+    snprintf(cmd, sizeof(cmd), "iw dev %s get power_save 2>/dev/null", iface);
+    if (!net_exec_cmd(cmd, out, sizeof(out))) return -1;
+    if (strstr(out, "Power save: on"))  return 1;
+    if (strstr(out, "Power save: off")) return 0;
+    return -1;
+}
+
+static bool set_power_save(const char *iface, bool on)
+{
+    char cmd[MAX_CMD_LEN];
+    snprintf(cmd, sizeof(cmd), "iw dev %s set power_save %s 2>/dev/null",
+             iface, on ? "on" : "off");
+    return net_exec_silent(cmd) == 0;
+}
+
+/* ── Apply / Restore ─────────────────────────────────────────────────── */
+
+void statune_init(StaTuneSaved *saved)
+{
+    memset(saved, 0, sizeof(StaTuneSaved));
+    saved->network_id = -1;
+    saved->power_save = -1;
+}
+
+bool statune_apply(const char *iface, bool shared_radio, StaTuneSaved *saved,
+                   char *err, size_t errsize)
+{
+    statune_init(saved);
+    err[0] = '\0';
+
+    /* Power save: only the radio driver knows, ask nl80211 */
+    int ps = get_power_save(iface);
+    if (ps == 1) {
+        if (set_power_save(iface, false)) saved->power_save = 1;
+        else snprintf(err, errsize, "could not disable power save on %s", iface);
+    } else if (ps < 0) {
+        snprintf(err, errsize, "power save state of %s unknown", iface);
+    }
+
+    /* A dedicated AP radio does not go off-channel when the STA scans */
+    if (!shared_radio) return !err[0];
+
+    int id = current_network(iface);
+    if (id < 0) {
+        if (!err[0])
+            snprintf(err, errsize, "no wpa_supplicant control socket for %s; "
+                     "background scans stay on", iface);
+        return false;
+    }
+
+    char req[64], old[STATUNE_BGSCAN_LEN];
+    snprintf(req, sizeof(req), "get_network %d bgscan", id);
+    if (!wpa_query(iface, req, old, sizeof(old))) {
+        /* No bgscan of its own: the global value applies */
+        char global[STATUNE_BGSCAN_LEN - 2];
+        wpa_query(iface, "get bgscan", global, sizeof(global));
+        snprintf(old, sizeof(old), "\"%s\"", global);
+    }
+
+    if (strcmp(old, "\"\"") == 0) return !err[0];   /* already off */
+    if (strchr(old, '\'') || !set_bgscan(iface, id, "\"\"")) {
+        if (!err[0])
+            snprintf(err, errsize, "could not disable bgscan on network %d", id);
+        return false;
+    }
+    saved->network_id = id;
+    snprintf(saved->bgscan, sizeof(saved->bgscan), "%s", old);
+    return !err[0];
+}
+
+void statune_restore(const char *iface, StaTuneSaved *saved)
+{
+    /* Only put bgscan back if the STA is still on the same network */
+    if (saved->network_id >= 0 && current_network(iface) == saved->network_id)
+        set_bgscan(iface, saved->network_id, saved->bgscan);
+
+    if (saved->power_save == 1)
+        set_power_save(iface, true);
+
+    statune_init(saved);
+}
+
+void statune_describe(const StaTuneSaved *saved, char *buf, size_t size)
+{
+    buf[0] = '\0';
+    if (saved->network_id >= 0 && saved->power_save == 1)
+        snprintf(buf, size, "bgscan off, power save off");
+    else if (saved->network_id >= 0)
+        snprintf(buf, size, "bgscan off");
+    else if (saved->power_save == 1)
+        snprintf(buf, size, "power save off");
+}
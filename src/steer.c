@@ -0,0 +1,451 @@
+/*
+ * steer.c - 2.4 → 5 GHz band steering for Linux Hotspot Enabler
+ *
+ * A polling thread reads "hostapd_cli all_sta" every STEER_POLL_SECS.
+ * A client is a candidate when its extended capabilities advertise BSS
+ * Transition (bit 19) and its Supported Operating Classes include a
+ * 5 GHz class. Hysteresis: it must be seen at or above min_signal +
+ * hysteresis for STEER_SAMPLES polls in a row, and the count only
+ * resets when it drops below min_signal. A request counts as a success
+ * if the client disassociates within STEER_VERDICT_SECS; otherwise it
+ * is retried after the cooldown, up to max_attempts.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdarg.h>
+#include <ctype.h>
+#include <unistd.h>
+#include <signal.h>
+#include <pthread.h>
+#include <stdatomic.h>
+
+#include "steer.h"
+#include "hotspot.h"
+
+/* ── State ───────────────────────────────────────────────────────────── */
+
+static struct {
+    atomic_bool     running;
+    pthread_t       thread;
+    SteerConfig     cfg;
+    char            ap_iface[MAX_IFACE_NAME];
+    int             peer_class;
+
+    pthread_mutex_t lock;
+    SteerClient     clients[MAX_CLIENTS];
+    SteerStats      stats;
+    char            events[STEER_MAX_EVENTS][MAX_LINE_LEN];
+    int             ev_head;
+    int             ev_count;
+} g_steer = {
+    .lock = PTHREAD_MUTEX_INITIALIZER,
+};
+
+/* ── Config ──────────────────────────────────────────────────────────── */
+
+void steer_default(SteerConfig *cfg)
+{
+    memset(cfg, 0, sizeof(SteerConfig));
+    cfg->enabled      = false;
+    cfg->min_signal   = -65;
+    cfg->hysteresis   = 5;
+    cfg->cooldown_s   = 120;
+    cfg->max_attempts = 3;
+}
+
+int steer_op_class(int channel)
+{
+    if (channel >= 36  && channel <= 48)  return 115;
+    if (channel >= 52  && channel <= 64)  return 118;
+    if (channel >= 100 && channel <= 144) return 121;
+    if (channel >= 149 && channel <= 177) return 125;
+    return 0;
+}
+
+/* ── Helpers (call with lock held) ───────────────────────────────────── */
+
+static void push_event(const char *fmt, ...)
+    __attribute__((format(printf, 1, 2)));
+
+static void push_event(const char *fmt, ...)
+{
+    int slot = (g_steer.ev_head + g_steer.ev_count) % STEER_MAX_EVENTS;
+    if (g_steer.ev_count == STEER_MAX_EVENTS)
+        g_steer.ev_head = (g_steer.ev_head + 1) % STEER_MAX_EVENTS;
+    else
+        g_steer.ev_count++;
+
+    va_list args;
+    va_start(args, fmt);
+    vsnprintf(g_steer.events[slot], MAX_LINE_LEN, fmt, args);
+    va_end(args);
+}
+
+static SteerClient *find_client(const char *mac, bool add)
+{
+    SteerClient *spare = NULL;
+
+    for (int i = 0; i < MAX_CLIENTS; i++) {
+        SteerClient *c = &g_steer.clients[i];
+        if (strcmp(c->mac, mac) == 0) return c;
+        if (!spare && (c->mac[0] == '\0' ||
+                       (!c->present && c->state != STEER_PENDING)))
+            spare = c;
+    }
+    if (!add || !spare) return NULL;
+
+    memset(spare, 0, sizeof(SteerClient));
+    snprintf(spare->mac, sizeof(spare->mac), "%s", mac);
+    return spare;
+}
+
+static bool is_mac_line(const char *s)
+{
+    if (strlen(s) != 17) return false;
+    for (int i = 0; i < 17; i++) {
+        if (i % 3 == 2 ? s[i] != ':' : !isxdigit((unsigned char)s[i]))
+            return false;
+    }
+    return true;
+}
+
+static int hex_byte(const char *hex, size_t idx)
+{
+    if (strlen(hex) < idx * 2 + 2) return -1;
+    char b[3] = { hex[idx * 2], hex[idx * 2 + 1], '\0' };
+    return (int)strtol(b, NULL, 16);
+}
+
+/* Extended Capabilities bit 19: BSS Transition */
+static bool has_btm(const char *ext_capab)
+{
+    int b = hex_byte(ext_capab, 2);
+    return b >= 0 && (b & 0x08);
+}
+
+/* Any global operating class in 115..130 (5 GHz) */
+static bool has_5ghz_class(const char *op_classes)
+{
+    for (size_t i = 0; ; i++) {
+        int c = hex_byte(op_classes, i);
+        if (c < 0) return false;
+        if (c >= 115 && c <= 130) return true;
+    }
+}
+
+/* ── Polling ─────────────────────────────────────────────────────────── */
+
+static void parse_all_sta(char *out)
+{
+    for (int i = 0; i < MAX_CLIENTS; i++) g_steer.clients[i].present = false;
+
+    SteerClient *cur = NULL;
+    for (char *line = strtok(out, "\n"); line; line = strtok(NULL, "\n")) {
+        if (is_mac_line(line)) {
+            cur = find_client(line, true);
+            if (cur) {
+                cur->present    = true;
+                cur->signal_dbm = 0;
+            }
+            continue;
+        }
+        if (!cur) continue;
+
+        if (strncmp(line, "signal=", 7) == 0)
+            cur->signal_dbm = atoi(line + 7);
+        else if (strncmp(line, "ext_capab=", 10) == 0)
+            cur->btm = has_btm(line + 10);
+        else if (strncmp(line, "supp_op_classes=", 16) == 0)
+            cur->dual_band = has_5ghz_class(line + 16);
+    }
+}
+
+/*
+ * Runs without the lock: hostapd_cli can wait out its control timeout,
+ * and the main loop and the TUI read events and stats every tick. cfg,
+ * ap_iface and peer_class do not change while the thread runs.
+ */
+static bool send_request(const char *mac)
+{
+    const SteerConfig *cfg = &g_steer.cfg;
+    char cmd[MAX_CMD_LEN], out[MAX_LINE_LEN] = {0};
+
+    snprintf(cmd, sizeof(cmd),
+             "hostapd_cli -p %s -i %s BSS_TM_REQ %s pref=1 abridged=1 "
+             "valid_int=100 neighbor=%s,0x0000,%d,%d,9 2>/dev/null",
+             HOSTAPD_CTRL_DIR, g_steer.ap_iface, mac,
+             cfg->peer_bssid, g_steer.peer_class, cfg->peer_channel);
+    net_exec_cmd(cmd, out, sizeof(out));
+    return strncmp(out, "OK", 2) == 0;
+}
+
+static void record_request(SteerClient *c, bool accepted, time_t now)
+{
+    c->attempts++;
+    c->last_request   = now;
+    c->strong_samples = 0;
+    g_steer.stats.requests++;
+
+    if (accepted) {
+        c->state = STEER_PENDING;
+    } else {
+        g_steer.stats.ignored++;
+        c->state = c->attempts >= g_steer.cfg.max_attempts ? STEER_GAVE_UP
+                                                           : STEER_IGNORED;
+        push_event("Band steering: hostapd refused BTM request for %s", c->mac);
+    }
+}
+
+/* Updates verdicts and stats; candidates due a request go to due[] */
+static int evaluate(time_t now, char due[][MAX_MAC_LEN])
+{
+    int ndue = 0;
+    const SteerConfig *cfg = &g_steer.cfg;
+    int tracked = 0, capable = 0;
+
+    for (int i = 0; i < MAX_CLIENTS; i++) {
+        SteerClient *c = &g_steer.clients[i];
+        if (c->mac[0] == '\0') continue;
+        tracked++;
+
+        if (c->state == STEER_PENDING) {
+            if (!c->present) {
+                c->state = STEER_MOVED;
+                g_steer.stats.moved++;
+                push_event("Band steering: %s moved to 5 GHz (attempt %d)",
+                           c->mac, c->attempts);
+            } else if (now - c->last_request >= STEER_VERDICT_SECS) {
+                g_steer.stats.ignored++;
+                if (c->attempts >= cfg->max_attempts) {
+                    c->state = STEER_GAVE_UP;
+                    push_event("Band steering: %s stayed on 2.4 GHz, giving up "
+                               "after %d attempts", c->mac, c->attempts);
+                } else {
+                    c->state = STEER_IGNORED;
+                    push_event("Band steering: %s stayed on 2.4 GHz (%d dBm), "
+                               "retry in %d s", c->mac, c->signal_dbm,
+                               cfg->cooldown_s);
+                }
+            }
+            continue;
+        }
+
+        if (!c->present) {
+            c->strong_samples = 0;
+            continue;
+        }
+        if (!c->btm || !c->dual_band) continue;
+        capable++;
+        if (c->state == STEER_GAVE_UP || c->signal_dbm == 0) continue;
+
+        if (c->signal_dbm >= cfg->min_signal + cfg->hysteresis)
+            c->strong_samples++;
+        else if (c->signal_dbm < cfg->min_signal)
+            c->strong_samples = 0;
+
+        if (c->strong_samples >= STEER_SAMPLES &&
+            (c->last_request == 0 || now - c->last_request >= cfg->cooldown_s))
+            memcpy(due[ndue++], c->mac, MAX_MAC_LEN);
+    }
+
+    g_steer.stats.tracked = tracked;
+    g_steer.stats.capable = capable;
+    return ndue;
+}
+
+/*
+ * The whole "all_sta" listing, or false. A cut-off listing would make
+ * the stations past the cut look gone, and pending ones count as moved,
+ * so a poll that does not fit is skipped.
+ */
+static bool read_all_sta(const char *cmd, char *out, size_t size)
+{
+    FILE *fp = popen(cmd, "r");
+    if (!fp) return false;
+
+    size_t total = 0, n;
+    bool fits = true;
+    char drain[4096];
+    while (fits && (n = fread(out + total, 1, size - 1 - total, fp)) > 0) {
+        total += n;
+        if (total == size - 1 && fread(drain, 1, sizeof(drain), fp) > 0)
+            fits = false;
+    }
+    while (!fits && fread(drain, 1, sizeof(drain), fp) > 0)
+        ;
+    out[total] = '\0';
+    return pclose(fp) == 0 && fits;
+}
+
+static void *steer_thread(void *arg)
+{
+    (void)arg;
+    char cmd[MAX_CMD_LEN];
+    static char out[STEER_STA_BYTES];
+    char due[MAX_CLIENTS][MAX_MAC_LEN];
+    bool accepted[MAX_CLIENTS];
+
+    snprintf(cmd, sizeof(cmd), "hostapd_cli -p %s -i %s all_sta 2>/dev/null",
+             HOSTAPD_CTRL_DIR, g_steer.ap_iface);
+
+    while (atomic_load(&g_steer.running)) {
+        bool ok = read_all_sta(cmd, out, sizeof(out));
+
+        int ndue = 0;
+        pthread_mutex_lock(&g_steer.lock);
+        if (ok) {
+            parse_all_sta(out);
+            ndue = evaluate(time(NULL), due);
+        }
+        pthread_mutex_unlock(&g_steer.lock);
+
+        int sent = 0;
+        while (sent < ndue && atomic_load(&g_steer.running)) {
+            accepted[sent] = send_request(due[sent]);
+            sent++;
+        }
+
+        /* Only this thread adds or replaces clients, so they are still there */
+        if (sent > 0) {
+            time_t now = time(NULL);
+            pthread_mutex_lock(&g_steer.lock);
+            for (int i = 0; i < sent; i++) {
+                SteerClient *c = find_client(due[i], false);
+                if (c) record_request(c, accepted[i], now);
+            }
+            pthread_mutex_unlock(&g_steer.lock);
+        }
+
+        for (int i = 0; i < STEER_POLL_SECS * 10 && atomic_load(&g_steer.running); i++)
+            usleep(100000);
+    }
+    return NULL;
+}
+
+/* ── Public API ──────────────────────────────────────────────────────── */
+
+bool steer_start(const SteerConfig *cfg, const char *ap_iface, int ap_channel,
+                 char *err, size_t errsize)
+{
+    if (atomic_load(&g_steer.running)) return true;
+
+    if (ap_channel < 1 || ap_channel > 14) {
+        snprintf(err, errsize, "AP is on channel %d; steering only moves "
+                 "clients from 2.4 GHz to 5 GHz", ap_channel);
+        return false;
+    }
+    int peer_class = steer_op_class(cfg->peer_channel);
+    if (!peer_class) {
+        snprintf(err, errsize, "steer_peer_channel %d is not a 5 GHz channel",
+                 cfg->peer_channel);
+        return false;
+    }
+    if (!is_mac_line(cfg->peer_bssid)) {
+        snprintf(err, errsize, "steer_peer is not set to a BSSID");
+        return false;
+    }
+
+    pthread_mutex_lock(&g_steer.lock);
+    g_steer.cfg        = *cfg;
+    g_steer.peer_class = peer_class;
+    snprintf(g_steer.ap_iface, sizeof(g_steer.ap_iface), "%s", ap_iface);
+    memset(g_steer.clients, 0, sizeof(g_steer.clients));
+    memset(&g_steer.stats, 0, sizeof(g_steer.stats));
+    g_steer.ev_head = g_steer.ev_count = 0;
+    pthread_mutex_unlock(&g_steer.lock);
+
+    /* Keep SIGINT/SIGWINCH on the main thread */
+    sigset_t all, old;
+    sigfillset(&all);
+    pthread_sigmask(SIG_SETMASK, &all, &old);
+    atomic_store(&g_steer.running, true);
+    bool ok = (pthread_create(&g_steer.thread, NULL, steer_thread, NULL) == 0);
+    pthread_sigmask(SIG_SETMASK, &old, NULL);
+
+    if (!ok) {
+        atomic_store(&g_steer.running, false);
+        snprintf(err, errsize, "cannot start steering thread");
+        return false;
+    }
+    return true;
+}
+
+bool steer_next_event(char *msg, size_t msgsize)
+{
+    bool found = false;
+
+    pthread_mutex_lock(&g_steer.lock);
+    if (g_steer.ev_count > 0) {
+        snprintf(msg, msgsize, "%s", g_steer.events[g_steer.ev_head]);
+        g_steer.ev_head = (g_steer.ev_head + 1) % STEER_MAX_EVENTS;
+        g_steer.ev_count--;
+        found = true;
+    }
+    pthread_mutex_unlock(&g_steer.lock);
+    return found;
+}
+
+void steer_get_stats(SteerStats *stats)
+{
+    pthread_mutex_lock(&g_steer.lock);
+    *stats = g_steer.stats;
+    pthread_mutex_unlock(&g_steer.lock);
+}
+
+void steer_stop(void)
+{
+    if (!atomic_load(&g_steer.running)) return;
+
+    atomic_store(&g_steer.running, false);
+    pthread_join(g_steer.thread, NULL);
+
+    pthread_mutex_lock(&g_steer.lock);
+    memset(g_steer.clients, 0, sizeof(g_steer.clients));
+    pthread_mutex_unlock(&g_steer.lock);
+}
+
+/* ── Standalone run ──────────────────────────────────────────────────── */
+
+int steer_simulate(int argc, char **argv)
+{
+    if (argc < 3) {
+        fprintf(stderr, "usage: steer-sim IFACE PEER_BSSID PEER_CHANNEL [SECONDS]\n");
+        return 2;
+    }
+
+    SteerConfig cfg;
+    steer_default(&cfg);
+    cfg.enabled = true;
+    snprintf(cfg.peer_bssid, sizeof(cfg.peer_bssid), "%s", argv[1]);
+    cfg.peer_channel = atoi(argv[2]);
+    int seconds = argc > 3 ? atoi(argv[3]) : 60;
+
+    int channel = net_get_current_channel(argv[0]);
+    char err[MAX_LINE_LEN];
+    if (!steer_start(&cfg, argv[0], channel, err, sizeof(err))) {
+        fprintf(stderr, "steer-sim: %s\n", err);
+        return 1;
+    }
+    printf("# steering %s (channel %d) to %s on channel %d\n",
+           argv[0], channel, cfg.peer_bssid, cfg.peer_channel);
+    fflush(stdout);
+
+    char msg[MAX_LINE_LEN];
+    SteerStats st;
+    for (int t = 0; t < seconds * 4; t++) {
+        usleep(250000);
+        while (steer_next_event(msg, sizeof(msg)))
+            printf("t=%d %s\n", t / 4, msg);
+        fflush(stdout);
+        steer_get_stats(&st);
+        if (st.moved > 0 && st.capable == 0) break;   /* everyone left */
+    }
+
+    steer_get_stats(&st);
+    steer_stop();
+    printf("final requests=%lu moved=%lu ignored=%lu\n",
+           st.requests, st.moved, st.ignored);
+    return 0;
+}
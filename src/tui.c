@@ -19,6 +19,11 @@
 
 #include "tui.h"
 #include "hotspot.h"
+#include "web.h"
+#include "hooks.h"
+#include "lanperf.h"
+#include "oui.h"
+#include "netns.h"
 
 /* ── Globals for resize handler ──────────────────────────────────────── */
 
@@ -32,10 +37,8 @@ static void handle_resize(int sig)
 
 /* ── ncurses Init ────────────────────────────────────────────────────── */
 
-void tui_init(TuiState *tui, HotspotStatus *hs_status)
+static void init_state(TuiState *tui, HotspotStatus *hs_status)
 {
-    setlocale(LC_ALL, "");
-
     memset(tui, 0, sizeof(TuiState));
     tui->hs_status     = hs_status;
     tui->current_screen = SCREEN_DASHBOARD;
@@ -45,23 +48,10 @@ void tui_init(TuiState *tui, HotspotStatus *hs_status)
     tui->log_count      = 0;
     tui->log_scroll     = 0;
     tui->client_scroll  = 0;
+}
 
-    initscr();
-    cbreak();
-    noecho();
-    keypad(stdscr, TRUE);
-    curs_set(0);
-    nodelay(stdscr, TRUE);  /* non-blocking input */
-    timeout(500);           /* refresh every 500ms */
-
-    /* Setup signal handler for resize */
-    struct sigaction sa;
-    sa.sa_handler = handle_resize;
-    sa.sa_flags   = SA_RESTART;
-    sigemptyset(&sa.sa_mask);
-    sigaction(SIGWINCH, &sa, NULL);
-
-    /* Init colors */
+static void init_colors(void)
+{
     if (has_colors()) {
         start_color();
         use_default_colors();
@@ -83,6 +73,29 @@ void tui_init(TuiState *tui, HotspotStatus *hs_status)
         init_pair(CP_LOG_ERR,    COLOR_RED,     -1);
         init_pair(CP_BANNER,     COLOR_CYAN,    -1);
     }
+}
+
+void tui_init(TuiState *tui, HotspotStatus *hs_status)
+{
+    setlocale(LC_ALL, "");
+    init_state(tui, hs_status);
+
+    initscr();
+    cbreak();
+    noecho();
+    keypad(stdscr, TRUE);
+    curs_set(0);
+    nodelay(stdscr, TRUE);  /* non-blocking input */
+    timeout(500);           /* refresh every 500ms */
+
+    /* Setup signal handler for resize */
+    struct sigaction sa;
+    sa.sa_handler = handle_resize;
+    sa.sa_flags   = SA_RESTART;
+    sigemptyset(&sa.sa_mask);
+    sigaction(SIGWINCH, &sa, NULL);
+
+    init_colors();
 
     getmaxyx(stdscr, tui->term_rows, tui->term_cols);
 
@@ -108,6 +121,20 @@ void tui_init(TuiState *tui, HotspotStatus *hs_status)
     }
 }
 
+bool tui_init_offscreen(TuiState *tui, HotspotStatus *hs_status,
+                        FILE *out, FILE *in, int rows, int cols)
+{
+    setlocale(LC_ALL, "");
+    init_state(tui, hs_status);
+
+    if (!newterm("xterm-256color", out, in)) return false;
+    resizeterm(rows, cols);
+    curs_set(0);
+    init_colors();
+    getmaxyx(stdscr, tui->term_rows, tui->term_cols);
+    return true;
+}
+
 void tui_cleanup(TuiState *tui)
 {
     tui->running = false;
@@ -233,8 +260,9 @@ static void draw_header(TuiState *tui)
 static void draw_tabs(TuiState *tui)
 {
     int y = 1;
-    const char *tabs[] = { "F1:Dashboard", "F2:Config", "F3:Clients", "F4:Log" };
-    int tab_count = 4;
+    const char *tabs[] = { "F1:Dashboard", "F2:Config", "F3:Clients", "F4:Log",
+                           "F5:Queues" };
+    int tab_count = 5;
 
     mvhline(y, 0, ' ', tui->term_cols);
 
@@ -269,11 +297,11 @@ static void draw_footer(TuiState *tui)
     if (tui->current_screen == SCREEN_CONFIG && tui->editing) {
         hint = " [Enter] Save  [Esc] Cancel";
     } else if (tui->current_screen == SCREEN_DASHBOARD) {
-        hint = " [Enter] Start/Stop  [Tab/Shift+Tab] Switch screens  [F1-F4] Screens  [q] Quit";
+        hint = " [Enter] Start/Stop  [Tab/Shift+Tab] Switch screens  [F1-F5] Screens  [f] Flight dump  [d] Detach  [q] Quit";
     } else if (tui->current_screen == SCREEN_CONFIG) {
-        hint = " [Up/Down] Select  [Enter] Edit  [Tab/Shift+Tab] Switch screens  [F1-F4] Screens  [q] Quit";
+        hint = " [Up/Down] Select  [Enter] Edit  [Tab/Shift+Tab] Switch screens  [F1-F5] Screens  [q] Quit";
     } else {
-        hint = " [Up/Down] Scroll  [Tab/Shift+Tab] Switch screens  [F1-F4] Screens  [q] Quit";
+        hint = " [Up/Down] Scroll  [Tab/Shift+Tab] Switch screens  [F1-F5] Screens  [q] Quit";
     }
 
     mvprintw(y, 1, "%s", hint);
@@ -287,7 +315,7 @@ static void draw_dashboard(TuiState *tui)
     HotspotStatus *hs = tui->hs_status;
     int start_y = 3;
     int half_w = tui->term_cols / 2;
-    int box_h = 10;
+    int box_h = 12;
 
     /* Clamp box height if terminal is small */
     if (box_h + start_y + 3 > tui->term_rows) {
@@ -349,8 +377,10 @@ static void draw_dashboard(TuiState *tui)
                      state_str(hs->state), state_color(hs->state));
     draw_label_value(y++, pad, lbl_w, "SSID:",
                      hs->config.ssid, CP_NORMAL);
-    draw_label_value(y++, pad, lbl_w, "Interface:",
-                     hs->ap_iface, CP_NORMAL);
+    char iface_str[MAX_IFACE_NAME + 16];
+    snprintf(iface_str, sizeof(iface_str), hs->netns ? "%s (netns " NETNS_NAME ")" : "%s",
+             hs->ap_iface);
+    draw_label_value(y++, pad, lbl_w, "Interface:", iface_str, CP_NORMAL);
 
     char client_str[16];
     snprintf(client_str, sizeof(client_str), "%d", hs->client_count);
@@ -362,8 +392,58 @@ static void draw_dashboard(TuiState *tui)
         hotspot_get_uptime_str(hs, uptime, sizeof(uptime));
         draw_label_value(y++, pad, lbl_w, "Uptime:", uptime, CP_STATUS_OK);
 
-        draw_label_value(y++, pad, lbl_w, "Gateway:",
-                         AP_GATEWAY, CP_NORMAL);
+        if (hs->config.uplink.mode == UPLINK_NAT) {
+            draw_label_value(y++, pad, lbl_w, "Gateway:",
+                             AP_GATEWAY, CP_NORMAL);
+        } else {
+            char uplink_str[64];
+            snprintf(uplink_str, sizeof(uplink_str), "%s via %s",
+                     uplink_mode_name(hs->config.uplink.mode),
+                     hs->config.uplink.mode == UPLINK_BRIDGE
+                         ? hs->config.uplink.bridge : hs->wifi.name);
+            draw_label_value(y++, pad, lbl_w, "Uplink:", uplink_str, CP_NORMAL);
+        }
+
+        char ap_ch_str[32];
+        snprintf(ap_ch_str, sizeof(ap_ch_str), "%d%s", hs->ap_channel,
+                 hs->dfs ? " (DFS)" : "");
+        if (y < start_y + box_h - 1)
+            draw_label_value(y++, pad, lbl_w, "Channel:", ap_ch_str, CP_NORMAL);
+
+        time_t now = time(NULL);
+        if (hs->cac_end > now && y < start_y + box_h - 1) {
+            char cac_str[48];
+            snprintf(cac_str, sizeof(cac_str), "%ld s left, not beaconing yet",
+                     (long)(hs->cac_end - now));
+            draw_label_value(y++, pad, lbl_w, "Radar CAC:", cac_str,
+                             CP_STATUS_WARN);
+        }
+    }
+
+    HookStats hs_hooks;
+    hooks_get_stats(&hs_hooks);
+    if (hs_hooks.configured > 0 && y < start_y + box_h - 1) {
+        char hook_str[64];
+        snprintf(hook_str, sizeof(hook_str), "%lu ok, %lu failed, %lu dropped",
+                 hs_hooks.completed, hs_hooks.failed + hs_hooks.timed_out,
+                 hs_hooks.dropped);
+        draw_label_value(y++, pad, lbl_w, "Hooks:", hook_str,
+                         hs_hooks.dropped > 0 ? CP_STATUS_WARN : CP_NORMAL);
+    }
+
+    char tune_str[48];
+    statune_describe(&hs->sta_saved, tune_str, sizeof(tune_str));
+    if (tune_str[0] && hs->state == HS_STATE_RUNNING && y < start_y + box_h - 1)
+        draw_label_value(y++, pad, lbl_w, "Uplink STA:", tune_str, CP_NORMAL);
+
+    if (hs->config.steer.enabled && hs->state == HS_STATE_RUNNING &&
+        y < start_y + box_h - 1) {
+        SteerStats ss;
+        steer_get_stats(&ss);
+        char steer_str[64];
+        snprintf(steer_str, sizeof(steer_str), "%d capable, %lu moved, %lu stayed",
+                 ss.capable, ss.moved, ss.ignored);
+        draw_label_value(y++, pad, lbl_w, "Steering:", steer_str, CP_NORMAL);
     }
 
     if (hs->state == HS_STATE_ERROR && hs->error_msg[0]) {
@@ -432,7 +512,7 @@ static void draw_config(TuiState *tui)
 
     const char *field_names[] = {
         "SSID:", "Password:", "Channel:", "Band:",
-        "Max Clients:", "Hidden SSID:"
+        "Max Clients:", "Hidden SSID:", "Security:"
     };
 
     char field_values[CFG_FIELD_COUNT][64];
@@ -459,6 +539,9 @@ static void draw_config(TuiState *tui)
     }
     snprintf(field_values[CFG_MAX_CLIENTS], 64, "%d", cfg->max_clients);
     snprintf(field_values[CFG_HIDDEN], 64, "%s", cfg->hidden ? "Yes" : "No");
+    snprintf(field_values[CFG_SECURITY], 64, "%s",
+             cfg->security == SEC_SAE        ? "WPA3-SAE only" :
+             cfg->security == SEC_TRANSITION ? "WPA2/WPA3 transition" : "WPA2");
 
     for (int i = 0; i < CFG_FIELD_COUNT; i++) {
         int y = start_y + i * 2;
@@ -516,9 +599,18 @@ static void draw_clients(TuiState *tui)
     HotspotStatus *hs = tui->hs_status;
     int start_y = 4;
 
+    int capped = 0;
+    for (int i = 0; i < hs->client_count; i++)
+        if (hs->clients[i].limited) capped++;
+
     attron(COLOR_PAIR(CP_TITLE) | A_BOLD);
     mvprintw(3, 2, "Connected Clients (%d)", hs->client_count);
     attroff(COLOR_PAIR(CP_TITLE) | A_BOLD);
+    if (capped > 0) {
+        attron(COLOR_PAIR(CP_STATUS_ERR) | A_BOLD);
+        printw("  ! %d over the connection cap", capped);
+        attroff(COLOR_PAIR(CP_STATUS_ERR) | A_BOLD);
+    }
 
     if (hs->state != HS_STATE_RUNNING) {
         attron(COLOR_PAIR(CP_STATUS_OFF));
@@ -536,12 +628,16 @@ static void draw_clients(TuiState *tui)
     }
 
     /* Table header */
-    int col_mac = 4, col_ip = 24, col_host = 44;
+    int col_mac = 4, col_ip = 23, col_host = 40, col_vendor = 58, col_perf = 80;
+    bool show_perf = (tui->term_cols >= col_perf + 22);
 
     attron(COLOR_PAIR(CP_HIGHLIGHT) | A_BOLD);
-    mvprintw(start_y, col_mac,  "%-20s", "MAC Address");
-    mvprintw(start_y, col_ip,   "%-20s", "IP Address");
-    mvprintw(start_y, col_host, "%-20s", "Hostname");
+    mvprintw(start_y, col_mac,    "%-17s", "MAC Address");
+    mvprintw(start_y, col_ip,     "%-15s", "IP Address");
+    mvprintw(start_y, col_host,   "%-16s", "Hostname");
+    mvprintw(start_y, col_vendor, "%-20s", "Vendor");
+    if (show_perf)
+        mvprintw(start_y, col_perf, "%-20s", "LAN Throughput");
     attroff(COLOR_PAIR(CP_HIGHLIGHT) | A_BOLD);
 
     attron(COLOR_PAIR(CP_BORDER));
@@ -558,10 +654,23 @@ static void draw_clients(TuiState *tui)
         ConnectedClient *c = &hs->clients[start_idx + i];
         int y = start_y + 2 + i;
 
+        if (c->limited) {
+            attron(COLOR_PAIR(CP_STATUS_ERR) | A_BOLD);
+            mvprintw(y, col_mac - 2, "!");
+            attroff(COLOR_PAIR(CP_STATUS_ERR) | A_BOLD);
+        }
+
         attron(COLOR_PAIR(CP_CLIENT));
-        mvprintw(y, col_mac,  "%-20s", c->mac);
-        mvprintw(y, col_ip,   "%-20s", c->ip);
-        mvprintw(y, col_host, "%-20s", c->hostname);
+        mvprintw(y, col_mac,    "%-17s", c->mac);
+        mvprintw(y, col_ip,     "%-15.15s", c->ip);
+        mvprintw(y, col_host,   "%-16.16s", c->hostname);
+        mvprintw(y, col_vendor, "%-20.20s", oui_vendor(c->mac));
+
+        LanPerfResult pr;
+        if (show_perf && lanperf_get_result(c->ip, &pr)) {
+            mvprintw(y, col_perf, "%-4s %7.1f Mbit/s",
+                     lanperf_mode_name(pr.mode), pr.mbps);
+        }
         attroff(COLOR_PAIR(CP_CLIENT));
     }
 }
@@ -616,6 +725,119 @@ static void draw_log(TuiState *tui)
     }
 }
 
+/* ── Queues Screen ───────────────────────────────────────────────────── */
+
+static const char *ap_phy(const HotspotStatus *hs)
+{
+    return hs->config.ap_phy[0] ? hs->config.ap_phy : hs->phy;
+}
+
+static void refresh_queues(TuiState *tui)
+{
+    time_t now = time(NULL);
+    tui->txq_interval = tui->txq_time ? (double)(now - tui->txq_time) : 0;
+    tui->txq_prev = tui->txq;
+    txq_read(ap_phy(tui->hs_status), tui->hs_status->ap_iface, &tui->txq);
+    tui->txq_time = now;
+}
+
+/* Share of wall time a station held the air (TX + RX) since the last read */
+static double airtime_pct(const TuiState *tui, const TxqStation *sta)
+{
+    if (tui->txq_interval <= 0) return -1;
+    for (int i = 0; i < tui->txq_prev.count; i++) {
+        const TxqStation *p = &tui->txq_prev.stations[i];
+        if (strcmp(p->mac, sta->mac) != 0) continue;
+        unsigned long prev = p->airtime_tx_us + p->airtime_rx_us;
+        unsigned long cur  = sta->airtime_tx_us + sta->airtime_rx_us;
+        if (cur < prev) return -1;
+        return (double)(cur - prev) / (tui->txq_interval * 1e4);
+    }
+    return -1;
+}
+
+static void draw_queues(TuiState *tui)
+{
+    HotspotStatus *hs = tui->hs_status;
+    TxqSnapshot *q = &tui->txq;
+    int start_y = 4;
+
+    attron(COLOR_PAIR(CP_TITLE) | A_BOLD);
+    mvprintw(3, 2, "Airtime Queues (%s)", ap_phy(hs));
+    attroff(COLOR_PAIR(CP_TITLE) | A_BOLD);
+
+    if (hs->state != HS_STATE_RUNNING) {
+        attron(COLOR_PAIR(CP_STATUS_OFF));
+        mvprintw(start_y + 1, 4, "Hotspot is not running.");
+        attroff(COLOR_PAIR(CP_STATUS_OFF));
+        return;
+    }
+
+    if (!q->available) {
+        attron(COLOR_PAIR(CP_STATUS_WARN));
+        mvprintw(start_y + 1, 4, "Queue statistics unavailable: %.*s",
+                 tui->term_cols - 40, q->why);
+        attroff(COLOR_PAIR(CP_STATUS_WARN));
+        return;
+    }
+
+    int lbl_w = 12, y = start_y;
+    char line[128];
+    if (q->have_limits) {
+        int off = 0;
+        for (int ac = 0; ac < TXQ_NUM_AC; ac++)
+            off += snprintf(line + off, sizeof(line) - off, "%s %d/%d  ",
+                            txq_ac_name(ac), q->limit_low[ac], q->limit_high[ac]);
+        draw_label_value(y++, 4, lbl_w, "AQL (us):", line,
+                         hs->aql_saved.saved ? CP_STATUS_OK : CP_NORMAL);
+    } else {
+        draw_label_value(y++, 4, lbl_w, "AQL (us):", "not supported", CP_STATUS_OFF);
+    }
+    if (q->pending_us >= 0) {
+        snprintf(line, sizeof(line), "%ld us queued below mac80211", q->pending_us);
+        draw_label_value(y++, 4, lbl_w, "Pending:", line, CP_NORMAL);
+    }
+    y++;
+
+    if (q->count == 0) {
+        attron(COLOR_PAIR(CP_STATUS_OFF));
+        mvprintw(y, 4, "No stations associated.");
+        attroff(COLOR_PAIR(CP_STATUS_OFF));
+        return;
+    }
+
+    int col_mac = 4, col_bl = 24, col_drop = 42, col_tx = 52, col_air = 64;
+    attron(COLOR_PAIR(CP_HIGHLIGHT) | A_BOLD);
+    mvprintw(y, col_mac,  "%-18s", "Station");
+    mvprintw(y, col_bl,   "%-16s", "Backlog");
+    mvprintw(y, col_drop, "%-8s", "Drops");
+    mvprintw(y, col_tx,   "%-10s", "TX pkts");
+    if (tui->term_cols >= col_air + 12)
+        mvprintw(y, col_air, "%-10s", "Airtime");
+    attroff(COLOR_PAIR(CP_HIGHLIGHT) | A_BOLD);
+    y++;
+
+    attron(COLOR_PAIR(CP_BORDER));
+    draw_hline(y++, 2, tui->term_cols - 4, ACS_HLINE);
+    attroff(COLOR_PAIR(CP_BORDER));
+
+    for (int i = 0; i < q->count && y < tui->term_rows - 2; i++, y++) {
+        const TxqStation *sta = &q->stations[i];
+        attron(COLOR_PAIR(sta->backlog_packets > 0 ? CP_STATUS_WARN : CP_CLIENT));
+        mvprintw(y, col_mac, "%-18s", sta->mac);
+        mvprintw(y, col_bl, "%lu B / %lu pkt", sta->backlog_bytes,
+                 sta->backlog_packets);
+        mvprintw(y, col_drop, "%-8lu", sta->drops);
+        mvprintw(y, col_tx, "%-10lu", sta->tx_packets);
+        double pct = airtime_pct(tui, sta);
+        if (tui->term_cols >= col_air + 12) {
+            if (pct >= 0) mvprintw(y, col_air, "%5.1f %%", pct);
+            else          mvprintw(y, col_air, "%5s", "-");
+        }
+        attroff(COLOR_PAIR(sta->backlog_packets > 0 ? CP_STATUS_WARN : CP_CLIENT));
+    }
+}
+
 /* ── Redraw ──────────────────────────────────────────────────────────── */
 
 void tui_redraw(TuiState *tui)
@@ -641,6 +863,7 @@ void tui_redraw(TuiState *tui)
         case SCREEN_CONFIG:    draw_config(tui);    break;
         case SCREEN_CLIENTS:   draw_clients(tui);   break;
         case SCREEN_LOG:       draw_log(tui);       break;
+        case SCREEN_QUEUES:    draw_queues(tui);    break;
         default: break;
     }
 
@@ -690,6 +913,13 @@ static void start_edit(TuiState *tui)
             tui_log(tui, LOG_INFO, "Hidden SSID: %s",
                     cfg->hidden ? "Yes" : "No");
             return;
+        case CFG_SECURITY:
+            /* Cycle wpa2 → transition → sae */
+            cfg->security = (SecurityMode)((cfg->security + 1) % 3);
+            tui->editing = false;
+            tui_log(tui, LOG_INFO, "Security: %s",
+                    hotspot_security_name(cfg->security));
+            return;
         default:
             tui->editing = false;
             return;
@@ -819,12 +1049,38 @@ void tui_run(TuiState *tui)
         if (now - last_refresh >= 2) {
             if (tui->hs_status->state == HS_STATE_RUNNING) {
                 hotspot_refresh_status(tui->hs_status);
+                if (tui->hs_status->event[0]) {
+                    tui_log(tui, LOG_WARN, "%s", tui->hs_status->event);
+                    tui->hs_status->event[0] = '\0';
+                }
             } else if (tui->hs_status->wifi.name[0]) {
                 net_refresh_wifi_status(&tui->hs_status->wifi);
             }
             last_refresh = now;
         }
 
+        /* Queue statistics only while their screen is shown */
+        if (tui->current_screen == SCREEN_QUEUES &&
+            tui->hs_status->state == HS_STATE_RUNNING &&
+            now - tui->txq_time >= 2)
+            refresh_queues(tui);
+
+        /* Push changes to dashboard viewers (no-op when none) */
+        web_publish(tui->hs_status);
+
+        /* Band steering outcomes */
+        char steer_msg[MAX_LINE_LEN];
+        while (steer_next_event(steer_msg, sizeof(steer_msg)))
+            tui_log(tui, LOG_INFO, "%s", steer_msg);
+
+        /* Flight recorder dumps */
+        while (recorder_next_event(steer_msg, sizeof(steer_msg)))
+            tui_log(tui, LOG_WARN, "%s", steer_msg);
+
+        /* Peers and decisions of multi-node coordination */
+        while (coord_next_event(steer_msg, sizeof(steer_msg)))
+            tui_log(tui, LOG_INFO, "%s", steer_msg);
+
         /* Redraw */
         tui_redraw(tui);
 
@@ -844,6 +1100,26 @@ void tui_run(TuiState *tui)
                 tui->running = false;
                 break;
 
+            case 'd':
+            case 'D':
+                if (tui->hs_status->state == HS_STATE_RUNNING) {
+                    hotspot_detach(tui->hs_status);
+                    tui->running = false;
+                } else {
+                    tui_log(tui, LOG_INFO, "Hotspot is not running; nothing to detach.");
+                }
+                break;
+
+            case 'f':
+            case 'F':
+                if (tui->hs_status->state == HS_STATE_RUNNING &&
+                    tui->hs_status->config.recorder.enabled) {
+                    recorder_request_dump();
+                } else {
+                    tui_log(tui, LOG_INFO, "Flight recorder is not running.");
+                }
+                break;
+
             case KEY_F(1):
                 tui->current_screen = SCREEN_DASHBOARD;
                 break;
@@ -856,6 +1132,9 @@ void tui_run(TuiState *tui)
             case KEY_F(4):
                 tui->current_screen = SCREEN_LOG;
                 break;
+            case KEY_F(5):
+                tui->current_screen = SCREEN_QUEUES;
+                break;
 
             case KEY_BTAB: /* Shift+Tab (reverse) */
                 tui->current_screen = (tui->current_screen - 1 + SCREEN_COUNT) % SCREEN_COUNT;
@@ -876,6 +1155,9 @@ void tui_run(TuiState *tui)
                             tui_log(tui, LOG_SUCCESS,
                                     "Hotspot started! SSID: %s",
                                     tui->hs_status->config.ssid);
+                            if (tui->hs_status->notice[0])
+                                tui_log(tui, LOG_WARN, "%s",
+                                        tui->hs_status->notice);
                         } else {
                             tui_log(tui, LOG_ERROR,
                                     "Failed: %s", tui->hs_status->error_msg);
@@ -0,0 +1,257 @@
+/*
+ * txq.c - mac80211 TXQ / AQL statistics and tuning for Linux Hotspot Enabler
+ *
+ * All debugfs files are small text tables; the phy files and each
+ * station's aqm + airtime pair are read in fio batches, so a refresh
+ * with a full AP costs a handful of submissions.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+#include <dirent.h>
+#include <errno.h>
+#include <unistd.h>
+
+#include "txq.h"
+#include "fileio.h"
+
+#define TXQ_BUF_LEN     2048    /* aqm: one line per TID, 16 TIDs */
+#define TXQ_STA_BATCH   (FIO_MAX_OPS / 2)
+
+static const char *const g_ac_names[TXQ_NUM_AC] = { "VO", "VI", "BE", "BK" };
+
+const char *txq_ac_name(int ac)
+{
+    return ac >= 0 && ac < TXQ_NUM_AC ? g_ac_names[ac] : "?";
+}
+
+/* ── Parsers ─────────────────────────────────────────────────────────── */
+
+/* "VO	5000		12000" lines under a header */
+static bool parse_limits(char *text, int *low, int *high)
+{
+    int found = 0;
+    char *save = NULL;
+    for (char *line = strtok_r(text, "\n", &save); line;
+         line = strtok_r(NULL, "\n", &save)) {
+        char ac[8];
+        int lo, hi;
+        if (sscanf(line, "%7s %d %d", ac, &lo, &hi) != 3) continue;
+        for (int i = 0; i < TXQ_NUM_AC; i++) {
+            if (strcmp(ac, g_ac_names[i]) == 0) {
+                low[i] = lo;
+                high[i] = hi;
+                found++;
+            }
+        }
+    }
+    return found == TXQ_NUM_AC;
+}
+
+/* "total: 1234 us" (older kernels: "total  1234 us") */
+static long parse_pending(const char *text)
+{
+    const char *p = strstr(text, "total");
+    if (!p) return -1;
+    p += 5;
+    while (*p == ':' || *p == ' ' || *p == '\t') p++;
+    return isdigit((unsigned char)*p) ? strtol(p, NULL, 10) : -1;
+}
+
+/*
+ * "tid ac backlog-bytes backlog-packets new-flows drops marks overlimit
+ *  collisions tx-bytes tx-packets flags", one line per TID
+ */
+static void parse_aqm(char *text, TxqStation *sta)
+{
+    char *save = NULL;
+    for (char *line = strtok_r(text, "\n", &save); line;
+         line = strtok_r(NULL, "\n", &save)) {
+        if (!isdigit((unsigned char)line[0])) continue;
+        int tid, ac;
+        unsigned long bb, bp, nf, dr, mk, ol, co, tb, tp;
+        if (sscanf(line, "%d %d %lu %lu %lu %lu %lu %lu %lu %lu %lu",
+                   &tid, &ac, &bb, &bp, &nf, &dr, &mk, &ol, &co, &tb, &tp) != 11)
+            continue;
+        sta->backlog_bytes   += bb;
+        sta->backlog_packets += bp;
+        sta->drops           += dr;
+        sta->marks           += mk;
+        sta->tx_packets      += tp;
+    }
+}
+
+/* "RX: 123 us" / "TX: 456 us" */
+static void parse_airtime(const char *text, TxqStation *sta)
+{
+    const char *p;
+    if ((p = strstr(text, "RX:"))) sta->airtime_rx_us = strtoul(p + 3, NULL, 10);
+    if ((p = strstr(text, "TX:"))) sta->airtime_tx_us = strtoul(p + 3, NULL, 10);
+}
+
+/* ── Snapshot ────────────────────────────────────────────────────────── */
+
+static bool debugfs_mounted(void)
+{
+    char mounts[8192];
+    return fio_read_file("/proc/mounts", mounts, sizeof(mounts)) &&
+           strstr(mounts, " debugfs ");
+}
+
+static void explain_missing(const char *phy, TxqSnapshot *snap)
+{
+    if (access(TXQ_DEBUGFS_ROOT, F_OK) == 0)
+        snprintf(snap->why, sizeof(snap->why),
+                 "no mac80211 debugfs entry for %s", phy);
+    else if (errno == EACCES)
+        snprintf(snap->why, sizeof(snap->why), "debugfs is not readable");
+    else if (!debugfs_mounted())
+        snprintf(snap->why, sizeof(snap->why),
+                 "debugfs is not mounted (mount -t debugfs none /sys/kernel/debug)");
+    else
+        snprintf(snap->why, sizeof(snap->why),
+                 "kernel built without mac80211 debugfs");
+}
+
+static void read_stations(const char *sta_dir, TxqSnapshot *snap)
+{
+    DIR *d = opendir(sta_dir);
+    if (!d) return;
+
+    char macs[MAX_CLIENTS][MAX_MAC_LEN];
+    int n = 0;
+    struct dirent *de;
+    while ((de = readdir(d)) && n < MAX_CLIENTS) {
+        if (strlen(de->d_name) != MAX_MAC_LEN - 1) continue;
+        memcpy(macs[n], de->d_name, MAX_MAC_LEN);
+        n++;
+    }
+    closedir(d);
+
+    static char bufs[TXQ_STA_BATCH][2][TXQ_BUF_LEN];
+    char paths[TXQ_STA_BATCH][2][MAX_PATH_LEN * 2 + 32];
+
+    for (int base = 0; base < n; base += TXQ_STA_BATCH) {
+        int chunk = n - base < TXQ_STA_BATCH ? n - base : TXQ_STA_BATCH;
+        FioBatch b;
+        FioOp *ops[TXQ_STA_BATCH][2];
+        fio_batch_init(&b);
+
+        for (int i = 0; i < chunk; i++) {
+            snprintf(paths[i][0], sizeof(paths[i][0]), "%s/%.*s/aqm",
+                     sta_dir, MAX_MAC_LEN - 1, macs[base + i]);
+            snprintf(paths[i][1], sizeof(paths[i][1]), "%s/%.*s/airtime",
+                     sta_dir, MAX_MAC_LEN - 1, macs[base + i]);
+            ops[i][0] = fio_add_read(&b, paths[i][0], bufs[i][0], TXQ_BUF_LEN);
+            ops[i][1] = fio_add_read(&b, paths[i][1], bufs[i][1], TXQ_BUF_LEN);
+        }
+        fio_submit(&b);
+
+        for (int i = 0; i < chunk; i++) {
+            TxqStation *sta = &snap->stations[snap->count++];
+            memset(sta, 0, sizeof(TxqStation));
+            memcpy(sta->mac, macs[base + i], MAX_MAC_LEN);
+            if (ops[i][0]->result > 0) parse_aqm(bufs[i][0], sta);
+            if (ops[i][1]->result > 0) parse_airtime(bufs[i][1], sta);
+        }
+    }
+}
+
+bool txq_read(const char *phy, const char *iface, TxqSnapshot *snap)
+{
+    memset(snap, 0, sizeof(TxqSnapshot));
+    snap->pending_us = -1;
+
+    char dir[MAX_PATH_LEN];
+    snprintf(dir, sizeof(dir), TXQ_DEBUGFS_ROOT "/%s", phy);
+    if (access(dir, F_OK) != 0) {
+        explain_missing(phy, snap);
+        return false;
+    }
+    snap->available = true;
+
+    /* AQL arrived in 5.5; without it there are still the TXQ stats */
+    char limits_path[MAX_PATH_LEN + 16], pending_path[MAX_PATH_LEN + 16];
+    char limits[512], pending[512];
+    snprintf(limits_path, sizeof(limits_path), "%s/aql_txq_limit", dir);
+    snprintf(pending_path, sizeof(pending_path), "%s/aql_pending", dir);
+
+    FioBatch b;
+    fio_batch_init(&b);
+    FioOp *lim = fio_add_read(&b, limits_path, limits, sizeof(limits));
+    FioOp *pen = fio_add_read(&b, pending_path, pending, sizeof(pending));
+    fio_submit(&b);
+    if (lim->result > 0)
+        snap->have_limits = parse_limits(limits, snap->limit_low, snap->limit_high);
+    if (pen->result > 0)
+        snap->pending_us = parse_pending(pending);
+
+    char sta_dir[MAX_PATH_LEN * 2];
+    snprintf(sta_dir, sizeof(sta_dir), "%s/netdev:%s/stations", dir, iface);
+    read_stations(sta_dir, snap);
+    return true;
+}
+
+/* ── Tuning ──────────────────────────────────────────────────────────── */
+
+static bool write_limits(const char *path, const int *low, const int *high)
+{
+    char lines[TXQ_NUM_AC][48];
+    FioBatch b;
+    fio_batch_init(&b);
+
+    /* One "ac low high" per write: the file takes a single AC at a time */
+    for (int ac = 0; ac < TXQ_NUM_AC; ac++) {
+        int len = snprintf(lines[ac], sizeof(lines[ac]), "%d %d %d\n",
+                           ac, low[ac], high[ac]);
+        fio_add_write(&b, path, lines[ac], (size_t)len, 0600);
+    }
+    return fio_submit(&b);
+}
+
+bool txq_aql_apply(const char *phy, const TxqAqlConfig *cfg,
+                   TxqAqlSaved *saved, char *err, size_t errsize)
+{
+    saved->saved = false;
+
+    char path[MAX_PATH_LEN], text[512];
+    snprintf(path, sizeof(path), TXQ_DEBUGFS_ROOT "/%s/aql_txq_limit", phy);
+    if (!fio_read_file(path, text, sizeof(text))) {
+        TxqSnapshot probe;
+        if (!txq_read(phy, "", &probe))
+            snprintf(err, errsize, "%s", probe.why);
+        else
+            snprintf(err, errsize, "%s has no AQL (kernel older than 5.5?)", phy);
+        return false;
+    }
+    if (!parse_limits(text, saved->low, saved->high)) {
+        snprintf(err, errsize, "unexpected aql_txq_limit format");
+        return false;
+    }
+
+    int low[TXQ_NUM_AC], high[TXQ_NUM_AC];
+    for (int ac = 0; ac < TXQ_NUM_AC; ac++) {
+        low[ac]  = cfg->low;
+        high[ac] = cfg->high;
+    }
+    saved->saved = true;
+    if (!write_limits(path, low, high)) {
+        txq_aql_restore(phy, saved);
+        snprintf(err, errsize, "kernel refused AQL limits %d/%d us",
+                 cfg->low, cfg->high);
+        return false;
+    }
+    return true;
+}
+
+void txq_aql_restore(const char *phy, TxqAqlSaved *saved)
+{
+    if (!saved->saved) return;
+
+    char path[MAX_PATH_LEN];
+    snprintf(path, sizeof(path), TXQ_DEBUGFS_ROOT "/%s/aql_txq_limit", phy);
+    write_limits(path, saved->low, saved->high);
+    saved->saved = false;
+}
@@ -0,0 +1,413 @@
+/*
+ * uplink.c - Bridge and proxy-ARP uplink modes for Linux Hotspot Enabler
+ *
+ * Bridge mode relies on hostapd's "bridge=" option to add the AP to the
+ * bridge once it is up; this file only makes sure the bridge exists.
+ * With bridge-nf-call-iptables switched off, bridged frames never enter
+ * iptables or conntrack. The sysctl is host-wide (it covers Docker and
+ * other bridges too), so stop puts the old value back.
+ *
+ * Proxy-ARP mode is routed, not bridged: the AP interface borrows the
+ * uplink's address as a /32, the kernel answers ARP for the upstream
+ * LAN on the AP side and for clients on the uplink side, and each client
+ * learned from the AP's neighbour table gets a /32 route. Client
+ * packets, and uplink packets not addressed to the host itself, are
+ * marked NOTRACK in the raw table.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+#include <unistd.h>
+
+#include "uplink.h"
+
+#define BRIDGE_NF_PATH "/proc/sys/net/bridge/bridge-nf-call-iptables"
+
+/* ── Config ──────────────────────────────────────────────────────────── */
+
+void uplink_default(UplinkConfig *cfg)
+{
+    memset(cfg, 0, sizeof(UplinkConfig));
+    cfg->mode = UPLINK_NAT;
+    snprintf(cfg->bridge, sizeof(cfg->bridge), "%s", UPLINK_DEFAULT_BRIDGE);
+}
+
+bool uplink_parse_mode(const char *value, UplinkMode *mode)
+{
+    if (strcasecmp(value, "nat") == 0)      { *mode = UPLINK_NAT;      return true; }
+    if (strcasecmp(value, "bridge") == 0)   { *mode = UPLINK_BRIDGE;   return true; }
+    if (strcasecmp(value, "proxyarp") == 0) { *mode = UPLINK_PROXYARP; return true; }
+    return false;
+}
+
+const char *uplink_mode_name(UplinkMode mode)
+{
+    switch (mode) {
+        case UPLINK_BRIDGE:   return "bridge";
+        case UPLINK_PROXYARP: return "proxyarp";
+        default:              return "nat";
+    }
+}
+
+/* ── Helpers ─────────────────────────────────────────────────────────── */
+
+static int read_int_file(const char *path)
+{
+    FILE *fp = fopen(path, "r");
+    if (!fp) return -1;
+    int v = -1;
+    if (fscanf(fp, "%d", &v) != 1) v = -1;
+    fclose(fp);
+    return v;
+}
+
+static void write_int_file(const char *path, int value)
+{
+    FILE *fp = fopen(path, "w");
+    if (!fp) return;
+    fprintf(fp, "%d\n", value);
+    fclose(fp);
+}
+
+static bool iface_exists(const char *iface, const char *subdir)
+{
+    char path[MAX_PATH_LEN];
+    snprintf(path, sizeof(path), "/sys/class/net/%s%s%s",
+             iface, subdir ? "/" : "", subdir ? subdir : "");
+    return access(path, F_OK) == 0;
+}
+
+static void proxy_arp_path(char *path, size_t size, const char *iface)
+{
+    snprintf(path, size, "/proc/sys/net/ipv4/conf/%s/proxy_arp", iface);
+}
+
+/* ── Bridge Mode ─────────────────────────────────────────────────────── */
+
+/* Move IPv4 addresses and the default route from one interface to another */
+static void move_addresses(const char *from, const char *to, UplinkSaved *save)
+{
+    char cmd[MAX_CMD_LEN], out[2048] = {0};
+
+    snprintf(cmd, sizeof(cmd), "ip -4 -o addr show dev %s 2>/dev/null", from);
+    net_exec_cmd(cmd, out, sizeof(out));
+
+    save->moved_count = 0;
+    for (char *p = out; (p = strstr(p, " inet ")) != NULL; p += 6) {
+        if (save->moved_count >= UPLINK_MAX_ADDRS) break;
+        char *addr = save->moved_addrs[save->moved_count];
+        if (sscanf(p + 6, "%49s", addr) == 1) save->moved_count++;
+    }
+
+    out[0] = '\0';
+    snprintf(cmd, sizeof(cmd), "ip -4 route show default dev %s 2>/dev/null", from);
+    net_exec_cmd(cmd, out, sizeof(out));
+    save->moved_gateway[0] = '\0';
+    char *via = strstr(out, "via ");
+    if (via) sscanf(via + 4, "%45s", save->moved_gateway);
+
+    for (int i = 0; i < save->moved_count; i++) {
+        snprintf(cmd, sizeof(cmd), "ip addr del %s dev %s 2>/dev/null",
+                 save->moved_addrs[i], from);
+        net_exec_silent(cmd);
+        snprintf(cmd, sizeof(cmd), "ip addr add %s dev %s 2>/dev/null",
+                 save->moved_addrs[i], to);
+        net_exec_silent(cmd);
+    }
+    if (save->moved_gateway[0]) {
+        snprintf(cmd, sizeof(cmd),
+                 "ip route replace default via %s dev %s 2>/dev/null",
+                 save->moved_gateway, to);
+        net_exec_silent(cmd);
+    }
+}
+
+bool uplink_prepare_bridge(const UplinkConfig *cfg, UplinkSaved *save,
+                           char *err, size_t errsize)
+{
+    char cmd[MAX_CMD_LEN];
+
+    if (!iface_exists(cfg->bridge, "bridge")) {
+        if (iface_exists(cfg->bridge, NULL)) {
+            snprintf(err, errsize, "%s exists but is not a bridge", cfg->bridge);
+            return false;
+        }
+        if (!cfg->bridge_port[0]) {
+            snprintf(err, errsize, "bridge %s does not exist "
+                     "(set bridge_port to create it)", cfg->bridge);
+            return false;
+        }
+        if (!iface_exists(cfg->bridge_port, NULL)) {
+            snprintf(err, errsize, "bridge_port %s not found", cfg->bridge_port);
+            return false;
+        }
+        if (iface_exists(cfg->bridge_port, "wireless")) {
+            snprintf(err, errsize, "%s is a WiFi interface and cannot be "
+                     "bridged; use uplink_mode = proxyarp", cfg->bridge_port);
+            return false;
+        }
+
+        snprintf(cmd, sizeof(cmd), "ip link add name %s type bridge", cfg->bridge);
+        if (net_exec_silent(cmd) != 0) {
+            snprintf(err, errsize, "cannot create bridge %s", cfg->bridge);
+            return false;
+        }
+        save->created_bridge = true;
+
+        snprintf(cmd, sizeof(cmd), "ip link set %s master %s && ip link set %s up",
+                 cfg->bridge_port, cfg->bridge, cfg->bridge);
+        if (net_exec_silent(cmd) != 0) {
+            snprintf(err, errsize, "cannot add %s to %s",
+                     cfg->bridge_port, cfg->bridge);
+            return false;
+        }
+        move_addresses(cfg->bridge_port, cfg->bridge, save);
+    }
+
+    snprintf(cmd, sizeof(cmd), "ip link set %s up 2>/dev/null", cfg->bridge);
+    net_exec_silent(cmd);
+
+    /* Keep bridged client traffic out of iptables and conntrack (host-wide) */
+    save->bridge_nf_call = read_int_file(BRIDGE_NF_PATH);
+    if (save->bridge_nf_call > 0) write_int_file(BRIDGE_NF_PATH, 0);
+
+    return true;
+}
+
+/* ── Proxy-ARP Mode ──────────────────────────────────────────────────── */
+
+bool uplink_start_proxyarp(const char *ap_iface, const char *sta_iface,
+                           const char *sta_ip, UplinkSaved *save,
+                           char *err, size_t errsize)
+{
+    char cmd[MAX_CMD_LEN], path[MAX_PATH_LEN];
+
+    if (!sta_ip[0]) {
+        snprintf(err, errsize, "%s has no IPv4 address to share", sta_iface);
+        return false;
+    }
+
+    snprintf(cmd, sizeof(cmd),
+             "ip link set %s up && ip addr flush dev %s && ip addr add %s/32 dev %s",
+             ap_iface, ap_iface, sta_ip, ap_iface);
+    if (net_exec_silent(cmd) != 0) {
+        snprintf(err, errsize, "cannot add %s/32 to %s", sta_ip, ap_iface);
+        return false;
+    }
+    snprintf(save->ap_addr, sizeof(save->ap_addr), "%s", sta_ip);
+
+    proxy_arp_path(path, sizeof(path), ap_iface);
+    write_int_file(path, 1);
+    proxy_arp_path(path, sizeof(path), sta_iface);
+    save->sta_proxy_arp = read_int_file(path);
+    write_int_file(path, 1);
+
+    /*
+     * Nothing is translated, so client flows need no conntrack entry in
+     * either direction. Traffic for the host's own address on the uplink
+     * keeps tracking (its stateful firewall rules need it).
+     */
+    snprintf(cmd, sizeof(cmd),
+             "iptables -t raw -A PREROUTING -i %s -j CT --notrack 2>/dev/null", ap_iface);
+    net_exec_silent(cmd);
+    snprintf(cmd, sizeof(cmd),
+             "iptables -t raw -A PREROUTING -i %s ! -d %s -j CT --notrack 2>/dev/null",
+             sta_iface, sta_ip);
+    net_exec_silent(cmd);
+
+    snprintf(cmd, sizeof(cmd), "iptables -A FORWARD -i %s -o %s -j ACCEPT",
+             ap_iface, sta_iface);
+    net_exec_silent(cmd);
+    snprintf(cmd, sizeof(cmd), "iptables -A FORWARD -i %s -o %s -j ACCEPT",
+             sta_iface, ap_iface);
+    net_exec_silent(cmd);
+
+    return true;
+}
+
+void uplink_dhcp_server(const UplinkConfig *cfg, const char *sta_iface,
+                        char *out, size_t outsize)
+{
+    out[0] = '\0';
+    if (cfg->dhcp_server[0]) {
+        snprintf(out, outsize, "%s", cfg->dhcp_server);
+        return;
+    }
+
+    char cmd[MAX_CMD_LEN], route[MAX_LINE_LEN] = {0}, gw[MAX_IP_LEN];
+    snprintf(cmd, sizeof(cmd), "ip -4 route show default dev %s 2>/dev/null",
+             sta_iface);
+    net_exec_cmd(cmd, route, sizeof(route));
+    char *via = strstr(route, "via ");
+    if (via && sscanf(via + 4, "%45s", gw) == 1) snprintf(out, outsize, "%s", gw);
+}
+
+static bool has_route(const UplinkSaved *save, const char *ip)
+{
+    for (int i = 0; i < save->route_count; i++)
+        if (strcmp(save->routes[i], ip) == 0) return true;
+    return false;
+}
+
+static void sync_routes(const char *ap_iface, UplinkSaved *save,
+                        const ConnectedClient *clients, int count)
+{
+    char cmd[MAX_CMD_LEN];
+
+    /* Drop routes for clients that are gone */
+    for (int i = 0; i < save->route_count; ) {
+        bool present = false;
+        for (int c = 0; c < count && !present; c++)
+            present = (strcmp(clients[c].ip, save->routes[i]) == 0);
+        if (present) {
+            i++;
+            continue;
+        }
+        snprintf(cmd, sizeof(cmd), "ip route del %s/32 dev %s 2>/dev/null",
+                 save->routes[i], ap_iface);
+        net_exec_silent(cmd);
+        memmove(save->routes[i], save->routes[i + 1],
+                sizeof(save->routes[0]) * (size_t)(save->route_count - i - 1));
+        save->route_count--;
+    }
+
+    for (int c = 0; c < count && save->route_count < MAX_CLIENTS; c++) {
+        if (has_route(save, clients[c].ip)) continue;
+        snprintf(cmd, sizeof(cmd), "ip route replace %s/32 dev %s 2>/dev/null",
+                 clients[c].ip, ap_iface);
+        net_exec_silent(cmd);
+        snprintf(save->routes[save->route_count++], MAX_IP_LEN, "%s", clients[c].ip);
+    }
+}
+
+/* ── Client Listing ──────────────────────────────────────────────────── */
+
+/* "IP lladdr MAC STATE" entries of a neighbour table with a usable MAC */
+static int read_neighbours(const char *iface, ConnectedClient *clients, int max)
+{
+    char cmd[MAX_CMD_LEN], out[8192] = {0};
+    snprintf(cmd, sizeof(cmd), "ip -4 neigh show dev %s 2>/dev/null", iface);
+    net_exec_cmd(cmd, out, sizeof(out));
+
+    int count = 0;
+    for (char *line = strtok(out, "\n"); line && count < max;
+         line = strtok(NULL, "\n")) {
+        char ip[MAX_IP_LEN], mac[MAX_MAC_LEN];
+        if (strstr(line, "FAILED") ||
+            sscanf(line, "%45s lladdr %17s", ip, mac) != 2) continue;
+
+        memset(&clients[count], 0, sizeof(ConnectedClient));
+        snprintf(clients[count].ip, MAX_IP_LEN, "%s", ip);
+        snprintf(clients[count].mac, MAX_MAC_LEN, "%s", mac);
+        snprintf(clients[count].hostname, MAX_SSID_LEN, "(unknown)");
+        count++;
+    }
+    return count;
+}
+
+int uplink_get_clients(const UplinkConfig *cfg, const char *ap_iface,
+                       UplinkSaved *save, ConnectedClient *clients,
+                       int max_clients)
+{
+    if (cfg->mode == UPLINK_PROXYARP) {
+        int count = read_neighbours(ap_iface, clients, max_clients);
+        sync_routes(ap_iface, save, clients, count);
+        return count;
+    }
+
+    if (cfg->mode != UPLINK_BRIDGE) return 0;
+
+    /* Associated stations, with IPs from the bridge's neighbour table */
+    ConnectedClient neigh[MAX_CLIENTS];
+    int n_neigh = read_neighbours(cfg->bridge, neigh, MAX_CLIENTS);
+
+    char cmd[MAX_CMD_LEN], out[8192] = {0};
+    snprintf(cmd, sizeof(cmd), "iw dev %s station dump 2>/dev/null", ap_iface);
+    net_exec_cmd(cmd, out, sizeof(out));
+
+    int count = 0;
+    for (char *p = out; (p = strstr(p, "Station ")) != NULL && count < max_clients;
+         p += 8) {
+        char mac[MAX_MAC_LEN];
+        if (sscanf(p + 8, "%17s", mac) != 1) continue;
+
+        ConnectedClient *c = &clients[count++];
+        memset(c, 0, sizeof(ConnectedClient));
+        snprintf(c->mac, MAX_MAC_LEN, "%s", mac);
+        snprintf(c->hostname, MAX_SSID_LEN, "(unknown)");
+        for (int i = 0; i < n_neigh; i++) {
+            if (strcasecmp(neigh[i].mac, mac) == 0) {
+                snprintf(c->ip, MAX_IP_LEN, "%s", neigh[i].ip);
+                break;
+            }
+        }
+    }
+    return count;
+}
+
+/* ── Teardown ────────────────────────────────────────────────────────── */
+
+void uplink_stop(const UplinkConfig *cfg, const char *ap_iface,
+                 const char *sta_iface, UplinkSaved *save)
+{
+    char cmd[MAX_CMD_LEN], path[MAX_PATH_LEN];
+
+    /* Proxy-ARP: routes, borrowed address, rules, sysctls */
+    for (int i = 0; i < save->route_count; i++) {
+        snprintf(cmd, sizeof(cmd), "ip route del %s/32 dev %s 2>/dev/null",
+                 save->routes[i], ap_iface);
+        net_exec_silent(cmd);
+    }
+    if (save->ap_addr[0]) {
+        snprintf(cmd, sizeof(cmd), "ip addr del %s/32 dev %s 2>/dev/null",
+                 save->ap_addr, ap_iface);
+        net_exec_silent(cmd);
+        snprintf(cmd, sizeof(cmd),
+                 "iptables -t raw -D PREROUTING -i %s -j CT --notrack 2>/dev/null",
+                 ap_iface);
+        net_exec_silent(cmd);
+        snprintf(cmd, sizeof(cmd),
+                 "iptables -t raw -D PREROUTING -i %s ! -d %s -j CT --notrack 2>/dev/null",
+                 sta_iface, save->ap_addr);
+        net_exec_silent(cmd);
+        snprintf(cmd, sizeof(cmd),
+                 "iptables -D FORWARD -i %s -o %s -j ACCEPT 2>/dev/null",
+                 ap_iface, sta_iface);
+        net_exec_silent(cmd);
+        snprintf(cmd, sizeof(cmd),
+                 "iptables -D FORWARD -i %s -o %s -j ACCEPT 2>/dev/null",
+                 sta_iface, ap_iface);
+        net_exec_silent(cmd);
+    }
+    if (save->sta_proxy_arp >= 0) {
+        proxy_arp_path(path, sizeof(path), sta_iface);
+        write_int_file(path, save->sta_proxy_arp);
+    }
+
+    /* Bridge: hand the port and its addresses back, drop our bridge */
+    if (save->created_bridge) {
+        snprintf(cmd, sizeof(cmd), "ip link set %s nomaster 2>/dev/null",
+                 cfg->bridge_port);
+        net_exec_silent(cmd);
+        for (int i = 0; i < save->moved_count; i++) {
+            snprintf(cmd, sizeof(cmd), "ip addr add %s dev %s 2>/dev/null",
+                     save->moved_addrs[i], cfg->bridge_port);
+            net_exec_silent(cmd);
+        }
+        if (save->moved_gateway[0]) {
+            snprintf(cmd, sizeof(cmd),
+                     "ip route replace default via %s dev %s 2>/dev/null",
+                     save->moved_gateway, cfg->bridge_port);
+            net_exec_silent(cmd);
+        }
+        snprintf(cmd, sizeof(cmd), "ip link del %s 2>/dev/null", cfg->bridge);
+        net_exec_silent(cmd);
+    }
+    if (save->bridge_nf_call > 0) write_int_file(BRIDGE_NF_PATH, save->bridge_nf_call);
+
+    memset(save, 0, sizeof(UplinkSaved));
+    save->bridge_nf_call = -1;
+    save->sta_proxy_arp  = -1;
+}
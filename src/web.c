@@ -0,0 +1,687 @@
+/*
+ * web.c - Local HTTP status dashboard for Linux Hotspot Enabler
+ *
+ * A single background thread owns every socket and multiplexes them
+ * with poll(); the main loop only hands over a serialized snapshot.
+ *
+ *   GET /         static dashboard page
+ *   GET /status   full JSON snapshot
+ *   GET /events   SSE stream: full snapshot first, then only the
+ *                 fields that changed since the previous push
+ *
+ * When nobody is connected web_publish() returns after two atomic
+ * loads, so the dashboard costs nothing until someone opens it.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <errno.h>
+#include <time.h>
+#include <poll.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+
+#include "web.h"
+#include "oui.h"
+
+#define WEB_REQ_MAX        2048
+#define WEB_MAX_CONNS      (WEB_MAX_VIEWERS_LIMIT + 8)
+#define WEB_READ_TIMEOUT   5       /* seconds to send a request line */
+#define WEB_KEEPALIVE_MS   15000
+
+/* ── Snapshot Fields ─────────────────────────────────────────────────── */
+
+typedef enum {
+    WF_STATE,
+    WF_ERROR,
+    WF_SSID,
+    WF_AP_IFACE,
+    WF_START_TIME,
+    WF_CLIENT_COUNT,
+    WF_CLIENTS,
+    WF_WIFI_IFACE,
+    WF_WIFI_CONNECTED,
+    WF_WIFI_SSID,
+    WF_WIFI_IP,
+    WF_WIFI_CHANNEL,
+    WF_WIFI_SIGNAL,
+    WF_COUNT
+} WebField;
+
+/* ── Connections ─────────────────────────────────────────────────────── */
+
+typedef enum {
+    CONN_FREE,
+    CONN_READING,      /* waiting for the request header */
+    CONN_WAITING,      /* waiting for the next published snapshot */
+    CONN_SSE           /* streaming /events */
+} ConnState;
+
+typedef struct {
+    int       fd;
+    ConnState state;
+    bool      want_sse;
+    time_t    since;
+    size_t    req_len;
+    char      req[WEB_REQ_MAX];
+} WebConn;
+
+static struct {
+    atomic_bool     running;
+    pthread_t       thread;
+    int             listen_fd;
+    int             wake[2];
+    int             max_viewers;
+    atomic_int      viewers;
+    atomic_int      demand;             /* a request is waiting for data */
+
+    pthread_mutex_t lock;
+    char           *pending[WF_COUNT];  /* guarded by lock */
+    bool            have_pending;
+
+    char           *sent[WF_COUNT];     /* server thread only */
+    WebConn         conns[WEB_MAX_CONNS];
+} g_web = {
+    .listen_fd = -1,
+    .wake      = { -1, -1 },
+    .lock      = PTHREAD_MUTEX_INITIALIZER,
+};
+
+/* ── Static Dashboard ────────────────────────────────────────────────── */
+
+static const char DASHBOARD_HTML[] =
+    "<!doctype html>\n"
+    "<html><head><meta charset=\"utf-8\">\n"
+    "<title>Hotspot Status</title>\n"
+    "<style>\n"
+    "body{font-family:monospace;background:#111;color:#ddd;margin:2em}\n"
+    "h1{color:#5cc}h2{color:#5cc;font-size:1em}\n"
+    "table{border-collapse:collapse;margin-bottom:1.5em}\n"
+    "td,th{padding:3px 14px 3px 0;text-align:left}\n"
+    "th{color:#888;font-weight:normal}\n"
+    ".ok{color:#6c6}.warn{color:#cc6}.err{color:#e66}\n"
+    "</style></head><body>\n"
+    "<h1>LINUX HOTSPOT ENABLER</h1>\n"
+    "<h2>Hotspot</h2><table id=\"hs\"></table>\n"
+    "<h2>WiFi Client</h2><table id=\"wifi\"></table>\n"
+    "<h2>Clients</h2><table id=\"cl\"></table>\n"
+    "<p id=\"conn\" class=\"warn\">connecting...</p>\n"
+    "<script>\n"
+    "var s={};\n"
+    "function e(v){return String(v==null?'':v).replace(/[&<>\"]/g,"
+        "function(c){return'&#'+c.charCodeAt(0)+';';});}\n"
+    "function row(k,v,c){return'<tr><th>'+k+'</th><td class=\"'+(c||'')+'\">'"
+        "+e(v)+'</td></tr>';}\n"
+    "function up(){if(!s.start_time)return'--';"
+        "var t=Math.max(0,Math.floor(Date.now()/1000)-s.start_time);"
+        "return Math.floor(t/3600)+'h '+Math.floor(t%3600/60)+'m '+t%60+'s';}\n"
+    "function draw(){\n"
+    " var sc=s.state=='running'?'ok':s.state=='error'?'err':'warn';\n"
+    " document.getElementById('hs').innerHTML=row('Status',s.state,sc)+"
+        "row('SSID',s.ssid)+row('Interface',s.ap_iface)+"
+        "row('Clients',s.client_count)+row('Uptime',up())+"
+        "(s.error?row('Error',s.error,'err'):'');\n"
+    " document.getElementById('wifi').innerHTML=row('Interface',s.wifi_iface)+"
+        "row('Status',s.wifi_connected?'Connected':'Disconnected',"
+        "s.wifi_connected?'ok':'err')+row('SSID',s.wifi_ssid)+"
+        "row('IP',s.wifi_ip)+row('Channel',s.wifi_channel)+"
+        "row('Signal',s.wifi_signal+' dBm');\n"
+    " var h='<tr><th>MAC Address</th><th>IP Address</th><th>Hostname</th>"
+        "<th>Vendor</th></tr>';\n"
+    " (s.clients||[]).forEach(function(c){h+='<tr><td>'+e(c.mac)+'</td><td>'"
+        "+e(c.ip)+'</td><td>'+e(c.hostname)+'</td><td>'+e(c.vendor)+'</td></tr>';});\n"
+    " document.getElementById('cl').innerHTML=h;\n"
+    "}\n"
+    "var es=new EventSource('/events');\n"
+    "es.onopen=function(){document.getElementById('conn').textContent='';};\n"
+    "es.onerror=function(){document.getElementById('conn').textContent="
+        "'disconnected, retrying...';};\n"
+    "es.onmessage=function(m){var d=JSON.parse(m.data);"
+        "for(var k in d)s[k]=d[k];draw();};\n"
+    "setInterval(draw,1000);\n"
+    "</script></body></html>\n";
+
+/* ── JSON Helpers ────────────────────────────────────────────────────── */
+
+static char *field_str(const char *key, const char *value)
+{
+    char esc[MAX_CMD_LEN * 2];
+    char *out = NULL;
+
+    net_json_escape(esc, sizeof(esc), value);
+    if (asprintf(&out, "\"%s\":\"%s\"", key, esc) < 0) return NULL;
+    return out;
+}
+
+static char *field_int(const char *key, long value)
+{
+    char *out = NULL;
+    if (asprintf(&out, "\"%s\":%ld", key, value) < 0) return NULL;
+    return out;
+}
+
+static char *field_bool(const char *key, bool value)
+{
+    char *out = NULL;
+    if (asprintf(&out, "\"%s\":%s", key, value ? "true" : "false") < 0)
+        return NULL;
+    return out;
+}
+
+static char *field_clients(const HotspotStatus *status)
+{
+    size_t cap = 64 + (size_t)MAX_CLIENTS * 4 * (MAX_SSID_LEN * 2 + 16);
+    char *out = malloc(cap);
+    if (!out) return NULL;
+
+    size_t o = snprintf(out, cap, "\"clients\":[");
+    for (int i = 0; i < status->client_count && i < MAX_CLIENTS; i++) {
+        const ConnectedClient *c = &status->clients[i];
+        char host[MAX_SSID_LEN * 2], vendor[MAX_SSID_LEN * 2];
+        net_json_escape(host, sizeof(host), c->hostname);
+        net_json_escape(vendor, sizeof(vendor), oui_vendor(c->mac));
+        o += snprintf(out + o, cap - o,
+                      "%s{\"mac\":\"%s\",\"ip\":\"%s\",\"hostname\":\"%s\","
+                      "\"vendor\":\"%s\",\"limited\":%s}",
+                      i > 0 ? "," : "", c->mac, c->ip, host, vendor,
+                      c->limited ? "true" : "false");
+    }
+    snprintf(out + o, cap - o, "]");
+    return out;
+}
+
+static const char *state_name(HotspotState state)
+{
+    switch (state) {
+        case HS_STATE_STOPPED:  return "stopped";
+        case HS_STATE_STARTING: return "starting";
+        case HS_STATE_RUNNING:  return "running";
+        case HS_STATE_ERROR:    return "error";
+        case HS_STATE_STOPPING: return "stopping";
+        default:                return "unknown";
+    }
+}
+
+static void build_fields(const HotspotStatus *st, char *f[WF_COUNT])
+{
+    f[WF_STATE]          = field_str("state", state_name(st->state));
+    f[WF_ERROR]          = field_str("error",
+                               st->state == HS_STATE_ERROR ? st->error_msg : "");
+    f[WF_SSID]           = field_str("ssid", st->config.ssid);
+    f[WF_AP_IFACE]       = field_str("ap_iface", st->ap_iface);
+    f[WF_START_TIME]     = field_int("start_time", (long)st->start_time);
+    f[WF_CLIENT_COUNT]   = field_int("client_count", st->client_count);
+    f[WF_CLIENTS]        = field_clients(st);
+    f[WF_WIFI_IFACE]     = field_str("wifi_iface", st->wifi.name);
+    f[WF_WIFI_CONNECTED] = field_bool("wifi_connected", st->wifi.connected);
+    f[WF_WIFI_SSID]      = field_str("wifi_ssid", st->wifi.ssid);
+    f[WF_WIFI_IP]        = field_str("wifi_ip", st->wifi.ip);
+    f[WF_WIFI_CHANNEL]   = field_int("wifi_channel", st->wifi.channel);
+    f[WF_WIFI_SIGNAL]    = field_int("wifi_signal", st->wifi.signal_dbm);
+}
+
+static void free_fields(char *f[WF_COUNT])
+{
+    for (int i = 0; i < WF_COUNT; i++) {
+        free(f[i]);
+        f[i] = NULL;
+    }
+}
+
+/*
+ * Join fields into a JSON object. With prev set, only fields whose
+ * text differs are included; returns NULL when nothing changed.
+ */
+static char *join_fields(char *const f[WF_COUNT], char *const prev[WF_COUNT])
+{
+    size_t cap = 3;
+    for (int i = 0; i < WF_COUNT; i++)
+        if (f[i]) cap += strlen(f[i]) + 1;
+
+    char *out = malloc(cap);
+    if (!out) return NULL;
+
+    size_t o = 0;
+    int n = 0;
+    out[o++] = '{';
+    for (int i = 0; i < WF_COUNT; i++) {
+        if (!f[i]) continue;
+        if (prev && prev[i] && strcmp(prev[i], f[i]) == 0) continue;
+        if (n++ > 0) out[o++] = ',';
+        size_t len = strlen(f[i]);
+        memcpy(out + o, f[i], len);
+        o += len;
+    }
+    out[o++] = '}';
+    out[o] = '\0';
+
+    if (prev && n == 0) {
+        free(out);
+        return NULL;
+    }
+    return out;
+}
+
+/* ── Connection Helpers ──────────────────────────────────────────────── */
+
+/*
+ * Non-blocking send of the whole buffer. A viewer that cannot take a
+ * small status update right now is too slow and gets dropped instead
+ * of stalling everyone else.
+ */
+static bool conn_send(WebConn *c, const char *buf, size_t len)
+{
+    while (len > 0) {
+        ssize_t n = send(c->fd, buf, len, MSG_NOSIGNAL);
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) return false;
+        buf += n;
+        len -= (size_t)n;
+    }
+    return true;
+}
+
+static void conn_close(WebConn *c)
+{
+    if (c->state == CONN_FREE) return;
+    if (c->want_sse) atomic_fetch_sub(&g_web.viewers, 1);
+    close(c->fd);
+    c->fd       = -1;
+    c->state    = CONN_FREE;
+    c->want_sse = false;
+    c->req_len  = 0;
+}
+
+static void send_response(WebConn *c, const char *status,
+                          const char *type, const char *body)
+{
+    char hdr[256];
+    size_t len = strlen(body);
+    int n = snprintf(hdr, sizeof(hdr),
+                     "HTTP/1.1 %s\r\n"
+                     "Content-Type: %s\r\n"
+                     "Content-Length: %zu\r\n"
+                     "Cache-Control: no-store\r\n"
+                     "Connection: close\r\n\r\n",
+                     status, type, len);
+    if (conn_send(c, hdr, (size_t)n))
+        conn_send(c, body, len);
+    conn_close(c);
+}
+
+static void send_sse_event(WebConn *c, const char *json)
+{
+    char *msg = NULL;
+    int n = asprintf(&msg, "data: %s\n\n", json);
+    if (n < 0) return;
+    if (!conn_send(c, msg, (size_t)n)) conn_close(c);
+    free(msg);
+}
+
+/* ── Request Handling ────────────────────────────────────────────────── */
+
+static void handle_request(WebConn *c)
+{
+    char method[8] = {0}, path[128] = {0};
+
+    if (sscanf(c->req, "%7s %127s", method, path) != 2) {
+        send_response(c, "400 Bad Request", "text/plain", "bad request\n");
+        return;
+    }
+    if (strcmp(method, "GET") != 0) {
+        send_response(c, "405 Method Not Allowed", "text/plain",
+                      "method not allowed\n");
+        return;
+    }
+
+    char *q = strchr(path, '?');
+    if (q) *q = '\0';
+
+    if (strcmp(path, "/") == 0 || strcmp(path, "/index.html") == 0) {
+        send_response(c, "200 OK", "text/html; charset=utf-8",
+                      DASHBOARD_HTML);
+    } else if (strcmp(path, "/status") == 0) {
+        c->state = CONN_WAITING;
+        atomic_store(&g_web.demand, 1);
+    } else if (strcmp(path, "/events") == 0) {
+        if (atomic_load(&g_web.viewers) >= g_web.max_viewers) {
+            send_response(c, "503 Service Unavailable", "text/plain",
+                          "too many viewers\n");
+            return;
+        }
+        static const char hdr[] =
+            "HTTP/1.1 200 OK\r\n"
+            "Content-Type: text/event-stream\r\n"
+            "Cache-Control: no-store\r\n"
+            "Connection: keep-alive\r\n\r\n"
+            "retry: 2000\n\n";
+        atomic_fetch_add(&g_web.viewers, 1);
+        c->want_sse = true;
+        if (!conn_send(c, hdr, sizeof(hdr) - 1)) {
+            conn_close(c);
+            return;
+        }
+        c->state = CONN_WAITING;
+        atomic_store(&g_web.demand, 1);
+    } else {
+        send_response(c, "404 Not Found", "text/plain", "not found\n");
+    }
+}
+
+static void conn_readable(WebConn *c)
+{
+    if (c->state != CONN_READING) {
+        /* Viewers never send anything after the request; EOF = gone */
+        char scratch[256];
+        ssize_t n = recv(c->fd, scratch, sizeof(scratch), 0);
+        if (n == 0 || (n < 0 && errno != EAGAIN && errno != EINTR))
+            conn_close(c);
+        return;
+    }
+
+    ssize_t n = recv(c->fd, c->req + c->req_len,
+                     sizeof(c->req) - 1 - c->req_len, 0);
+    if (n <= 0) {
+        if (n == 0 || (errno != EAGAIN && errno != EINTR)) conn_close(c);
+        return;
+    }
+    c->req_len += (size_t)n;
+    c->req[c->req_len] = '\0';
+
+    if (strstr(c->req, "\r\n\r\n") || strstr(c->req, "\n\n")) {
+        handle_request(c);
+    } else if (c->req_len >= sizeof(c->req) - 1) {
+        send_response(c, "431 Request Header Fields Too Large",
+                      "text/plain", "request too large\n");
+    }
+}
+
+static void accept_conn(void)
+{
+    int fd = accept4(g_web.listen_fd, NULL, NULL,
+                     SOCK_NONBLOCK | SOCK_CLOEXEC);
+    if (fd < 0) return;
+
+    for (int i = 0; i < WEB_MAX_CONNS; i++) {
+        WebConn *c = &g_web.conns[i];
+        if (c->state != CONN_FREE) continue;
+        c->fd      = fd;
+        c->state   = CONN_READING;
+        c->since   = time(NULL);
+        c->req_len = 0;
+        return;
+    }
+    close(fd);
+}
+
+/* ── Snapshot Delivery ───────────────────────────────────────────────── */
+
+static void deliver_snapshot(void)
+{
+    char *fresh[WF_COUNT] = {0};
+    bool have = false;
+
+    pthread_mutex_lock(&g_web.lock);
+    if (g_web.have_pending) {
+        memcpy(fresh, g_web.pending, sizeof(fresh));
+        memset(g_web.pending, 0, sizeof(g_web.pending));
+        g_web.have_pending = false;
+        have = true;
+    }
+    pthread_mutex_unlock(&g_web.lock);
+
+    if (!have) return;
+
+    char *full  = join_fields(fresh, NULL);
+    char *delta = join_fields(fresh, g_web.sent);
+
+    for (int i = 0; i < WEB_MAX_CONNS; i++) {
+        WebConn *c = &g_web.conns[i];
+        if (c->state == CONN_SSE) {
+            if (delta) send_sse_event(c, delta);
+        } else if (c->state == CONN_WAITING && full) {
+            if (c->want_sse) {
+                c->state = CONN_SSE;
+                send_sse_event(c, full);
+            } else {
+                send_response(c, "200 OK", "application/json", full);
+            }
+        }
+    }
+
+    free(full);
+    free(delta);
+    free_fields(g_web.sent);
+    memcpy(g_web.sent, fresh, sizeof(fresh));
+}
+
+static void expire_conns(bool keepalive)
+{
+    time_t now = time(NULL);
+
+    for (int i = 0; i < WEB_MAX_CONNS; i++) {
+        WebConn *c = &g_web.conns[i];
+        if (c->state == CONN_READING && now - c->since > WEB_READ_TIMEOUT) {
+            conn_close(c);
+        } else if (c->state == CONN_SSE && keepalive) {
+            if (!conn_send(c, ": keepalive\n\n", 13)) conn_close(c);
+        }
+    }
+}
+
+/* ── Server Thread ───────────────────────────────────────────────────── */
+
+static void *web_thread(void *arg)
+{
+    (void)arg;
+    struct pollfd pfds[2 + WEB_MAX_CONNS];
+    int conn_idx[2 + WEB_MAX_CONNS];
+    struct timespec last_ka;
+    clock_gettime(CLOCK_MONOTONIC, &last_ka);
+
+    while (g_web.running) {
+        int n = 0;
+        pfds[n].fd = g_web.wake[0];
+        pfds[n].events = POLLIN;
+        conn_idx[n++] = -1;
+        pfds[n].fd = g_web.listen_fd;
+        pfds[n].events = POLLIN;
+        conn_idx[n++] = -1;
+
+        bool has_reading = false;
+        for (int i = 0; i < WEB_MAX_CONNS; i++) {
+            if (g_web.conns[i].state == CONN_FREE) continue;
+            if (g_web.conns[i].state == CONN_READING) has_reading = true;
+            pfds[n].fd = g_web.conns[i].fd;
+            pfds[n].events = POLLIN;
+            conn_idx[n++] = i;
+        }
+
+        int timeout = has_reading ? 1000 : WEB_KEEPALIVE_MS;
+        int ready = poll(pfds, n, timeout);
+        if (ready < 0 && errno != EINTR) break;
+
+        if (ready > 0) {
+            if (pfds[0].revents & POLLIN) {
+                char drain[64];
+                while (read(g_web.wake[0], drain, sizeof(drain)) > 0) {}
+                deliver_snapshot();
+            }
+            if (pfds[1].revents & POLLIN) accept_conn();
+
+            for (int k = 2; k < n; k++) {
+                WebConn *c = &g_web.conns[conn_idx[k]];
+                if (c->state == CONN_FREE || c->fd != pfds[k].fd) continue;
+                if (pfds[k].revents & (POLLERR | POLLHUP | POLLNVAL))
+                    conn_close(c);
+                else if (pfds[k].revents & POLLIN)
+                    conn_readable(c);
+            }
+        }
+
+        struct timespec now;
+        clock_gettime(CLOCK_MONOTONIC, &now);
+        long since_ms = (now.tv_sec - last_ka.tv_sec) * 1000 +
+                        (now.tv_nsec - last_ka.tv_nsec) / 1000000;
+        bool keepalive = since_ms >= WEB_KEEPALIVE_MS;
+        if (keepalive) last_ka = now;
+        expire_conns(keepalive);
+    }
+
+    return NULL;
+}
+
+/* ── Public API ──────────────────────────────────────────────────────── */
+
+static bool parse_listen(const char *spec, struct sockaddr_in *sa,
+                         char *err, size_t errsize)
+{
+    char host[MAX_IP_LEN] = {0};
+    const char *colon = strrchr(spec, ':');
+    if (!colon || colon == spec || (size_t)(colon - spec) >= sizeof(host)) {
+        snprintf(err, errsize, "http_listen must be addr:port");
+        return false;
+    }
+    memcpy(host, spec, (size_t)(colon - spec));
+
+    int port = atoi(colon + 1);
+    if (port <= 0 || port > 65535) {
+        snprintf(err, errsize, "invalid http port '%s'", colon + 1);
+        return false;
+    }
+
+    if (strcmp(host, "localhost") == 0)
+        snprintf(host, sizeof(host), "127.0.0.1");
+
+    /* Never expose the dashboard on the uplink side */
+    if (strcmp(host, "127.0.0.1") != 0 && strcmp(host, AP_GATEWAY) != 0) {
+        snprintf(err, errsize,
+                 "http_listen address must be 127.0.0.1 or %s", AP_GATEWAY);
+        return false;
+    }
+
+    memset(sa, 0, sizeof(*sa));
+    sa->sin_family = AF_INET;
+    sa->sin_port   = htons((uint16_t)port);
+    inet_pton(AF_INET, host, &sa->sin_addr);
+    return true;
+}
+
+bool web_start(const char *listen_spec, int max_viewers,
+               char *err, size_t errsize)
+{
+    if (g_web.running) return true;
+
+    struct sockaddr_in sa;
+    if (!parse_listen(listen_spec, &sa, err, errsize)) return false;
+
+    int fd = socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (fd < 0) {
+        snprintf(err, errsize, "socket: %s", strerror(errno));
+        return false;
+    }
+
+    int one = 1;
+    setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+    /* The gateway address only exists while the hotspot runs */
+    setsockopt(fd, IPPROTO_IP, IP_FREEBIND, &one, sizeof(one));
+
+    if (bind(fd, (struct sockaddr *)&sa, sizeof(sa)) < 0 ||
+        listen(fd, 16) < 0) {
+        snprintf(err, errsize, "bind %s: %s", listen_spec, strerror(errno));
+        close(fd);
+        return false;
+    }
+
+    if (pipe2(g_web.wake, O_NONBLOCK | O_CLOEXEC) < 0) {
+        snprintf(err, errsize, "pipe: %s", strerror(errno));
+        close(fd);
+        return false;
+    }
+
+    g_web.listen_fd   = fd;
+    g_web.max_viewers = max_viewers > WEB_MAX_VIEWERS_LIMIT ?
+                        WEB_MAX_VIEWERS_LIMIT : max_viewers;
+    for (int i = 0; i < WEB_MAX_CONNS; i++) {
+        g_web.conns[i].fd    = -1;
+        g_web.conns[i].state = CONN_FREE;
+    }
+    atomic_store(&g_web.viewers, 0);
+    atomic_store(&g_web.demand, 0);
+
+    g_web.running = true;
+    if (pthread_create(&g_web.thread, NULL, web_thread, NULL) != 0) {
+        snprintf(err, errsize, "cannot start web thread");
+        g_web.running = false;
+        close(fd);
+        close(g_web.wake[0]);
+        close(g_web.wake[1]);
+        g_web.listen_fd = -1;
+        return false;
+    }
+
+    return true;
+}
+
+void web_publish(const HotspotStatus *status)
+{
+    if (!g_web.running) return;
+    if (atomic_load(&g_web.viewers) == 0 && !atomic_load(&g_web.demand))
+        return;
+
+    char *fields[WF_COUNT] = {0};
+    build_fields(status, fields);
+
+    pthread_mutex_lock(&g_web.lock);
+    free_fields(g_web.pending);
+    memcpy(g_web.pending, fields, sizeof(fields));
+    g_web.have_pending = true;
+    pthread_mutex_unlock(&g_web.lock);
+
+    atomic_store(&g_web.demand, 0);
+    if (write(g_web.wake[1], "x", 1) < 0) { /* pipe full: already woken */ }
+}
+
+char *web_status_json(const HotspotStatus *status)
+{
+    char *fields[WF_COUNT] = {0};
+    build_fields(status, fields);
+    char *json = join_fields(fields, NULL);
+    free_fields(fields);
+    return json;
+}
+
+int web_viewer_count(void)
+{
+    return atomic_load(&g_web.viewers);
+}
+
+void web_stop(void)
+{
+    if (!g_web.running) return;
+
+    g_web.running = false;
+    if (write(g_web.wake[1], "x", 1) < 0) { /* thread sees running=false */ }
+    pthread_join(g_web.thread, NULL);
+
+    for (int i = 0; i < WEB_MAX_CONNS; i++)
+        conn_close(&g_web.conns[i]);
+
+    close(g_web.listen_fd);
+    close(g_web.wake[0]);
+    close(g_web.wake[1]);
+    g_web.listen_fd = -1;
+    g_web.wake[0] = g_web.wake[1] = -1;
+
+    free_fields(g_web.sent);
+    pthread_mutex_lock(&g_web.lock);
+    free_fields(g_web.pending);
+    g_web.have_pending = false;
+    pthread_mutex_unlock(&g_web.lock);
+}
@@ -0,0 +1,113 @@
+# oui-gen.awk - Build the embedded OUI vendor table (POSIX awk)
+#
+# Two passes, with a sort in between (see the Makefile):
+#
+#   awk -f oui-gen.awk oui.txt | sort -t"<TAB>" -k1,1 -u \
+#     | awk -v emit=1 -v src=oui.txt -f oui-gen.awk > oui_table.c
+#
+# Pass 1 takes the "(hex)" lines of the IEEE MA-L list
+# (https://standards-oui.ieee.org/oui/oui.txt, also shipped as
+# /usr/share/ieee-data/oui.txt or /usr/share/hwdata/oui.txt):
+#
+#   00-1B-63   (hex)		Apple, Inc.
+#
+# and prints "001B63<TAB>Apple". Legal-form suffixes are dropped and
+# names capped at 32 bytes, so more entries share one interned string.
+#
+# Pass 2 reads the sorted list and prints C: the 24-bit prefixes in
+# order, a 16-bit name index per prefix, and each distinct name once.
+
+BEGIN {
+    n = 0
+    names = 0
+}
+
+!emit && /\(hex\)/ {
+    key = $1
+    gsub(/-/, "", key)
+    if (key !~ /^[0-9A-Fa-f][0-9A-Fa-f][0-9A-Fa-f][0-9A-Fa-f][0-9A-Fa-f][0-9A-Fa-f]$/)
+        next
+
+    name = $0
+    sub(/^.*\(hex\)[ \t]*/, "", name)
+    gsub(/\r/, "", name)
+    gsub(/\t/, " ", name)
+    sub(/[ ]+$/, "", name)
+
+    # "Samsung Electronics Co.,Ltd" -> "Samsung Electronics"
+    do {
+        old = name
+        sub(/[ ,]+(Inc|INC|Ltd|LTD|Limited|LIMITED|LLC|Llc|Corp|CORP|Corporation|CORPORATION|Co|CO|GmbH|GMBH|AG|SA|S\.A|BV|B\.V|AB|Oy|OY|Pty|PTY|PLC|Plc|KK|SAS|SpA|S\.p\.A|Srl|S\.r\.l)\.?$/, "", name)
+        sub(/[ ,.]+$/, "", name)
+    } while (name != old && name != "")
+    if (name == "") name = old
+
+    # Cut at 32 bytes without leaving half a UTF-8 sequence
+    if (length(name) > 32) {
+        name = substr(name, 1, 32)
+        sub(/[^ -~]+$/, "", name)
+        sub(/[ ,.]+$/, "", name)
+    }
+    if (name == "") next
+
+    print toupper(key) "\t" name
+    next
+}
+
+emit {
+    split($0, f, "\t")
+    if (f[1] == "" || f[2] == "") next
+
+    if (!(f[2] in index_of)) {
+        index_of[f[2]] = names
+        name_at[names++] = f[2]
+    }
+    prefix[n] = f[1]
+    idx[n++] = index_of[f[2]]
+}
+
+END {
+    if (!emit) exit 0
+    if (names > 65535) {
+        print "oui-gen.awk: " names " distinct names do not fit 16-bit indexes" > "/dev/stderr"
+        exit 1
+    }
+
+    print "/* Generated by tools/oui-gen.awk from " src " -- do not edit */"
+    print ""
+    print "#include \"oui.h\""
+    print ""
+    print "const uint32_t oui_entries = " n ";"
+    print ""
+
+    printf "const uint32_t oui_prefix[] = {"
+    for (i = 0; i < n; i++)
+        printf "%s0x%s,", (i % 8 ? " " : "\n    "), prefix[i]
+    print "\n    0\n};"
+    print ""
+
+    printf "const uint16_t oui_name_index[] = {"
+    for (i = 0; i < n; i++)
+        printf "%s%d,", (i % 12 ? " " : "\n    "), idx[i]
+    print "\n    0\n};"
+    print ""
+
+    printf "const uint32_t oui_name_offset[] = {"
+    off = 0
+    for (i = 0; i < names; i++) {
+        printf "%s%d,", (i % 10 ? " " : "\n    "), off
+        off += length(name_at[i]) + 1
+    }
+    print "\n    0\n};"
+    print ""
+
+    print "const char oui_names[] ="
+    for (i = 0; i < names; i++) {
+        s = name_at[i]
+        gsub(/\\/, "&&", s)
+        gsub(/"/, "\\\"", s)
+        gsub(/\?/, "\\?", s)
+        print "    \"" s "\\0\""
+    }
+    print "    \"\";"
+}